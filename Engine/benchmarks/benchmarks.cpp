@@ -0,0 +1,437 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdlib>
+
+//external
+#include "glm.hpp"
+#include "matrix_transform.hpp"
+#include "assimp/mesh.h"
+#include "assimp/scene.h"
+
+//engine
+#include "core.hpp"
+#include "stringUtils.hpp"
+#include "configFile.hpp"
+#include "selectobject.hpp"
+#include "gameobject.hpp"
+#include "importer.hpp"
+#include "gameObjectFile.hpp"
+
+using std::cout;
+using std::left;
+using std::right;
+using std::setw;
+using std::fixed;
+using std::setprecision;
+using std::ofstream;
+using std::string;
+using std::to_string;
+using std::vector;
+using std::shared_ptr;
+using std::make_shared;
+using std::unordered_map;
+using std::sort;
+using std::min;
+using std::max;
+using std::mt19937;
+using std::uniform_real_distribution;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+using std::nano;
+using std::filesystem::temp_directory_path;
+using std::filesystem::create_directories;
+using glm::vec3;
+using glm::vec2;
+using glm::mat4;
+using glm::lookAt;
+using glm::normalize;
+
+using Core::Engine;
+using Core::Select;
+using Utils::String;
+using EngineFile::ConfigFile;
+using EngineFile::GameObjectFile;
+using Graphics::Shape::GameObject;
+using Graphics::Shape::GameObjectManager;
+using Graphics::Shape::Transform;
+using Graphics::Shape::Mesh;
+using Graphics::Shape::MeshData;
+using Graphics::Shape::Material;
+using Graphics::Shape::BasicShape_Variables;
+using Graphics::Shape::AssimpVertex;
+using Graphics::Shape::AssimpMesh;
+using Graphics::Shape::Importer;
+
+//
+// Runs the engine hot paths against synthetic inputs without a window or gl context.
+// Usage: "Elypso benchmarks" [name filter] [--samples 21]
+//
+
+namespace Benchmarks
+{
+	//results are folded into this so the compiler cant remove the measured work
+	volatile size_t sink;
+
+	string filter;
+	int sampleCount = 21;
+	constexpr int warmupSamples = 3;
+	constexpr double minSampleNanoseconds = 2000000.0;
+
+	/// <summary>
+	/// Times the body in batches that last at least a couple milliseconds each
+	/// and prints the per call median, minimum and 90th percentile of all batches.
+	/// </summary>
+	template<typename Func>
+	void Run(const string& name, Func&& body)
+	{
+		if (!filter.empty()
+			&& name.find(filter) == string::npos)
+		{
+			return;
+		}
+
+		auto TimeBatch = [&body](size_t iterations)
+			{
+				auto start = steady_clock::now();
+				for (size_t i = 0; i < iterations; i++) body();
+				return duration<double, nano>(steady_clock::now() - start).count();
+			};
+
+		//grow the batch until a single batch is long enough to time reliably
+		size_t iterations = 1;
+		while (TimeBatch(iterations) < minSampleNanoseconds
+			&& iterations < (size_t(1) << 30))
+		{
+			iterations *= 2;
+		}
+
+		for (int i = 0; i < warmupSamples; i++) TimeBatch(iterations);
+
+		vector<double> samples;
+		samples.reserve(sampleCount);
+		for (int i = 0; i < sampleCount; i++)
+		{
+			samples.push_back(TimeBatch(iterations) / static_cast<double>(iterations));
+		}
+		sort(samples.begin(), samples.end());
+
+		double median = samples[samples.size() / 2];
+		double minimum = samples.front();
+		double p90 = samples[min(samples.size() - 1, static_cast<size_t>(samples.size() * 0.9))];
+		double spread = median > 0.0 ? (p90 - minimum) / median * 100.0 : 0.0;
+
+		cout << left << setw(48) << name
+			<< right << fixed << setprecision(1)
+			<< setw(14) << median
+			<< setw(14) << minimum
+			<< setw(14) << p90
+			<< setw(9) << spread << "%"
+			<< setw(12) << iterations
+			<< "\n";
+	}
+
+	vector<AssimpVertex> CreateVertices(size_t count, mt19937& random)
+	{
+		uniform_real_distribution<float> position(-1.0f, 1.0f);
+
+		vector<AssimpVertex> vertices(count);
+		for (auto& vertex : vertices)
+		{
+			vertex.pos = vec3(position(random), position(random), position(random));
+			vertex.normal = normalize(vertex.pos);
+		}
+		return vertices;
+	}
+
+	vector<shared_ptr<GameObject>> CreateObjects(size_t count, size_t verticesPerModel, mt19937& random)
+	{
+		uniform_real_distribution<float> position(-100.0f, 100.0f);
+		uniform_real_distribution<float> angle(0.0f, 360.0f);
+		vector<AssimpVertex> vertices = CreateVertices(verticesPerModel, random);
+		//zero gl names keep the shared data usable without a context
+		auto meshData = make_shared<MeshData>(0, 0, 0, vertices, vector<unsigned int>{});
+
+		vector<shared_ptr<GameObject>> objects;
+		objects.reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			//every fourth object is a light, the rest are models
+			Mesh::MeshType type = i % 4 == 3
+				? Mesh::MeshType::point_light
+				: Mesh::MeshType::model;
+
+			auto transform = make_shared<Transform>(
+				vec3(position(random), position(random) * 0.1f, position(random)),
+				vec3(0.0f, angle(random), 0.0f),
+				vec3(1.0f));
+			auto mesh = type == Mesh::MeshType::model
+				? make_shared<Mesh>(true, type, meshData)
+				: make_shared<Mesh>(true, type, 0, 0, 0);
+
+			objects.push_back(make_shared<GameObject>(
+				true,
+				"Object " + to_string(i),
+				static_cast<unsigned int>(i),
+				true,
+				transform,
+				mesh,
+				shared_ptr<Material>(),
+				make_shared<BasicShape_Variables>(32.0f)));
+		}
+		return objects;
+	}
+
+	void CreateAssimpMesh(aiMesh& mesh, unsigned int vertexCount, mt19937& random)
+	{
+		uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+		mesh.mNumVertices = vertexCount;
+		mesh.mVertices = new aiVector3D[vertexCount];
+		mesh.mNormals = new aiVector3D[vertexCount];
+		mesh.mTangents = new aiVector3D[vertexCount];
+		mesh.mBitangents = new aiVector3D[vertexCount];
+		mesh.mTextureCoords[0] = new aiVector3D[vertexCount];
+		mesh.mNumUVComponents[0] = 2;
+		for (unsigned int i = 0; i < vertexCount; i++)
+		{
+			mesh.mVertices[i] = aiVector3D(value(random), value(random), value(random));
+			mesh.mNormals[i] = aiVector3D(0.0f, 1.0f, 0.0f);
+			mesh.mTangents[i] = aiVector3D(1.0f, 0.0f, 0.0f);
+			mesh.mBitangents[i] = aiVector3D(0.0f, 0.0f, 1.0f);
+			mesh.mTextureCoords[0][i] = aiVector3D(value(random), value(random), 0.0f);
+		}
+
+		mesh.mNumFaces = vertexCount / 3;
+		mesh.mFaces = new aiFace[mesh.mNumFaces];
+		for (unsigned int i = 0; i < mesh.mNumFaces; i++)
+		{
+			mesh.mFaces[i].mNumIndices = 3;
+			mesh.mFaces[i].mIndices = new unsigned int[3] { i * 3, i * 3 + 1, i * 3 + 2 };
+		}
+	}
+
+	void WriteSyntheticFiles(const string& folder)
+	{
+		//config file with the real engine keys plus filler keys so lookups hit a realistically sized map
+		ofstream configFile(folder + "\\config.txt");
+		configFile << "gui_fontScale= 1.500000\n";
+		configFile << "window_vsync= 1\n";
+		configFile << "camera_fov= 90.000000\n";
+		configFile << "camera_nearClip= 0.001000\n";
+		configFile << "camera_farClip= 200.000000\n";
+		configFile << "camera_speedMultiplier= 1.000000\n";
+		configFile << "grid_color= 0.400000, 0.400000, 0.400000\n";
+		configFile << "grid_transparency= 0.250000\n";
+		configFile << "grid_maxDistance= 50.000000\n";
+		for (int i = 0; i < 64; i++)
+		{
+			configFile << "filler_key_" << i << "= " << i << ".000000\n";
+		}
+		configFile.close();
+
+		ofstream modelFile(folder + "/model.txt");
+		modelFile << "name= Model 0\n"
+			<< "id= 1\n"
+			<< "enabled= 1\n"
+			<< "mesh enabled= 1\n"
+			<< "type= model\n"
+			<< "position= 12.500000, 0.750000, -42.125000\n"
+			<< "rotation= 0.000000, 135.000000, 0.000000\n"
+			<< "scale= 1.250000, 1.250000, 1.250000\n"
+			<< "\n"
+			<< "textures= DEFAULTDIFF, DEFAULTSPEC, EMPTY, EMPTY\n"
+			<< "shaders= GameObject.vert, GameObject.frag\n"
+			<< "txtFile= C:\\Users\\user\\Documents\\Project\\scenes\\Scene1\\gameobjects\\Model 0\\Model 0.txt\n"
+			<< "shininess= 32.000000\n";
+		modelFile.close();
+
+		ofstream spotlightFile(folder + "/spotlight.txt");
+		spotlightFile << "name= Spotlight 0\n"
+			<< "id= 2\n"
+			<< "enabled= 1\n"
+			<< "mesh enabled= 1\n"
+			<< "type= spot_light\n"
+			<< "position= 1.000000, 5.000000, 1.000000\n"
+			<< "rotation= 0.000000, 45.000000, 0.000000\n"
+			<< "scale= 1.000000, 1.000000, 1.000000\n"
+			<< "\n"
+			<< "shaders= Basic_model.vert, Basic.frag\n"
+			<< "txtFile= C:\\Users\\user\\Documents\\Project\\scenes\\Scene1\\gameobjects\\Spotlight 0\\Spotlight 0.txt\n"
+			<< "diffuse= 1.000000, 0.800000, 0.600000\n"
+			<< "intensity= 1.000000\n"
+			<< "distance= 10.000000\n"
+			<< "inner angle= 15.000000\n"
+			<< "outer angle= 30.000000\n"
+			<< "\n"
+			<< "---attached billboard data---\n"
+			<< "\n"
+			<< "billboard name= Billboard\n"
+			<< "billboard id= 3\n"
+			<< "billboard enabled= 1\n"
+			<< "billboard shaders= Basic_texture.vert, Basic_texture.frag\n"
+			<< "billboard texture= spotLight.png\n"
+			<< "billboard shininess= 32.000000\n";
+		spotlightFile.close();
+	}
+}
+
+using namespace Benchmarks;
+
+int main(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		string argument = argv[i];
+		if (argument == "--samples" && i + 1 < argc) sampleCount = max(1, atoi(argv[++i]));
+		else filter = argument;
+	}
+
+	string folder = (temp_directory_path() / "elypso_benchmarks").string();
+	create_directories(folder);
+	WriteSyntheticFiles(folder);
+
+	Engine::docsPath = folder;
+	ConfigFile::LoadConfigFile();
+
+	//fixed seed so every run measures the exact same inputs
+	mt19937 random(12345);
+
+	cout << "\n" << left << setw(48) << "benchmark"
+		<< right << setw(14) << "median ns"
+		<< setw(14) << "min ns"
+		<< setw(14) << "p90 ns"
+		<< setw(10) << "spread"
+		<< setw(12) << "batch"
+		<< "\n" << string(112, '-') << "\n";
+
+	//
+	// STRING UTILS
+	//
+
+	string gameobjectLine = "position= 12.500000, 0.750000, -42.125000";
+	Run("String::Split key=value", [&]()
+		{
+			sink += String::Split(gameobjectLine, '=').size();
+		});
+	string vectorValue = "12.500000,0.750000,-42.125000";
+	Run("String::Split vec3", [&]()
+		{
+			sink += String::Split(vectorValue, ',').size();
+		});
+
+	//
+	// CONFIG FILE
+	//
+
+	vector<string> configKeys = { "camera_fov", "camera_nearClip", "camera_farClip", "grid_color", "window_vsync", "gui_fontScale" };
+	size_t configIndex = 0;
+	Run("ConfigFile::GetValue", [&]()
+		{
+			sink += ConfigFile::GetValue(configKeys[configIndex++ % configKeys.size()]).size();
+		});
+	Run("ConfigFile::GetFloat", [&]()
+		{
+			sink += static_cast<size_t>(ConfigFile::GetFloat(configKeys[configIndex++ % configKeys.size()]));
+		});
+
+	//
+	// PICKING
+	//
+
+	vector<AssimpVertex> boxVertices = CreateVertices(10000, random);
+	Run("Select::CalculateInteractionBox 10k verts", [&]()
+		{
+			vec3 minBound, maxBound;
+			Select::CalculateInteractionBoxFromVertices(boxVertices, minBound, maxBound, vec3(0.0f), vec3(1.0f));
+			sink += static_cast<size_t>(maxBound.x - minBound.x);
+		});
+
+	vector<Select::Ray> rays;
+	uniform_real_distribution<float> direction(-1.0f, 1.0f);
+	for (int i = 0; i < 16; i++)
+	{
+		rays.push_back(Select::Ray{ vec3(0.0f, 10.0f, 0.0f), normalize(vec3(direction(random), -0.2f, direction(random))) });
+	}
+	for (size_t objectCount : { size_t(1000), size_t(10000) })
+	{
+		vector<shared_ptr<GameObject>> objects = CreateObjects(objectCount, 24, random);
+		size_t rayIndex = 0;
+		Run("Select::CheckRayObjectIntersections " + to_string(objectCount / 1000) + "k", [&]()
+			{
+				sink += Select::CheckRayObjectIntersections(rays[rayIndex++ % rays.size()], objects);
+			});
+	}
+
+	//
+	// TRANSPARENT SORT
+	//
+
+	for (const auto& obj : CreateObjects(1000, 0, random))
+	{
+		GameObjectManager::AddTransparentObject(obj);
+	}
+	vector<mat4> views;
+	for (int i = 0; i < 16; i++)
+	{
+		float angle = glm::radians(static_cast<float>(i) * 22.5f);
+		views.push_back(lookAt(vec3(cos(angle) * 50.0f, 10.0f, sin(angle) * 50.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f)));
+	}
+	size_t viewIndex = 0;
+	Run("GameObjectManager::SortTransparentObjects 1k", [&]()
+		{
+			GameObjectManager::SortTransparentObjects(views[viewIndex++ % views.size()]);
+		});
+
+	//
+	// IMPORTER
+	//
+
+	for (unsigned int vertexCount : { 3000u, 60000u })
+	{
+		aiMesh mesh;
+		CreateAssimpMesh(mesh, vertexCount, random);
+		aiScene* scene = nullptr;
+		Run("Importer::ProcessMesh " + to_string(vertexCount) + " verts", [&]()
+			{
+				AssimpMesh processed = Importer::ProcessMesh(&mesh, scene);
+				sink += processed.indices.size();
+			});
+	}
+
+	//
+	// GAMEOBJECT FILES
+	//
+
+	string modelPath = folder + "/model.txt";
+	Run("GameObjectFile::ReadKeyValues model", [&]()
+		{
+			unordered_map<string, string> data;
+			GameObjectFile::ReadKeyValues(modelPath, data);
+			sink += data.size();
+		});
+	string spotlightPath = folder + "/spotlight.txt";
+	Run("GameObjectFile::ReadKeyValues spotlight", [&]()
+		{
+			unordered_map<string, string> data;
+			GameObjectFile::ReadKeyValues(spotlightPath, data);
+			sink += data.size();
+		});
+
+	cout << "\n";
+
+	return 0;
+}
@@ -0,0 +1,13 @@
+//Copyright (c) <2024> <Lost Empire Entertainment>
+
+#version 330 core
+
+uniform sampler2D atlas;
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = texture(atlas, TexCoords);
+}
@@ -0,0 +1,16 @@
+//Copyright (c) <2024> <Lost Empire Entertainment>
+
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec4 aColor;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec4 lineColor;
+
+void main()
+{
+	lineColor = aColor;
+	gl_Position = projection * view * vec4(aPos, 1.0);
+}
@@ -0,0 +1,18 @@
+//Copyright (c) <2024> <Lost Empire Entertainment>
+
+#version 330 core
+
+//depth only pass, paired with GameObject.vert so the depth matches the main pass exactly
+//ALPHA_TEST - cut out pixels are discarded with the same threshold as GameObject.frag
+
+#ifdef ALPHA_TEST
+uniform sampler2D diffuse;
+in vec2 TexCoords;
+#endif
+
+void main()
+{
+#ifdef ALPHA_TEST
+    if (texture(diffuse, TexCoords).a < 0.1) discard;
+#endif
+}
@@ -2,41 +2,72 @@
 
 #version 330 core
 
+uniform mat4 view;
+uniform mat4 projection;
 uniform float transparency;
 uniform vec3 color;
 uniform float fadeDistance;
 uniform float maxDistance;
 uniform vec3 center;
-in vec3 fragPos;
+in vec3 nearPoint;
+in vec3 farPoint;
 
 out vec4 FragColor;
 
+//size of the smallest grid cell in world units
+const float cellSize = 1.0;
+//a grid level fades out once its lines get closer than this on screen
+const float minPixelsBetweenLines = 8.0;
+
+//coverage of the nearest line of a grid level, anti-aliased over one pixel
+float GridLine(vec2 coord, float levelSize)
+{
+    vec2 scaled = coord / levelSize;
+    vec2 derivative = fwidth(scaled);
+    vec2 lines = abs(fract(scaled - 0.5) - 0.5) / derivative;
+    return 1.0 - min(min(lines.x, lines.y), 1.0);
+}
+
 void main()
 {
-    float distance = length(fragPos.xz - center.xz);
-    float height = abs(fragPos.y - center.y);
+    //intersect the view ray of this pixel with the y = 0 plane,
+    //a ray parallel to the plane never reaches it and is discarded below
+    float rayHeight = farPoint.y - nearPoint.y;
+    float t = abs(rayHeight) > 1e-6 ? -nearPoint.y / rayHeight : -1.0;
+    vec3 fragPos = nearPoint + t * (farPoint - nearPoint);
 
-    if (distance > maxDistance 
-        || height > 50.0)
-    {
-        discard;
-    }
+    //derivatives are taken before any discard, they are undefined in divergent control flow
+    //pick the grid level from how many world units one pixel covers,
+    //every level is ten times the previous one and the finer one fades out as it gets dense
+    vec2 unitsPerPixel = fwidth(fragPos.xz);
+    float lodLevel = max(0.0, log(length(unitsPerPixel) * minPixelsBetweenLines / cellSize) / log(10.0));
+    float lodFade = fract(lodLevel);
+    float fineSize = cellSize * pow(10.0, floor(lodLevel));
 
+    float line = max(
+        GridLine(fragPos.xz, fineSize) * (1.0 - lodFade),
+        GridLine(fragPos.xz, fineSize * 10.0));
+
+    float distance = length(fragPos.xz - center.xz);
     float fadeFactor = 1.0;
     if (distance > fadeDistance)
     {
-        fadeFactor = 1.0 - (distance - fadeDistance) 
+        fadeFactor = 1.0 - (distance - fadeDistance)
             / (maxDistance - fadeDistance);
         fadeFactor = clamp(fadeFactor, 0.0, 1.0);
     }
 
-    if (fadeFactor <= 0.0)
+    float finalAlpha = line * fadeFactor * transparency;
+    if (t <= 0.0
+        || distance > maxDistance
+        || finalAlpha <= 0.0)
     {
         discard;
     }
 
-    vec3 finalColor = color;
-    float finalAlpha = fadeFactor * transparency;
+    //write the depth of the plane so the scene geometry hides the grid correctly
+    vec4 clipPos = projection * view * vec4(fragPos, 1.0);
+    gl_FragDepth = (clipPos.z / clipPos.w) * 0.5 + 0.5;
 
-    FragColor = vec4(finalColor, finalAlpha);
+    FragColor = vec4(color, finalAlpha);
 }
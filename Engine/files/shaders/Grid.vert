@@ -1,14 +1,27 @@
 //Copyright (c) <2024> <Lost Empire Entertainment>
 
 #version 330 core
-layout (location = 0) in vec3 aPos;
 
 uniform mat4 view;
 uniform mat4 projection;
-out vec3 fragPos;
+
+out vec3 nearPoint;
+out vec3 farPoint;
+
+vec3 Unproject(vec2 ndc, float depth, mat4 inverseViewProjection)
+{
+	vec4 world = inverseViewProjection * vec4(ndc, depth, 1.0);
+	return world.xyz / world.w;
+}
 
 void main()
 {
-	fragPos = aPos;
-	gl_Position = projection * view * vec4(aPos, 1.0);
-}
\ No newline at end of file
+	//one triangle that covers the whole screen, no vertex buffer needed
+	vec2 ndc = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+
+	mat4 inverseViewProjection = inverse(projection * view);
+	nearPoint = Unproject(ndc, -1.0, inverseViewProjection);
+	farPoint = Unproject(ndc, 1.0, inverseViewProjection);
+
+	gl_Position = vec4(ndc, 0.0, 1.0);
+}
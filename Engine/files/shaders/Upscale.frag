@@ -0,0 +1,31 @@
+//Copyright (c) <2024> <Lost Empire Entertainment>
+
+#version 330 core
+
+uniform sampler2D sceneTexture;
+uniform vec2 texelSize;
+uniform float sharpness;
+//the scene is drawn into the bottom left part of a larger texture
+uniform vec2 uvScale;
+uniform vec2 uvMax;
+
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+void main()
+{
+    //bilinear sample plus an unsharp mask over the source texel neighbours,
+    //brings back some of the edge contrast lost by rendering at a lower resolution
+    vec2 uv = TexCoords * uvScale;
+    vec3 center = texture(sceneTexture, min(uv, uvMax)).rgb;
+    vec3 blur = (
+        texture(sceneTexture, min(uv + vec2(texelSize.x, 0.0), uvMax)).rgb
+        + texture(sceneTexture, max(uv - vec2(texelSize.x, 0.0), vec2(0.0))).rgb
+        + texture(sceneTexture, min(uv + vec2(0.0, texelSize.y), uvMax)).rgb
+        + texture(sceneTexture, max(uv - vec2(0.0, texelSize.y), vec2(0.0))).rgb) * 0.25;
+
+    vec3 sharpened = center + (center - blur) * sharpness;
+
+    FragColor = vec4(clamp(sharpened, 0.0, 1.0), 1.0);
+}
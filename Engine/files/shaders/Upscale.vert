@@ -0,0 +1,14 @@
+//Copyright (c) <2024> <Lost Empire Entertainment>
+
+#version 330 core
+
+out vec2 TexCoords;
+
+void main()
+{
+	//one triangle that covers the whole screen, no vertex buffer needed
+	vec2 ndc = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+
+	TexCoords = ndc * 0.5 + 0.5;
+	gl_Position = vec4(ndc, 0.0, 1.0);
+}
@@ -7,11 +7,15 @@
 #if ENGINE_MODE
 #include <vector>
 #include <string>
+#include <atomic>
+#include <mutex>
 
 namespace Core
 {
 	using std::vector;
 	using std::string;
+	using std::atomic;
+	using std::mutex;
 
 	class Compilation
 	{
@@ -48,7 +52,18 @@ namespace Core
 		static void Run();
 	private:
 		static inline bool finishedBuild;
+		//set while Run copies and cooks the scenes on its own thread
+		static inline atomic<bool> isPreparingRun;
 		static inline bool firstScrollToBottom;
+
+		//job object of the running cmake process tree, null while no build runs
+		static inline mutex installerMutex;
+		static inline void* installerJob;
+
+		/// <summary>
+		/// Ends the running cmake process tree, so RunInstaller stops reading and returns.
+		/// </summary>
+		static void StopInstaller();
 	};
 }
 #endif
\ No newline at end of file
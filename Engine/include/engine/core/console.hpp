@@ -7,11 +7,18 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
+
+//set to 0 to strip all DEBUG messages from the build
+#ifndef ENGINE_LOG_DEBUG
+#define ENGINE_LOG_DEBUG 1
+#endif
 
 namespace Core
 {
 	using std::string;
 	using std::vector;
+	using std::mutex;
 
 	class ConsoleManager
 	{
@@ -31,20 +38,40 @@ namespace Core
 			EXCEPTION
 		};
 
-		static inline bool sendDebugMessages;
+		/// <summary>
+		/// A message waiting to be printed to the in-game console by the main thread,
+		/// either because the engine isnt running yet or because it came from another thread.
+		/// </summary>
+		struct StoredLog
+		{
+			string message;
+			Caller caller;
+			Type type;
+		};
 
-		static inline vector<string> storedLogs;
+		static inline bool sendDebugMessages;
 
 		static string GetCurrentTimestamp();
 
-		static void AddConsoleLog(const string& message);
+		static void AddConsoleLog(const string& message, Caller caller, Type type);
 
 		static void AddLoggerLog(const string& message);
 
 		static void InitializeLogger();
 
+		/// <summary>
+		/// Moves all stored logs to the in-game console, only call this from the main thread.
+		/// </summary>
 		static void PrintLogsToBuffer();
 
+		/// <summary>
+		/// Blocks until every message queued so far has been written to the log file and stdout.
+		/// </summary>
+		static void FlushLogger();
+
+		/// <summary>
+		/// Flushes all remaining messages, stops the log writer thread and closes the log file.
+		/// </summary>
 		static void CloseLogger();
 
 		static void ParseConsoleCommand(const string& message);
@@ -59,9 +86,35 @@ namespace Core
 		/// <param name="message">The message itself.</param>
 		/// <param name="onlyMessage">Do we only send the message without message caller, type and timestamp?</param>
 		/// <param name="internalMessage">Do we also print this message to the in-game console?</param>
-		static void WriteConsoleMessage(Caller caller, Type type, const string& message, bool onlyMessage = false, bool internalMessage = true);
+		static void WriteConsoleMessage(Caller caller, Type type, const string& message, bool onlyMessage = false, bool internalMessage = true)
+		{
+			//compile-time filter, disabled debug messages never reach the formatter or the log writer
+			if constexpr (!logDebugMessages)
+			{
+				if (type == Type::DEBUG) return;
+			}
+			WriteMessage(caller, type, message, onlyMessage, internalMessage);
+		}
 
 	private:
+		static constexpr bool logDebugMessages = ENGINE_LOG_DEBUG != 0;
+
 		static inline bool wireframeMode;
+
+		static inline mutex storedLogsMutex;
+		static inline vector<StoredLog> storedLogs;
+
+		static void WriteMessage(Caller caller, Type type, const string& message, bool onlyMessage, bool internalMessage);
+
+		/// <summary>
+		/// Queues a message for the log writer thread, or writes it directly under the output lock
+		/// if the writer thread is not running. Safe to call from any thread, also during CloseLogger.
+		/// </summary>
+		static void QueueLoggerLog(string&& message);
+
+		/// <summary>
+		/// Background thread that batches queued messages into the log file and stdout.
+		/// </summary>
+		static void LogWriterLoop();
 	};
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+
+namespace Core
+{
+	using std::array;
+	using std::chrono::steady_clock;
+
+	class FramePacer
+	{
+	public:
+		/// <summary>
+		/// Signed frame time error buckets, each bucket is jitterBucketWidth milliseconds wide,
+		/// the first and last bucket collect everything outside of the histogram range.
+		/// </summary>
+		static constexpr int jitterBucketCount = 18;
+		static constexpr double jitterBucketWidth = 0.25;
+
+		static void Initialize();
+
+		/// <summary>
+		/// Sleeps until the next frame deadline, most of the wait is spent sleeping
+		/// and only the last fraction of a millisecond is spun out. Call right after swapping buffers.
+		/// </summary>
+		static void WaitForNextFrame();
+
+		/// <summary>
+		/// Forgets the current deadline after the loop has blocked waiting for events,
+		/// so the idle time is not counted as a late frame.
+		/// </summary>
+		static void ResetDeadline();
+
+		/// <summary>
+		/// Returns the frame rate the pacer currently aims for or 0 if vsync is pacing the loop.
+		/// window_targetFPS 0 follows the monitor refresh rate while vsync is off.
+		/// </summary>
+		static int GetTargetFPS();
+
+		static const array<float, jitterBucketCount>& GetJitterHistogram() { return jitterHistogram; }
+		static double GetWorstJitter() { return worstJitter; }
+		static void ResetJitterHistogram();
+	private:
+		static inline steady_clock::time_point nextFrameTime;
+		static inline steady_clock::time_point lastFrameTime;
+		static inline bool skipNextSample = true;
+
+		static inline int monitorRefreshRate = 60;
+
+		//how much earlier than the deadline the sleep ends, grows with the measured oversleep
+		static inline double sleepMargin = 0.001;
+
+		static inline array<float, jitterBucketCount> jitterHistogram{};
+		static inline double worstJitter;
+
+#ifdef _WIN32
+		static inline void* waitableTimer;
+#endif
+
+		/// <summary>
+		/// Sleeps for roughly the given amount of seconds using the most precise timer the os has.
+		/// </summary>
+		static void SleepFor(double seconds);
+
+		static void RecordJitter(double frameSeconds, double expectedSeconds);
+	};
+}
@@ -0,0 +1,81 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+//external
+#include "glm.hpp"
+
+namespace Core
+{
+	using std::string;
+	using std::vector;
+	using glm::vec3;
+
+	/// <summary>
+	/// Runs the engine without a visible window or GUI and benchmarks a scene.
+	/// Usage: --headless --scene <scene.txt> [--frames 600] [--warmup 30] [--output results.json]
+	/// [--width 1280] [--height 720] [--context native|osmesa|egl] [--camera-path path.txt]
+	/// [--camera-radius 10] [--camera-height 3]
+	/// </summary>
+	class Headless
+	{
+	public:
+		enum class ContextAPI
+		{
+			native,
+			osmesa,
+			egl
+		};
+
+		static inline bool isEnabled;
+		static inline string scenePath;
+		static inline string outputPath;
+		static inline string cameraPathFile;
+		static inline int frameCount = 600;
+		static inline int warmupFrames = 30;
+		static inline int width = 1280;
+		static inline int height = 720;
+		static inline float cameraRadius = 10.0f;
+		static inline float cameraHeight = 3.0f;
+		static inline ContextAPI contextAPI = ContextAPI::native;
+
+		static inline double sceneLoadMilliseconds;
+
+		/// <summary>
+		/// Reads the headless options from the command line, leaves everything disabled without --headless.
+		/// </summary>
+		static void ParseArguments(int argc, char* argv[]);
+
+		/// <summary>
+		/// Renders the loaded scene along the camera path for the requested amount of frames,
+		/// picks from the screen center every frame, writes the scene load time, frame timings
+		/// and picking timings to the output json file and shuts down the engine. Frames are
+		/// drawn into an offscreen target because the hidden window may own none of its pixels.
+		/// </summary>
+		static void RunBenchmark();
+	private:
+		struct CameraKey
+		{
+			vec3 position;
+			float yaw;
+			float pitch;
+		};
+
+		static inline vector<CameraKey> cameraPath;
+		//center pixel of the last frame, read back from the offscreen target
+		static inline unsigned char centerPixel[4];
+
+		static void LoadCameraPath();
+		static void UpdateCamera(int frame);
+		static void WriteResults(
+			const vector<double>& cpuTimes,
+			const vector<double>& gpuTimes,
+			const vector<double>& pickTimes);
+	};
+}
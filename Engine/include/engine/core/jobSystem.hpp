@@ -0,0 +1,183 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+
+namespace Core
+{
+	using std::vector;
+	using std::deque;
+	using std::unique_ptr;
+	using std::function;
+	using std::atomic;
+	using std::mutex;
+	using std::condition_variable;
+	using std::thread;
+	using std::shared_ptr;
+
+	/// <summary>
+	/// Counts unfinished jobs, every job started with a counter adds one and removes it when done.
+	/// </summary>
+	class JobCounter
+	{
+	public:
+		bool IsDone() const { return count.load(std::memory_order_acquire) == 0; }
+	private:
+		friend class JobSystem;
+		atomic<int> count{ 0 };
+	};
+
+	class JobSystem
+	{
+	public:
+		/// <summary>
+		/// Starts one worker per core, leaving one core for the main thread.
+		/// </summary>
+		/// <param name="workerCount">Amount of workers, 0 picks it from the core count</param>
+		static void Initialize(unsigned int workerCount = 0);
+
+		/// <summary>
+		/// Lets every queued job finish and joins all worker threads, main thread jobs that
+		/// were never picked up are dropped. Long jobs are cancelled and joined, so none of
+		/// them outlives the logger or the engine statics.
+		/// </summary>
+		static void Shutdown();
+
+		/// <summary>
+		/// Queues a job for any worker. Jobs started from a worker go to its own queue
+		/// and are taken from there first, idle workers steal the oldest jobs from busy ones.
+		/// </summary>
+		static void Run(function<void()> job, JobCounter* counter = nullptr);
+
+		/// <summary>
+		/// Starts a job that blocks for a long time, like waiting on an external build, on its own
+		/// thread outside the worker pool, so it never takes a worker and Wait can never steal it.
+		/// The job should check IsCancelled regularly and return without touching engine state once it is set.
+		/// </summary>
+		/// <param name="onCancel">Called by Shutdown before joining, unblocks a job that waits on something external</param>
+		static void RunLongJob(function<void()> job, function<void()> onCancel = nullptr);
+
+		/// <summary>
+		/// Set by Shutdown, long jobs stop at their next check.
+		/// </summary>
+		static bool IsCancelled() { return isCancelled.load(std::memory_order_acquire); }
+
+		/// <summary>
+		/// Queues a job that may only run on the main thread, use this for anything that touches GL or imgui.
+		/// </summary>
+		static void RunOnMainThread(function<void()> job, JobCounter* counter = nullptr);
+
+		/// <summary>
+		/// Runs all queued main thread jobs, called once per frame from the engine loop.
+		/// </summary>
+		static void ExecuteMainThreadJobs();
+
+		/// <summary>
+		/// Blocks until the counter reaches zero, the waiting thread runs other jobs meanwhile.
+		/// </summary>
+		static void Wait(const JobCounter& counter);
+
+		/// <summary>
+		/// Calls func(first, last) for chunks of [begin, end) across all workers and the calling thread,
+		/// returns once every chunk is done.
+		/// </summary>
+		/// <param name="grainSize">Smallest amount of indices handed to a single job</param>
+		template<typename Func>
+		static void ParallelFor(size_t begin, size_t end, size_t grainSize, Func&& func)
+		{
+			if (end <= begin) return;
+
+			size_t count = end - begin;
+			size_t chunkCount = (std::max)(static_cast<size_t>(1), (std::min)(
+				(count + grainSize - 1) / (std::max)(grainSize, static_cast<size_t>(1)),
+				static_cast<size_t>(GetWorkerCount() + 1) * 4));
+
+			if (chunkCount == 1)
+			{
+				func(begin, end);
+				return;
+			}
+
+			size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+			JobCounter counter;
+			for (size_t first = begin + chunkSize; first < end; first += chunkSize)
+			{
+				size_t last = (std::min)(first + chunkSize, end);
+				Run([&func, first, last]() { func(first, last); }, &counter);
+			}
+
+			//the caller takes the first chunk instead of idling
+			func(begin, (std::min)(begin + chunkSize, end));
+			Wait(counter);
+		}
+
+		static bool IsMainThread() { return std::this_thread::get_id() == mainThreadID; }
+		static unsigned int GetWorkerCount() { return static_cast<unsigned int>(workers.size()); }
+	private:
+		struct Job
+		{
+			function<void()> task;
+			JobCounter* counter;
+		};
+
+		/// <summary>
+		/// Owner pushes and pops at the back, thieves take from the front.
+		/// </summary>
+		struct WorkQueue
+		{
+			mutex queueMutex;
+			deque<Job> jobs;
+		};
+
+		static inline std::thread::id mainThreadID;
+		static inline vector<thread> workers;
+
+		//one queue per worker plus a shared one at the end for the main thread and outside threads
+		static inline vector<unique_ptr<WorkQueue>> queues;
+
+		static inline atomic<bool> isRunning;
+		static inline atomic<int> queuedJobs;
+		static inline mutex sleepMutex;
+		static inline condition_variable sleepCondition;
+
+		static inline mutex mainThreadMutex;
+		static inline vector<Job> mainThreadJobs;
+
+		struct LongJob
+		{
+			thread worker;
+			shared_ptr<atomic<bool>> isFinished;
+			function<void()> onCancel;
+		};
+		static inline mutex longJobMutex;
+		static inline vector<LongJob> longJobs;
+		static inline atomic<bool> isCancelled;
+
+		static void WorkerLoop(unsigned int index);
+
+		/// <summary>
+		/// Runs one job from the queue at index or steals one from another queue, returns false if all were empty.
+		/// </summary>
+		static bool TryRunJob(size_t index);
+
+		static void Execute(Job& job);
+
+		/// <summary>
+		/// Queue that jobs started from the calling thread go to.
+		/// </summary>
+		static size_t GetLocalQueueIndex();
+	};
+}
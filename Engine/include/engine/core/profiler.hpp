@@ -0,0 +1,133 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <array>
+#include <chrono>
+
+namespace Core
+{
+	using std::string;
+	using std::vector;
+	using std::deque;
+	using std::array;
+	using std::chrono::high_resolution_clock;
+
+	struct ProfileZoneData
+	{
+		const char* name;
+		int depth;
+
+		//milliseconds since the profiler epoch
+		double cpuStart;
+		double cpuEnd;
+
+		//milliseconds since the profiler epoch, aligned to the cpu start of the frame,
+		//negative if the zone has no gpu timing
+		double gpuStart = -1.0;
+		double gpuEnd = -1.0;
+
+		//indexes into the frame query pool, -1 if the zone has no gpu timing
+		int gpuStartQuery = -1;
+		int gpuEndQuery = -1;
+	};
+
+	struct ProfileFrame
+	{
+		unsigned long long index;
+		double cpuStart;
+		double cpuEnd;
+		double gpuTime;
+		vector<ProfileZoneData> zones;
+
+		//timestamp queries are reused every time this frame slot comes around again
+		vector<unsigned int> queryPool;
+		int usedQueries;
+	};
+
+	/// <summary>
+	/// Hierarchical frame profiler. Zones measure cpu time with high_resolution_clock
+	/// and optionally gpu time with timer queries that are read back frameLatency frames later,
+	/// so the cpu never stalls waiting for the gpu.
+	/// </summary>
+	class Profiler
+	{
+	public:
+		//zones are only recorded while this is enabled
+		static inline bool isEnabled;
+		static inline bool isPaused;
+
+		static constexpr int frameLatency = 4;
+		static constexpr size_t maxHistory = 300;
+
+		static void BeginFrame();
+		static void EndFrame();
+
+		static void BeginZone(const char* name, bool measureGPU);
+		static void EndZone();
+
+		/// <summary>
+		/// Finished frames with resolved gpu timings, oldest first.
+		/// </summary>
+		static const deque<ProfileFrame>& GetHistory() { return history; }
+
+		/// <summary>
+		/// Empties the history, frames that are still pending are dropped at the next BeginFrame
+		/// so the zones that are open right now still end normally.
+		/// </summary>
+		static void ClearHistory();
+
+		/// <summary>
+		/// Writes all frames in the history to a Chrome trace event json file
+		/// that can be opened in chrome://tracing or Perfetto.
+		/// </summary>
+		static bool ExportChromeTrace(const string& filePath);
+
+		static double GetTimeMilliseconds();
+	private:
+		static inline high_resolution_clock::time_point epoch = high_resolution_clock::now();
+
+		static inline array<ProfileFrame, frameLatency> pendingFrames;
+		static inline deque<ProfileFrame> history;
+		static inline unsigned long long frameIndex;
+		static inline bool isFrameActive;
+		static inline bool isClearRequested;
+
+		//zones started outside of a frame, such as scene loads during initialization
+		static inline ProfileFrame looseFrame;
+
+		static inline vector<int> openZones;
+
+		static ProfileFrame& CurrentFrame();
+		static int RecordGPUTimestamp(ProfileFrame& frame);
+		static void ResolveFrame(ProfileFrame& frame);
+	};
+
+	/// <summary>
+	/// Measures the lifetime of this object as a profiler zone.
+	/// </summary>
+	class ProfileZone
+	{
+	public:
+		ProfileZone(const char* name, bool measureGPU = false)
+		{
+			isActive = Profiler::isEnabled;
+			if (isActive) Profiler::BeginZone(name, measureGPU);
+		}
+		~ProfileZone()
+		{
+			if (isActive) Profiler::EndZone();
+		}
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+	private:
+		bool isActive;
+	};
+}
@@ -0,0 +1,68 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace Core
+{
+	using std::vector;
+	using std::function;
+
+	class Simulation
+	{
+	public:
+		/// <summary>
+		/// Length of a single simulation step in seconds.
+		/// </summary>
+		static inline double fixedDeltaTime = 1.0 / 60.0;
+		/// <summary>
+		/// Most steps a single frame may run, slower frames drop the remaining time
+		/// so that a long hitch slows the simulation down instead of snowballing.
+		/// </summary>
+		static inline int maxStepsPerFrame = 8;
+
+		/// <summary>
+		/// Registers a callback that runs once per fixed step with fixedDeltaTime.
+		/// </summary>
+		static void AddFixedUpdate(const function<void(double)>& callback);
+		/// <summary>
+		/// Registers a callback that runs once per rendered frame with the frame delta time.
+		/// </summary>
+		static void AddUpdate(const function<void(double)>& callback);
+
+		/// <summary>
+		/// Runs as many fixed steps as the accumulated frame time allows, then the per frame updates.
+		/// </summary>
+		static void Update(double deltaTime);
+
+		/// <summary>
+		/// True while fixed update callbacks are running, transforms changed outside of
+		/// a step snap to their new state instead of being interpolated towards it.
+		/// </summary>
+		static bool IsInFixedStep() { return isInFixedStep; }
+		/// <summary>
+		/// How far rendering is between the previous and the current step, from 0 to 1.
+		/// </summary>
+		static float GetInterpolationAlpha() { return interpolationAlpha; }
+		static uint64_t GetStepCount() { return stepCount; }
+	private:
+		static inline double accumulator;
+		static inline float interpolationAlpha = 1.0f;
+		static inline bool isInFixedStep;
+		static inline uint64_t stepCount;
+
+		static inline vector<function<void(double)>> fixedUpdates;
+		static inline vector<function<void(double)>> updates;
+
+		/// <summary>
+		/// Copies the current transform of every gameobject into its previous state.
+		/// </summary>
+		static void StorePreviousStates();
+	};
+}
@@ -20,6 +20,11 @@ namespace Core
 
 		static void InitializeDeltaTime();
 		static void UpdateDeltaTime();
+		/// <summary>
+		/// Restarts the frame clock so that time spent blocked waiting for events
+		/// does not end up in the next delta time.
+		/// </summary>
+		static void SkipIdleTime();
 	private:
 		static inline int frame_count;
 		static inline high_resolution_clock::time_point start_time;
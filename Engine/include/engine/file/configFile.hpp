@@ -7,11 +7,33 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+
+//external
+#include "glm.hpp"
 
 namespace EngineFile
 {
 	using std::string;
 	using std::vector;
+	using std::unordered_map;
+	using std::unordered_set;
+	using std::function;
+	using glm::vec3;
+
+	/// <summary>
+	/// A single config value, parsed once when it is loaded or set.
+	/// </summary>
+	struct ConfigValue
+	{
+		string stringValue;
+		float floatValue = 0.0f;
+		int intValue = 0;
+		bool boolValue = false;
+		vec3 vec3Value = vec3(0);
+	};
 
 	class ConfigFile
 	{
@@ -39,18 +61,58 @@ namespace EngineFile
 		/// <param name="key">The name of the key in the map we need to set a value for</param>
 		/// <param name="value">The value the key will be set to</param>
 		static void SetValue(const string& key, const string& value);
+
+		/// <summary>
+		/// Typed getters. The returned references stay valid for the lifetime of the engine
+		/// and always hold the latest value, so per-frame readers can keep them around.
+		/// </summary>
+		static const float& GetFloat(const string& key);
+		static const int& GetInt(const string& key);
+		static const bool& GetBool(const string& key);
+		static const vec3& GetVec3(const string& key);
+
+		/// <summary>
+		/// Registers a callback that is called every time SetValue changes this key.
+		/// </summary>
+		/// <param name="key">The name of the key to listen to</param>
+		/// <param name="callback">Called with the new parsed value</param>
+		static void AddChangeCallback(const string& key, const function<void(const ConfigValue&)>& callback);
 	private:
 		static inline string configFilePath;
 
 		/// <summary>
 		/// Temporary storage for all config settings until engine is saved.
+		/// Keys keeps the original order for saving, values holds the parsed data.
 		/// </summary>
 		static inline vector<string> keys;
-		static inline vector<string> values;
+		static inline unordered_map<string, ConfigValue> values;
+		static inline unordered_map<string, vector<function<void(const ConfigValue&)>>> callbacks;
+
+		/// <summary>
+		/// Keys that were read before they existed. They get an empty entry so the held references
+		/// fill in once the key is loaded, but they are not saved or settable until then.
+		/// </summary>
+		static inline unordered_set<string> placeholderKeys;
 
 		/// <summary>
 		/// Creates a brand new config file with default values.
 		/// </summary>
 		static void CreateNewConfigFile();
+
+		/// <summary>
+		/// Fills both vectors with every config key and its default value, in save order.
+		/// </summary>
+		static void GetDefaultValues(vector<string>& defaultKeys, vector<string>& defaultValues);
+
+		/// <summary>
+		/// Adds the key if it doesnt exist yet and parses the value into its typed fields.
+		/// Existing entries are updated in place so that held references remain valid.
+		/// </summary>
+		static ConfigValue& AssignValue(const string& key, const string& value);
+
+		/// <summary>
+		/// Finds a config value by key, a missing key gets an empty placeholder entry that is filled in when the key is loaded.
+		/// </summary>
+		static const ConfigValue& FindValue(const string& key);
 	};
-}
\ No newline at end of file
+}
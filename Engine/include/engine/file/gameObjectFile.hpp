@@ -6,10 +6,12 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 
 namespace EngineFile
 {
 	using std::string;
+	using std::unordered_map;
 
 	class GameObjectFile
 	{
@@ -25,6 +27,12 @@ namespace EngineFile
 		static void LoadGameObjects();
 
 		static void LoadModel(const string& file);
+
+		/// <summary>
+		/// Reads every 'key= value' line of a gameobject txt file into data,
+		/// with the extra spaces after '=' and ',' removed. Returns false if the file couldn't be opened.
+		/// </summary>
+		static bool ReadKeyValues(const string& file, unordered_map<string, string>& data);
 	private:
 		static string GetType(const string& file);
 
@@ -0,0 +1,104 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+#if ENGINE_MODE
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+namespace EngineFile
+{
+	using std::string;
+	using std::vector;
+	using std::unordered_map;
+	using std::atomic;
+	using std::thread;
+	using std::mutex;
+
+	struct DirectoryEntry
+	{
+		string name;
+		string fullPath;
+		string extension;
+		bool isDirectory = false;
+		vector<DirectoryEntry> children;
+	};
+
+	/// <summary>
+	/// In-memory copy of the project folder tree shared by the project panels.
+	/// A watcher thread reports the folders that changed (inotify on Linux, ReadDirectoryChangesW on Windows,
+	/// polling elsewhere) and only those are read again on the main thread, so the panels never touch the disk while rendering.
+	/// </summary>
+	class ProjectDirectory
+	{
+	public:
+		/// <summary>
+		/// Reads the whole tree under rootPath and starts the watcher thread.
+		/// </summary>
+		static void Initialize(const string& rootPath);
+
+		/// <summary>
+		/// Reads the folders the watcher reported again, or rebuilds the whole tree if the engine
+		/// or the polling fallback reported a change. Called once per frame.
+		/// </summary>
+		static void Update();
+
+		/// <summary>
+		/// Forces a rebuild on the next update, used when the engine itself changes files.
+		/// </summary>
+		static void MarkDirty();
+
+		/// <summary>
+		/// Stops the watcher thread.
+		/// </summary>
+		static void Shutdown();
+
+		static const DirectoryEntry& GetRoot() { return root; }
+
+		/// <summary>
+		/// Returns the cached entry for this path or nullptr if it doesn't exist.
+		/// </summary>
+		static const DirectoryEntry* FindEntry(const string& fullPath);
+	private:
+		static inline DirectoryEntry root;
+		static inline unordered_map<string, DirectoryEntry*> entriesByPath;
+
+		//set when the whole tree has to be read again
+		static inline atomic<bool> isDirty;
+		//folders whose own entries changed, filled by the watcher thread
+		static inline mutex changedMutex;
+		static inline vector<string> changedDirectories;
+		static inline atomic<bool> isWatching;
+		static inline thread watcherThread;
+
+		//how often the polling fallback checks the project folder for changes
+		static constexpr int pollIntervalMilliseconds = 1000;
+
+		static void Rebuild();
+		static void ReadDirectory(DirectoryEntry& directory);
+		static void AddToLookup(DirectoryEntry& entry);
+		static string NormalizePath(const string& fullPath);
+
+		/// <summary>
+		/// Reads the entries of one folder again, subfolders that still exist keep their cached contents.
+		/// </summary>
+		static void RefreshDirectory(DirectoryEntry& directory);
+
+		/// <summary>
+		/// Cached folder at this path, or its closest cached parent folder. Returns nullptr if the path is outside the tree.
+		/// </summary>
+		static DirectoryEntry* FindClosestDirectory(const string& fullPath);
+
+		static void AddChangedDirectory(const string& fullPath);
+
+		static void WatcherLoop();
+		static void PollingLoop();
+	};
+}
+#endif
@@ -0,0 +1,88 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <random>
+
+//external
+#include "glm.hpp"
+
+namespace EngineFile
+{
+	using std::string;
+	using std::mt19937;
+	using glm::vec3;
+
+	/// <summary>
+	/// Writes procedurally generated stress test scenes in the same folder layout
+	/// that SceneFile and GameObjectFile read back.
+	/// </summary>
+	class SceneGenerator
+	{
+	public:
+		enum class Distribution
+		{
+			uniform,
+			grid,
+			cluster
+		};
+
+		struct Settings
+		{
+			string sceneFolder;
+			string modelPath;
+			int modelCount = 1000;
+			int pointLightCount = 0;
+			int spotLightCount = 0;
+			int billboardCount = 0;
+			Distribution distribution = Distribution::uniform;
+			unsigned int seed = 1;
+			float extent = 100.0f;
+		};
+
+		/// <summary>
+		/// Reads the generator options from the command line. Returns true if --generate-scene was passed.
+		/// Usage: --generate-scene <scene folder> [--models 1000] [--point-lights 0] [--spot-lights 0]
+		/// [--billboards 0] [--distribution uniform|grid|cluster] [--seed 1] [--extent 100] [--model cube.fbx]
+		/// </summary>
+		static bool ParseArguments(int argc, char* argv[], Settings& settings);
+
+		/// <summary>
+		/// Writes scene.txt and one gameobject folder per object into the scene folder.
+		/// The same settings and seed always produce the same scene.
+		/// </summary>
+		static bool Generate(const Settings& settings);
+	private:
+		static vec3 NextPosition(
+			const Settings& settings,
+			mt19937& random,
+			int index,
+			int total);
+
+		static bool WriteModel(
+			const string& gameobjectsFolder,
+			const string& modelPath,
+			const string& name,
+			unsigned int id,
+			const vec3& pos,
+			const vec3& rot,
+			const vec3& scale);
+
+		static bool WriteLight(
+			const string& gameobjectsFolder,
+			const string& name,
+			unsigned int id,
+			bool isSpotlight,
+			bool isEnabled,
+			bool isMeshEnabled,
+			const vec3& pos,
+			const vec3& rot,
+			const vec3& diffuse,
+			float intensity,
+			float distance);
+	};
+}
@@ -0,0 +1,86 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+
+//engine
+#include "gameobject.hpp"
+
+namespace EngineFile
+{
+	using std::string;
+	using std::vector;
+	using std::unordered_set;
+
+	using Graphics::Shape::AssimpVertex;
+	using Graphics::Shape::MeshRange;
+
+	/// <summary>
+	/// Static models of a scene merged into a few large meshes by the game build. Models that share
+	/// a material and a spatial cell end up in one batch with their vertices already transformed,
+	/// every model keeps its own index range so it can still be culled on its own.
+	/// </summary>
+	class StaticBatchFile
+	{
+	public:
+		static inline const string fileName = "staticBatches.bin";
+
+#if ENGINE_MODE
+		/// <summary>
+		/// Writes a batch file next to every scene.txt below folder. Meant for the copied scenes
+		/// of the game build, cpu only so it can run on a worker.
+		/// </summary>
+		static void CookScenes(const string& folder);
+#endif
+		/// <summary>
+		/// Reads the batch file of sceneFolder and returns the gameobject folders of the merged models,
+		/// those must not be loaded on their own. A missing or damaged file returns an empty set.
+		/// </summary>
+		static unordered_set<string> LoadBatches(const string& sceneFolder);
+
+		/// <summary>
+		/// Creates one model per batch read by LoadBatches, called after the regular gameobjects
+		/// were loaded so the batches never take the ID of a saved gameobject.
+		/// </summary>
+		static void CreateBatchModels();
+	private:
+		//'ELSB', bumping the version makes older games ignore the file and load every model
+		static constexpr uint32_t batchFileMagic = 0x42534C45;
+		static constexpr uint32_t batchFileVersion = 1;
+
+		//models are grouped by the cell their bounding box center falls into
+		static constexpr float cellSize = 32.0f;
+		//a full batch starts a new one, so a single draw never gets too large
+		static constexpr size_t maxBatchVertices = 1 << 20;
+
+		struct StaticBatch
+		{
+			//diffuse, specular, normal and height, relative to the scene folder
+			//or one of the DEFAULTDIFF, DEFAULTSPEC and EMPTY placeholders
+			string textures[4];
+			string vertShader;
+			string fragShader;
+			float shininess{};
+
+			vector<AssimpVertex> vertices;
+			vector<unsigned int> indices;
+			vector<MeshRange> ranges;
+			//gameobject folder of the model behind each range
+			vector<string> members;
+		};
+
+		static inline vector<StaticBatch> loadedBatches;
+		static inline string loadedSceneFolder;
+
+#if ENGINE_MODE
+		static void CookScene(const string& sceneFolder);
+#endif
+	};
+}
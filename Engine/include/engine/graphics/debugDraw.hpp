@@ -0,0 +1,105 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+
+//external
+#include "glm.hpp"
+
+//engine
+#include "shader.hpp"
+
+namespace Graphics
+{
+	using std::vector;
+	using glm::vec3;
+	using glm::vec4;
+	using glm::mat4;
+
+	using Graphics::Shader;
+
+	/// <summary>
+	/// Immediate mode line drawing for gizmos and debug shapes. Every Draw call only appends
+	/// vertices to a cpu list, Flush uploads everything at once and draws the depth tested lines
+	/// and the overlay lines with one draw call each. Main thread only.
+	/// </summary>
+	class DebugDraw
+	{
+	public:
+		/// <param name="depthTest">False draws the line on top of the whole scene</param>
+		static void DrawLine(const vec3& from, const vec3& to, const vec4& color, bool depthTest = true);
+
+		/// <summary>
+		/// Draws pairs of points as lines after transforming them with the model matrix.
+		/// </summary>
+		static void DrawLines(const vec3* points, size_t count, const mat4& model, const vec4& color, bool depthTest = true);
+
+		/// <summary>
+		/// Draws the edges of a unit cube centered at the origin, transformed by the model matrix.
+		/// </summary>
+		static void DrawBox(const mat4& model, const vec4& color, bool depthTest = true);
+		static void DrawBox(const vec3& minBound, const vec3& maxBound, const vec4& color, bool depthTest = true);
+
+		/// <summary>
+		/// Draws a unit sized four sided pyramid pointing up, transformed by the model matrix.
+		/// </summary>
+		static void DrawPyramid(const mat4& model, const vec4& color, bool depthTest = true);
+
+		/// <summary>
+		/// Draws three circles around the center, one on each axis plane.
+		/// </summary>
+		static void DrawSphere(
+			const vec3& center,
+			float radius,
+			const vec4& color,
+			bool depthTest = true,
+			int segments = 24);
+
+		/// <summary>
+		/// Draws a cone from the apex along the direction, angle is the half angle in degrees.
+		/// </summary>
+		static void DrawCone(
+			const vec3& apex,
+			const vec3& direction,
+			float length,
+			float angle,
+			const vec4& color,
+			bool depthTest = true,
+			int segments = 16);
+
+		/// <summary>
+		/// Draws the edges of the volume that the view projection matrix maps to clip space.
+		/// </summary>
+		static void DrawFrustum(const mat4& viewProjection, const vec4& color, bool depthTest = true);
+
+		/// <summary>
+		/// Draws and clears everything submitted since the last flush.
+		/// </summary>
+		static void Flush(const mat4& view, const mat4& projection);
+
+		/// <summary>
+		/// True if lines were submitted that have not been drawn yet.
+		/// </summary>
+		static bool HasPendingLines() { return !depthTestedLines.empty() || !overlayLines.empty(); }
+	private:
+		struct LineVertex
+		{
+			vec3 position;
+			vec4 color;
+		};
+
+		static inline vector<LineVertex> depthTestedLines;
+		static inline vector<LineVertex> overlayLines;
+
+		static inline unsigned int VAO;
+		static inline unsigned int VBO;
+		static inline size_t bufferCapacity;
+		static inline Shader shader;
+
+		static void Initialize();
+	};
+}
@@ -0,0 +1,85 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+//engine
+#include "shader.hpp"
+#include "renderTargetPool.hpp"
+
+namespace Graphics
+{
+	using Graphics::Shader;
+
+	/// <summary>
+	/// Renders the scene at a fraction of the output size and upscales it afterwards.
+	/// graphics_renderScale sets the fraction, with graphics_dynamicResolution enabled the fraction
+	/// follows the measured gpu time of the scene against graphics_gpuBudget and the render scale
+	/// becomes its upper limit.
+	/// </summary>
+	class DynamicResolution
+	{
+	public:
+		/// <summary>
+		/// Size of the image the scene ends up in, the scene window panel or the game window.
+		/// </summary>
+		static void SetOutputSize(int width, int height);
+
+		/// <summary>
+		/// Binds the framebuffer the scene should be drawn into and sets the viewport for it.
+		/// At full scale that is the output framebuffer itself.
+		/// </summary>
+		static void BeginScene(unsigned int outputFramebuffer);
+
+		/// <summary>
+		/// Upscales the scene into the output framebuffer if it was drawn at a lower resolution,
+		/// the output framebuffer and its viewport are bound afterwards.
+		/// </summary>
+		static void EndScene(unsigned int outputFramebuffer);
+
+		static float GetScale() { return currentScale; }
+		static int GetRenderWidth() { return renderWidth; }
+		static int GetRenderHeight() { return renderHeight; }
+
+		/// <summary>
+		/// Smoothed gpu time of the scene in milliseconds, 0 until the first measurement arrives.
+		/// </summary>
+		static float GetGPUTime() { return smoothedGPUTime; }
+	private:
+		static constexpr float minScale = 0.25f;
+		static constexpr float minDynamicScale = 0.5f;
+		static constexpr float scaleStep = 0.05f;
+		//frames between automatic scale changes, gives the smoothed gpu time time to settle
+		static constexpr int scaleChangeInterval = 15;
+
+		static inline int outputWidth = 1280;
+		static inline int outputHeight = 720;
+		static inline int renderWidth = 1280;
+		static inline int renderHeight = 720;
+
+		static inline float currentScale = 1.0f;
+		static inline float dynamicScale = 1.0f;
+		static inline float smoothedGPUTime;
+		static inline int framesSinceScaleChange;
+		static inline bool isUpscaling;
+
+		//low resolution scene target, taken from the render target pool
+		static inline RenderTarget* sceneTarget;
+
+		//timer queries are read a few frames later so reading them never stalls the cpu
+		static constexpr int queryCount = 4;
+		static inline unsigned int timerQueries[queryCount];
+		static inline bool isQueryPending[queryCount];
+		static inline int queryIndex;
+		static inline bool isQueryActive;
+
+		static inline Shader upscaleShader;
+		static inline unsigned int upscaleVAO;
+
+		static void ReadGPUTimes();
+		static void UpdateDynamicScale(float maxScale);
+		static void Upscale(unsigned int outputFramebuffer);
+	};
+}
@@ -18,19 +18,19 @@ namespace Graphics
 
 	using Graphics::Shader;
 
+	/// <summary>
+	/// Infinite ground grid on the y = 0 plane. A single fullscreen triangle is drawn and the
+	/// fragment shader finds the lines analytically, so the cost does not depend on the grid extent.
+	/// </summary>
 	class Grid
 	{
 	public:
 		static void InitializeGrid();
 		static void RenderGrid(const mat4& view, const mat4& projection);
 	private:
-		static inline GLuint VAO, VBO;
+		//core profile refuses to draw without a bound VAO even if no attributes are read
+		static inline GLuint VAO;
 		static inline Shader shader;
-
-		static inline float fadeDistance;
-		static constexpr int lineCount = 10000; //BREAKS IF YOU PUT IT ABOVE 100000
-		static inline float lineDistance = 1.0f;
-		static inline float vertices[lineCount * 4 * 3];
 	};
 }
-#endif
\ No newline at end of file
+#endif
@@ -5,13 +5,21 @@
 
 #pragma once
 #include <vector>
+#include <deque>
 #include <string>
 
+//engine
+#include "console.hpp"
+
 namespace Graphics::GUI
 {
 	using std::vector;
+	using std::deque;
 	using std::string;
 
+	using Caller = Core::ConsoleManager::Caller;
+	using Type = Core::ConsoleManager::Type;
+
 	class GUIConsole
 	{
 	public:
@@ -21,12 +29,51 @@ namespace Graphics::GUI
 #endif
 		static inline bool firstScrollToBottom;
 
-		static inline vector<string> consoleMessages;
-
 		static void RenderConsole();
-		static void AddTextToConsole(const string& message);
+		static void AddTextToConsole(const string& message, Caller caller, Type type);
+		static void ClearConsole();
 	private:
+		struct ConsoleMessage
+		{
+			string text;
+			Caller caller;
+			Type type;
+			//wrapped height of this message, valid for cachedWrapWidth and cachedFontSize
+			float height;
+		};
+
 		static inline char inputTextBuffer[128];
-		static constexpr int maxConsoleMessages = 1000;
+		static constexpr size_t maxConsoleMessages = 10000;
+
+		/// <summary>
+		/// Fixed capacity ring of all console messages, message with sequence number s
+		/// lives in slot s % maxConsoleMessages. Sequences in [firstSequence, nextSequence) are valid.
+		/// </summary>
+		static inline vector<ConsoleMessage> messageRing;
+		static inline size_t firstSequence;
+		static inline size_t nextSequence;
+
+		/// <summary>
+		/// Sequences of messages that pass the current filter, with the
+		/// accumulated height before each of them, used to only lay out visible lines.
+		/// </summary>
+		static inline deque<size_t> visibleSequences;
+		static inline deque<float> visibleOffsets;
+		static inline float visibleEnd;
+
+		//-1 means show all
+		static inline int callerFilter = -1;
+		static inline int typeFilter = -1;
+
+		static inline float cachedWrapWidth;
+		static inline float cachedFontSize;
+
+		static bool PassesFilter(const ConsoleMessage& message);
+		static float CalculateMessageHeight(const string& text);
+
+		/// <summary>
+		/// Rebuilds the filtered view and cached heights after the filter, wrap width or font size changed.
+		/// </summary>
+		static void RebuildVisibleMessages();
 	};
-}
\ No newline at end of file
+}
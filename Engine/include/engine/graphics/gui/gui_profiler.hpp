@@ -0,0 +1,31 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+#if ENGINE_MODE
+
+//engine
+#include "profiler.hpp"
+
+namespace Graphics::GUI
+{
+	using Core::ProfileFrame;
+
+	class GUIProfiler
+	{
+	public:
+		static inline bool renderProfiler;
+
+		static void RenderProfiler();
+	private:
+		//index into the profiler history, -1 follows the newest frame
+		static inline int selectedFrame = -1;
+
+		static void RenderFrameGraph();
+		static void RenderTimeline(const ProfileFrame& frame);
+		static void RenderZoneTable(const ProfileFrame& frame);
+	};
+}
+#endif
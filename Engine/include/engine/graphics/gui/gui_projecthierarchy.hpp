@@ -8,17 +8,22 @@
 #include <string>
 #include <vector>
 
+//engine
+#include "projectDirectory.hpp"
+
 namespace Graphics::GUI
 {
 	using std::string;
 	using std::vector;
 
+	using EngineFile::DirectoryEntry;
+
 	class GUIProjectHierarchy
 	{
 	public:
 		static void RenderProjectHierarchy();
 	private:
-		static void DisplayDirectoryContents(const string& directoryPath);
+		static void DisplayDirectoryContents(const DirectoryEntry& directory);
 	};
 }
 #endif
\ No newline at end of file
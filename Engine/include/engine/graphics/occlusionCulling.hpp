@@ -0,0 +1,126 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+//external
+#include "glm.hpp"
+
+//engine
+#include "gameobject.hpp"
+
+namespace Graphics
+{
+	using std::vector;
+	using std::shared_ptr;
+	using glm::vec3;
+	using glm::vec4;
+	using glm::mat4;
+
+	using Graphics::Shape::GameObject;
+	using Graphics::Shape::Mesh;
+
+	/// <summary>
+	/// Cpu occlusion culling for the opaque models. A few large occluders, picked by size or by the
+	/// occluder flag of their mesh, are rasterized into a small depth buffer on a worker thread while
+	/// the main thread projects the bounding boxes of all models. The boxes are then tested against
+	/// a max depth pyramid (hierarchical z) of that buffer before any draw is issued.
+	/// </summary>
+	class OcclusionCulling
+	{
+	public:
+		/// <summary>
+		/// Rasterizes the occluders of this frame and tests every object of the list,
+		/// results stay valid until the next call. Main thread only.
+		/// </summary>
+		static void Update(
+			const vector<shared_ptr<GameObject>>& objects,
+			const mat4& view,
+			const mat4& projection);
+
+		/// <summary>
+		/// Result for the object at the same index of the list given to Update,
+		/// anything that is not a model is always visible.
+		/// </summary>
+		static bool IsVisible(size_t index)
+		{
+			return index >= visibility.size() || visibility[index] != 0;
+		}
+
+		/// <summary>
+		/// Drops the results of the last update, used while occlusion culling is disabled
+		/// so IsBoxVisible falls back to a frustum test.
+		/// </summary>
+		static void Clear();
+
+		/// <summary>
+		/// Tests a single bounding box against the depth of this frame, used for the ranges
+		/// of static batches. Without occluders only the view frustum is tested.
+		/// </summary>
+		static bool IsBoxVisible(const vec3& minBound, const vec3& maxBound, const mat4& modelViewProjection)
+		{
+			return TestBounds(ProjectBounds(minBound, maxBound, modelViewProjection));
+		}
+
+		static int GetOccluderCount() { return occluderCount; }
+		static int GetTestedCount() { return testedCount; }
+		static int GetCulledCount() { return culledCount; }
+	private:
+		static constexpr int bufferWidth = 256;
+		static constexpr int bufferHeight = 128;
+
+		//automatic occluders need a bounding box diagonal of at least this many world units
+		static constexpr float minOccluderSize = 4.0f;
+		//dense meshes cost more to rasterize than they save, only flagged meshes skip this limit
+		static constexpr size_t maxOccluderTriangles = 4096;
+		static constexpr size_t maxOccluders = 32;
+
+		struct Occluder
+		{
+			shared_ptr<Mesh> mesh;
+			mat4 modelViewProjection;
+			float screenSize;
+		};
+
+		/// <summary>
+		/// Screen rectangle and nearest depth of a projected bounding box.
+		/// </summary>
+		struct ScreenBounds
+		{
+			int minX, minY, maxX, maxY;
+			float minDepth;
+			bool isAlwaysVisible;
+			bool isOutsideView;
+		};
+
+		static inline vector<Occluder> occluders;
+		static inline vector<ScreenBounds> screenBounds;
+		static inline vector<uint8_t> visibility;
+
+		//level 0 is the rasterized depth, every next level keeps the farthest depth of 2x2 texels
+		static inline vector<vector<float>> depthPyramid;
+		static inline vector<vec4> clipVertices;
+
+		static inline int occluderCount;
+		static inline int testedCount;
+		static inline int culledCount;
+
+		static void CollectOccluders(const vector<shared_ptr<GameObject>>& objects, const mat4& viewProjection);
+		static ScreenBounds ProjectBounds(const vec3& minBound, const vec3& maxBound, const mat4& modelViewProjection);
+
+		/// <summary>
+		/// Runs on a worker, clears the depth buffer, draws every occluder and builds the pyramid.
+		/// </summary>
+		static void RasterizeOccluders();
+		static void RasterizeTriangle(const vec4& v0, const vec4& v1, const vec4& v2);
+		static void BuildDepthPyramid();
+
+		static bool TestBounds(const ScreenBounds& bounds);
+	};
+}
@@ -20,6 +20,8 @@ namespace Graphics
 
 	using Graphics::Camera;
 
+	struct RenderTarget;
+
 	class Render
 	{
 	public:
@@ -30,13 +32,21 @@ namespace Graphics
 
 		static Camera camera;
 
-		static inline unsigned int textureColorbuffer;
-		static inline unsigned int rbo;
+		/// <summary>
+		/// Pooled target the scene window image is drawn into, only its bottom left
+		/// sub rectangle of usedWidth x usedHeight holds the scene.
+		/// </summary>
+		static inline RenderTarget* sceneTarget;
 
 		static void RenderSetup();
 		static void UpdateAfterRescale(GLFWwindow* window, int width, int height);
 		static void SetWindowNameAsUnsaved(bool state);
 		static void WindowLoop();
+
+		/// <summary>
+		/// Draws the skybox, grid and all gameobjects into the currently bound framebuffer.
+		/// </summary>
+		static void RenderScene();
 	private:
 		static void GLFWSetup();
 		static void WindowSetup();
@@ -44,8 +54,19 @@ namespace Graphics
 		static void ContentSetup();
 		static void SkyboxSetup();
 
+		/// <summary>
+		/// Polls events while there is something to draw, otherwise sleeps until the next event,
+		/// unfocused windows are throttled to window_unfocusedFPS.
+		/// </summary>
+		static void WaitForEvents();
+
 #if ENGINE_MODE
 		static void FramebufferSetup();
+
+		/// <summary>
+		/// Returns true if the scene framebuffer needs to be drawn again this frame.
+		/// </summary>
+		static bool IsSceneDamaged();
 #endif
 	};
 }
\ No newline at end of file
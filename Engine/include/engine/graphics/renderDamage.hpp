@@ -0,0 +1,84 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <atomic>
+
+//external
+#include "glfw3.h"
+
+namespace Graphics
+{
+	using std::atomic;
+
+	/// <summary>
+	/// Tracks whether anything visible changed since the scene was last drawn,
+	/// so the editor can skip redrawing an unchanged scene and sleep between events.
+	/// Camera and viewport changes are detected by the window loop itself,
+	/// everything else that changes the scene marks it here.
+	/// </summary>
+	class RenderDamage
+	{
+	public:
+		/// <summary>
+		/// How many frames the gui keeps drawing after a change so imgui hover states and popups can settle.
+		/// </summary>
+		static constexpr int guiSettleFrames = 3;
+
+		/// <summary>
+		/// The scene needs to be drawn again.
+		/// </summary>
+		static void MarkScene()
+		{
+			isSceneDamaged = true;
+			guiFrames = guiSettleFrames;
+		}
+
+		/// <summary>
+		/// Only the gui needs to be drawn again.
+		/// </summary>
+		static void MarkGUI()
+		{
+			guiFrames = guiSettleFrames;
+		}
+
+		/// <summary>
+		/// Marks the gui from another thread and wakes the main thread if it is waiting for events.
+		/// </summary>
+		static void WakeMainThread()
+		{
+			guiFrames = guiSettleFrames;
+			if (isWaiting) glfwPostEmptyEvent();
+		}
+
+		/// <summary>
+		/// Returns whether the scene was damaged and clears the flag.
+		/// </summary>
+		static bool ConsumeScene()
+		{
+			return isSceneDamaged.exchange(false);
+		}
+
+		static bool HasPendingWork()
+		{
+			return isSceneDamaged
+				|| guiFrames > 0;
+		}
+
+		/// <summary>
+		/// Counts down the gui settle frames, called once at the end of every drawn frame.
+		/// </summary>
+		static void EndFrame()
+		{
+			if (guiFrames > 0) guiFrames--;
+		}
+
+		static inline atomic<bool> isWaiting;
+	private:
+		static inline atomic<bool> isSceneDamaged = true;
+		static inline atomic<int> guiFrames = guiSettleFrames;
+	};
+}
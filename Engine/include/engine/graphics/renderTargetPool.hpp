@@ -0,0 +1,92 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <vector>
+#include <memory>
+
+//external
+#include "glad.h"
+#include "glm.hpp"
+
+namespace Graphics
+{
+	using std::vector;
+	using std::unique_ptr;
+	using glm::vec2;
+
+	/// <summary>
+	/// A framebuffer with a color texture and an optional depth stencil renderbuffer.
+	/// The allocated size is rounded up to the pool bucket size, users draw into the
+	/// bottom left sub rectangle of usedWidth x usedHeight.
+	/// </summary>
+	struct RenderTarget
+	{
+		unsigned int framebuffer{};
+		unsigned int colorTexture{};
+		unsigned int depthRenderbuffer{};
+
+		int width{};
+		int height{};
+		int usedWidth{};
+		int usedHeight{};
+
+		GLenum colorFormat{};
+		bool hasDepth{};
+
+		bool isInUse{};
+		double lastUsedTime{};
+		//last time the target was requested at a size that falls in its own bucket
+		double lastFitTime{};
+
+		/// <summary>
+		/// Texture coordinate of the top right corner of the used sub rectangle.
+		/// </summary>
+		vec2 GetUVScale() const
+		{
+			return vec2(
+				static_cast<float>(usedWidth) / static_cast<float>(width),
+				static_cast<float>(usedHeight) / static_cast<float>(height));
+		}
+	};
+
+	/// <summary>
+	/// Reuses render targets by (size bucket, format) so that resizing a view does not
+	/// reallocate gpu memory on every pixel of change. Larger targets keep serving smaller
+	/// sizes until they have been oversized for shrinkTimeout seconds.
+	/// </summary>
+	class RenderTargetPool
+	{
+	public:
+		/// <summary>
+		/// Makes sure the target can hold width x height and updates its used size, a target that is
+		/// too small or has been oversized for too long is swapped for one from the pool.
+		/// Returns true if the target changed and its contents are undefined.
+		/// </summary>
+		static bool Fit(RenderTarget*& target, int width, int height, GLenum colorFormat, bool hasDepth);
+
+		/// <summary>
+		/// Hands out a free target of at least width x height.
+		/// </summary>
+		static RenderTarget* Acquire(int width, int height, GLenum colorFormat, bool hasDepth);
+		static void Release(RenderTarget* target);
+
+		/// <summary>
+		/// Deletes free targets that were not used for shrinkTimeout seconds, called once per frame.
+		/// </summary>
+		static void CollectUnused();
+	private:
+		static constexpr int sizeBucket = 256;
+		static constexpr double shrinkTimeout = 3.0;
+
+		static inline vector<unique_ptr<RenderTarget>> targets;
+
+		static int GetBucketSize(int size);
+		static bool IsExactBucket(const RenderTarget& target, int width, int height);
+		static void Allocate(RenderTarget& target);
+		static void Delete(RenderTarget& target);
+	};
+}
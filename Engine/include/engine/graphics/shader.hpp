@@ -6,7 +6,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <unordered_map>
+#include <cstdint>
 
 //external
 #include "glm.hpp"
@@ -16,6 +18,7 @@ namespace Graphics
 {
 	using std::string;
 	using std::unordered_map;
+	using std::vector;
 	using glm::vec2;
 	using glm::vec3;
 	using glm::vec4;
@@ -28,7 +31,33 @@ namespace Graphics
 	public:
 		unsigned int ID{};
 
-		static Shader LoadShader(const string& vertexPath = "", const string& fragmentPath = "");
+		/// <summary>
+		/// Feature bits of a shader permutation, the point and spot light counts
+		/// are packed into the lowest bits of the same mask by MakePermutationMask.
+		/// </summary>
+		enum Feature : uint32_t
+		{
+			feature_dirLight = 1u << 10,
+			feature_specularMap = 1u << 11,
+			feature_alphaTest = 1u << 12
+		};
+		static constexpr int maxPermutationLights = 16;
+
+		/// <summary>
+		/// Loads, compiles and links a shader pair.
+		/// </summary>
+		/// <param name="defines">Lines injected as #define right after the #version line of both stages</param>
+		static Shader LoadShader(
+			const string& vertexPath = "",
+			const string& fragmentPath = "",
+			const vector<string>& defines = {});
+
+		/// <summary>
+		/// Returns the variant of a shader pair compiled for the given permutation mask,
+		/// each variant is compiled once and then looked up by mask.
+		/// </summary>
+		static Shader LoadPermutation(const string& vertexPath, const string& fragmentPath, uint32_t mask);
+		static uint32_t MakePermutationMask(int pointLightCount, int spotLightCount, uint32_t features);
 
 		void Use() const;
 
@@ -50,7 +79,29 @@ namespace Graphics
 		void SetMat4(const string& name, const mat4& mat) const;
 	private:
 		static unordered_map<string, unsigned int> shaders;
+		static inline unordered_map<string, unordered_map<uint32_t, unsigned int>> permutations;
+
+		static vector<string> GetPermutationDefines(uint32_t mask);
+		static string InjectDefines(const string& code, const vector<string>& defines);
 
 		bool CheckCompileErrors(GLuint shader, const string& type);
+
+		/// <summary>
+		/// Compiles and links a program from glsl source, returns 0 on failure.
+		/// </summary>
+		static unsigned int CompileProgram(Shader& shader, const string& vertexCode, const string& fragmentCode);
+
+		/// <summary>
+		/// Program binaries are stored in the documents folder, one file per source pair.
+		/// The file name hashes both sources together with the driver vendor, renderer and version,
+		/// so a driver update simply misses the old binaries.
+		/// </summary>
+		static bool IsProgramBinarySupported();
+		static string GetProgramBinaryPath(const string& vertexCode, const string& fragmentCode);
+		/// <summary>
+		/// Creates a program from a cached binary, returns 0 if there is none or the driver rejects it.
+		/// </summary>
+		static unsigned int LoadProgramBinary(const string& binaryPath);
+		static void SaveProgramBinary(unsigned int program, const string& binaryPath);
 	};
 }
\ No newline at end of file
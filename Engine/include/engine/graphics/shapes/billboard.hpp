@@ -7,6 +7,8 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <unordered_map>
 
 //external
 #include "glm.hpp"
@@ -16,9 +18,12 @@ namespace Graphics::Shape
 	class GameObject;
 
 	using glm::vec3;
+	using glm::vec4;
 	using glm::mat4;
 	using std::string;
 	using std::shared_ptr;
+	using std::vector;
+	using std::unordered_map;
 
 	class Billboard
 	{
@@ -38,6 +43,57 @@ namespace Graphics::Shape
 			unsigned int& id = tempID,
 			const bool& isEnabled = true);
 
-		static void RenderBillboard(const shared_ptr<GameObject>& obj, const mat4& view, const mat4& projection);
+		/// <summary>
+		/// Draws all enabled billboards of the list in one instanced call, in list order, other mesh types are skipped.
+		/// Each billboard only adds its center, scale and atlas rect to a streaming buffer,
+		/// the quad itself is built facing the camera in the vertex shader.
+		/// </summary>
+		static void RenderBillboards(const vector<shared_ptr<GameObject>>& billboards, const mat4& view, const mat4& projection);
+
+		/// <summary>
+		/// Forgets the atlas cell of a deleted texture and frees the cell, so a recycled texture id
+		/// is copied into the atlas again instead of showing the old texture.
+		/// </summary>
+		static void ReleaseAtlasRect(unsigned int texture);
+	private:
+		/// <summary>
+		/// Per billboard data, laid out exactly as the instanced vertex attributes.
+		/// </summary>
+		struct BillboardInstance
+		{
+			vec3 center;
+			vec3 scale;
+			vec4 atlasRect;
+		};
+
+		//every distinct billboard texture gets one cell of the atlas
+		static constexpr int atlasSize = 1024;
+		static constexpr int atlasCellSize = 128;
+		//transparent border inside every cell, mip levels stop where one texel spans the whole border
+		static constexpr int atlasCellPadding = 8;
+		static constexpr int atlasMaxMipLevel = 3;
+		static constexpr int atlasContentSize = atlasCellSize - 2 * atlasCellPadding;
+
+		static inline unsigned int atlasTexture;
+		static inline int atlasUsedCells;
+		static inline unordered_map<unsigned int, vec4> atlasRects;
+		//cell index of every texture that owns a cell, textures on the fallback rect own none
+		static inline unordered_map<unsigned int, int> atlasCells;
+		static inline vector<int> freeAtlasCells;
+		//rect of the first cell, handed out once the atlas is full
+		static inline vec4 fallbackRect;
+
+		static inline unsigned int instanceVAO;
+		static inline unsigned int instanceVBO;
+		static inline size_t instanceCapacity;
+		static inline vector<BillboardInstance> instances;
+
+		static void InitializeBatch();
+
+		/// <summary>
+		/// Returns the atlas rect (offset and size in uv space) of a texture,
+		/// copying it into the next free cell from the smallest mip level that fits on first use.
+		/// </summary>
+		static const vec4& GetAtlasRect(unsigned int texture);
 	};
 }
\ No newline at end of file
@@ -14,9 +14,13 @@
 //external
 #include "glad.h"
 #include "magic_enum.hpp"
+#include "quaternion.hpp"
+#include "matrix_transform.hpp"
 
 //engine
 #include "shader.hpp"
+#include "renderDamage.hpp"
+#include "simulation.hpp"
 
 namespace Graphics::Shape
 {
@@ -27,9 +31,11 @@ namespace Graphics::Shape
 	using std::cout;
 	using glm::vec3;
 	using glm::mat4;
+	using glm::quat;
 	using std::string;
 
 	using Graphics::Shader;
+	using Core::Simulation;
 
 	class Transform
 	{
@@ -40,21 +46,35 @@ namespace Graphics::Shape
 			const vec3& scale) :
 			position(position),
 			rotation(rotation),
-			scale(scale)
+			scale(scale),
+			previousPosition(position),
+			previousRotation(rotation),
+			previousScale(scale)
 		{
 		}
 
+		//changes made outside of a fixed step are moves by the editor or game setup,
+		//those snap into place instead of being interpolated from the old state
 		void SetPosition(const vec3& newPosition)
 		{
+			if (position == newPosition) return;
 			position = newPosition;
+			if (!Simulation::IsInFixedStep()) previousPosition = newPosition;
+			RenderDamage::MarkScene();
 		}
 		void SetRotation(const vec3& newRotation)
 		{
+			if (rotation == newRotation) return;
 			rotation = newRotation;
+			if (!Simulation::IsInFixedStep()) previousRotation = newRotation;
+			RenderDamage::MarkScene();
 		}
 		void SetScale(const vec3& newScale)
 		{
+			if (scale == newScale) return;
 			scale = newScale;
+			if (!Simulation::IsInFixedStep()) previousScale = newScale;
+			RenderDamage::MarkScene();
 		}
 
 		const vec3& GetPosition() const
@@ -69,10 +89,53 @@ namespace Graphics::Shape
 		{
 			return scale;
 		}
+
+		/// <summary>
+		/// Remembers the current state as the state of the previous simulation step.
+		/// </summary>
+		void StorePreviousState()
+		{
+			previousPosition = position;
+			previousRotation = rotation;
+			previousScale = scale;
+		}
+
+		/// <summary>
+		/// State blended between the previous and the current simulation step,
+		/// rendering uses these so that motion stays smooth at any framerate.
+		/// </summary>
+		vec3 GetRenderPosition() const
+		{
+			return glm::mix(previousPosition, position, Simulation::GetInterpolationAlpha());
+		}
+		quat GetRenderRotation() const
+		{
+			quat current = quat(glm::radians(rotation));
+			if (previousRotation == rotation) return current;
+
+			return glm::slerp(
+				quat(glm::radians(previousRotation)),
+				current,
+				Simulation::GetInterpolationAlpha());
+		}
+		vec3 GetRenderScale() const
+		{
+			return glm::mix(previousScale, scale, Simulation::GetInterpolationAlpha());
+		}
+		mat4 GetRenderMatrix() const
+		{
+			mat4 model = glm::translate(mat4(1.0f), GetRenderPosition());
+			model *= glm::mat4_cast(GetRenderRotation());
+			return glm::scale(model, GetRenderScale());
+		}
 	private:
 		vec3 position;
 		vec3 rotation;
 		vec3 scale;
+
+		vec3 previousPosition;
+		vec3 previousRotation;
+		vec3 previousScale;
 	};
 
 	struct AssimpVertex
@@ -101,6 +164,119 @@ namespace Graphics::Shape
 		}
 	};
 
+	/// <summary>
+	/// Part of an index buffer that belongs to one object of a static batch,
+	/// the bounds are in the space of the batch vertices.
+	/// </summary>
+	struct MeshRange
+	{
+		unsigned int indexOffset;
+		unsigned int indexCount;
+		vec3 boundsMin;
+		vec3 boundsMax;
+	};
+
+	/// <summary>
+	/// Geometry of a model on the gpu and the cpu, shared by every mesh created from the same source.
+	/// The buffers are deleted together with the last mesh that uses them.
+	/// </summary>
+	class MeshData
+	{
+	public:
+		MeshData(
+			const GLuint& VAO,
+			const GLuint& VBO,
+			const GLuint& EBO,
+			const vector<AssimpVertex>& vertices,
+			const vector<unsigned int>& indices) :
+			VAO(VAO),
+			VBO(VBO),
+			EBO(EBO),
+			vertices(vertices),
+			indices(indices)
+		{
+			//local bounds are kept next to the vertices so culling never has to walk them
+			boundsMin = vertices.empty() ? vec3(0.0f) : vertices[0].pos;
+			boundsMax = boundsMin;
+			for (const auto& vertex : vertices)
+			{
+				boundsMin = glm::min(boundsMin, vertex.pos);
+				boundsMax = glm::max(boundsMax, vertex.pos);
+			}
+		}
+		~MeshData()
+		{
+			if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+			if (VBO != 0) glDeleteBuffers(1, &VBO);
+			if (EBO != 0) glDeleteBuffers(1, &EBO);
+		}
+		MeshData(const MeshData&) = delete;
+		MeshData& operator=(const MeshData&) = delete;
+
+		/// <summary>
+		/// Transform of the node the mesh was imported from, new objects of this source start with it.
+		/// </summary>
+		void SetImportTransform(const vec3& position, const vec3& rotation, const vec3& scale)
+		{
+			importPosition = position;
+			importRotation = rotation;
+			importScale = scale;
+		}
+
+		const GLuint& GetVAO() const
+		{
+			return VAO;
+		}
+		const GLuint& GetVBO() const
+		{
+			return VBO;
+		}
+		const GLuint& GetEBO() const
+		{
+			return EBO;
+		}
+		const vector<AssimpVertex>& GetVertices() const
+		{
+			return vertices;
+		}
+		const vector<unsigned int>& GetIndices() const
+		{
+			return indices;
+		}
+		const vec3& GetBoundsMin() const
+		{
+			return boundsMin;
+		}
+		const vec3& GetBoundsMax() const
+		{
+			return boundsMax;
+		}
+		const vec3& GetImportPosition() const
+		{
+			return importPosition;
+		}
+		const vec3& GetImportRotation() const
+		{
+			return importRotation;
+		}
+		const vec3& GetImportScale() const
+		{
+			return importScale;
+		}
+	private:
+		GLuint VAO;
+		GLuint VBO;
+		GLuint EBO;
+		vector<AssimpVertex> vertices;
+		vector<unsigned int> indices;
+		vec3 boundsMin{};
+		vec3 boundsMax{};
+
+		vec3 importPosition{};
+		vec3 importRotation{};
+		vec3 importScale{ 1.0f };
+	};
+
 	class Mesh
 	{
 	public:
@@ -128,16 +304,33 @@ namespace Graphics::Shape
 			EBO(EBO)
 		{
 		}
+		/// <summary>
+		/// Mesh that draws shared geometry, the buffers belong to the mesh data.
+		/// </summary>
+		Mesh(const bool& isEnabled,
+			const MeshType& type,
+			const shared_ptr<MeshData>& data) :
+			isEnabled(isEnabled),
+			type(type),
+			VAO(0),
+			VBO(0),
+			EBO(0),
+			data(data)
+		{
+		}
 		~Mesh()
 		{
-			glDeleteVertexArrays(1, &VAO);
-			glDeleteBuffers(1, &VBO);
-			glDeleteBuffers(1, &EBO);
+			//meshes without gpu buffers never touch gl, so they can also live without a context
+			if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+			if (VBO != 0) glDeleteBuffers(1, &VBO);
+			if (EBO != 0) glDeleteBuffers(1, &EBO);
 		}
 
 		void SetEnableState(const bool& newIsEnabled)
 		{
+			if (isEnabled == newIsEnabled) return;
 			isEnabled = newIsEnabled;
+			RenderDamage::MarkScene();
 		}
 		void SetMeshType(const MeshType& newType)
 		{
@@ -155,13 +348,21 @@ namespace Graphics::Shape
 		{
 			EBO = newEBO;
 		}
-		void SetVertices(const vector<AssimpVertex>& newVertices)
+		/// <summary>
+		/// Per object index ranges of a static batch, each one is culled on its own.
+		/// </summary>
+		void SetRanges(const vector<MeshRange>& newRanges)
 		{
-			vertices = newVertices;
+			ranges = newRanges;
 		}
-		void SetIndices(const vector<unsigned int>& newIndices)
+		/// <summary>
+		/// Marks the mesh as an occluder for occlusion culling regardless of its size.
+		/// </summary>
+		void SetOccluder(const bool& newIsOccluder)
 		{
-			indices = newIndices;
+			if (isOccluder == newIsOccluder) return;
+			isOccluder = newIsOccluder;
+			RenderDamage::MarkScene();
 		}
 
 		const bool& IsEnabled() const
@@ -174,32 +375,57 @@ namespace Graphics::Shape
 		}
 		const GLuint& GetVAO() const
 		{
-			return VAO;
+			return data != nullptr ? data->GetVAO() : VAO;
 		}
 		const GLuint& GetVBO() const
 		{
-			return VBO;
+			return data != nullptr ? data->GetVBO() : VBO;
 		}
 		const GLuint& GetEBO() const
 		{
-			return EBO;
+			return data != nullptr ? data->GetEBO() : EBO;
+		}
+		const shared_ptr<MeshData>& GetMeshData() const
+		{
+			return data;
 		}
 		const vector<AssimpVertex>& GetVertices() const
 		{
-			return vertices;
+			return data != nullptr ? data->GetVertices() : noVertices;
 		}
 		const vector<unsigned int>& GetIndices() const
 		{
-			return indices;
+			return data != nullptr ? data->GetIndices() : noIndices;
+		}
+		const vector<MeshRange>& GetRanges() const
+		{
+			return ranges;
+		}
+		const bool& IsOccluder() const
+		{
+			return isOccluder;
+		}
+		const vec3& GetBoundsMin() const
+		{
+			return data != nullptr ? data->GetBoundsMin() : noBounds;
+		}
+		const vec3& GetBoundsMax() const
+		{
+			return data != nullptr ? data->GetBoundsMax() : noBounds;
 		}
 	private:
+		static inline const vector<AssimpVertex> noVertices;
+		static inline const vector<unsigned int> noIndices;
+		static inline const vec3 noBounds{};
+
 		bool isEnabled;
 		MeshType type;
 		GLuint VAO;
 		GLuint VBO;
 		GLuint EBO;
-		vector<AssimpVertex> vertices;
-		vector<unsigned int> indices;
+		shared_ptr<MeshData> data;
+		vector<MeshRange> ranges;
+		bool isOccluder{};
 	};
 
 	class Material
@@ -230,6 +456,7 @@ namespace Graphics::Shape
 			}
 
 			textures[textureType][textureName] = textureID;
+			RenderDamage::MarkScene();
 		}
 
 		void AddShader(const string& vertShader, const string& fragShader, const Shader& newShader)
@@ -239,6 +466,33 @@ namespace Graphics::Shape
 			shader = newShader;
 		}
 
+		/// <summary>
+		/// Shader variant picked for the current material and scene lights,
+		/// a different mask than last time loads the matching variant.
+		/// </summary>
+		const Shader& GetPermutation(uint32_t mask)
+		{
+			if (shaderNames.size() < 2) return shader;
+
+			if (mask != permutationMask
+				|| !hasPermutation)
+			{
+				permutationShader = Shader::LoadPermutation(shaderNames[0], shaderNames[1], mask);
+				permutationMask = mask;
+				hasPermutation = true;
+
+				//samplers keep their units per program, set them whenever a variant is picked up
+				if (permutationShader.ID != 0)
+				{
+					permutationShader.Use();
+					permutationShader.SetInt("material.diffuse", 0);
+					permutationShader.SetInt("material.specular", 1);
+				}
+			}
+
+			return permutationShader.ID != 0 ? permutationShader : shader;
+		}
+
 		const unsigned int& GetTextureID(const TextureType& type) const
 		{
 			static unsigned int none = 0;
@@ -307,6 +561,10 @@ namespace Graphics::Shape
 		map<TextureType, map<string, unsigned int>> textures;
 		vector<string> shaderNames;
 		Shader shader;
+
+		Shader permutationShader;
+		uint32_t permutationMask = 0;
+		bool hasPermutation = false;
 	};
 
 	class BasicShape_Variables
@@ -318,7 +576,9 @@ namespace Graphics::Shape
 
 		void SetShininess(const float& newShininess)
 		{
+			if (shininess == newShininess) return;
 			shininess = newShininess;
+			RenderDamage::MarkScene();
 		}
 
 		const float& GetShininess() const
@@ -344,15 +604,21 @@ namespace Graphics::Shape
 
 		void SetDiffuse(const vec3& newDiffuse)
 		{
+			if (diffuse == newDiffuse) return;
 			diffuse = newDiffuse;
+			RenderDamage::MarkScene();
 		}
 		void SetIntensity(const float& newIntensity)
 		{
+			if (intensity == newIntensity) return;
 			intensity = newIntensity;
+			RenderDamage::MarkScene();
 		}
 		void SetDistance(const float& newDistance)
 		{
+			if (distance == newDistance) return;
 			distance = newDistance;
+			RenderDamage::MarkScene();
 		}
 
 		const vec3& GetDiffuse() const
@@ -392,23 +658,33 @@ namespace Graphics::Shape
 
 		void SetDiffuse(const vec3& newDiffuse)
 		{
+			if (diffuse == newDiffuse) return;
 			diffuse = newDiffuse;
+			RenderDamage::MarkScene();
 		}
 		void SetIntensity(const float& newIntensity)
 		{
+			if (intensity == newIntensity) return;
 			intensity = newIntensity;
+			RenderDamage::MarkScene();
 		}
 		void SetDistance(const float& newDistance)
 		{
+			if (distance == newDistance) return;
 			distance = newDistance;
+			RenderDamage::MarkScene();
 		}
 		void SetInnerAngle(const float& newInnerAngle)
 		{
+			if (innerAngle == newInnerAngle) return;
 			innerAngle = newInnerAngle;
+			RenderDamage::MarkScene();
 		}
 		void SetOuterAngle(const float& newOuterAngle)
 		{
+			if (outerAngle == newOuterAngle) return;
 			outerAngle = newOuterAngle;
+			RenderDamage::MarkScene();
 		}
 
 		const vec3& GetDiffuse() const
@@ -452,11 +728,15 @@ namespace Graphics::Shape
 
 		void SetDiffuse(const vec3& newDiffuse)
 		{
+			if (diffuse == newDiffuse) return;
 			diffuse = newDiffuse;
+			RenderDamage::MarkScene();
 		}
 		void SetIntensity(const float& newIntensity)
 		{
+			if (intensity == newIntensity) return;
 			intensity = newIntensity;
+			RenderDamage::MarkScene();
 		}
 
 		const vec3& GetDiffuse() const
@@ -586,7 +866,17 @@ namespace Graphics::Shape
 		void SetName(const string& newName) { name = newName; }
 		void SetID(const unsigned int& newID) { ID = newID; }
 
-		void SetEnableState(const bool& newEnableState) { isEnabled = newEnableState; }
+		void SetEnableState(const bool& newEnableState)
+		{
+			if (isEnabled == newEnableState) return;
+			isEnabled = newEnableState;
+			RenderDamage::MarkScene();
+		}
+
+		/// <summary>
+		/// Static models never move in the game, the game build merges them into static batches.
+		/// </summary>
+		void SetStatic(const bool& newIsStatic) { isStatic = newIsStatic; }
 
 		void SetTransform(const shared_ptr<Transform>& newTransform) { transform = newTransform; }
 		void SetMesh(const shared_ptr<Mesh>& newMesh) { mesh = newMesh; }
@@ -637,6 +927,7 @@ namespace Graphics::Shape
 		const unsigned int& GetID() const {  return ID; }
 
 		const bool& IsEnabled() const { return isEnabled; }
+		const bool& IsStatic() const { return isStatic; }
 
 		const shared_ptr<Transform>& GetTransform() const { return transform; }
 		const shared_ptr<Mesh>& GetMesh() const { return mesh; }
@@ -657,6 +948,7 @@ namespace Graphics::Shape
 		unsigned int ID;
 
 		bool isEnabled;
+		bool isStatic{};
 
 		shared_ptr<Transform> transform;
 		shared_ptr<Mesh> mesh;
@@ -680,6 +972,13 @@ namespace Graphics::Shape
 			const mat4& view,
 			const mat4& projection);
 
+		/// <summary>
+		/// Sorts the transparent objects back to front along the viewing direction of this view matrix.
+		/// The order of the previous frame is kept, so a nearly unchanged order is only verified
+		/// or fixed with a few insertions, anything else is radix sorted by view depth.
+		/// </summary>
+		static void SortTransparentObjects(const mat4& view);
+
 		static inline bool renderBillboards = true;
 		static inline bool renderLightBorders = true;
 
@@ -690,26 +989,32 @@ namespace Graphics::Shape
 		static void AddGameObject(const shared_ptr<GameObject>& obj)
 		{
 			objects.push_back(obj);
+			RenderDamage::MarkScene();
 		}
 		static void AddOpaqueObject(const shared_ptr<GameObject>& obj)
 		{
 			opaqueObjects.push_back(obj);
+			RenderDamage::MarkScene();
 		}
 		static void AddTransparentObject(const shared_ptr<GameObject>& obj)
 		{
 			transparentObjects.push_back(obj);
+			RenderDamage::MarkScene();
 		}
 		static void AddPointLight(const shared_ptr<GameObject>& obj)
 		{
 			pointLights.push_back(obj);
+			RenderDamage::MarkScene();
 		}
 		static void AddSpotLight(const shared_ptr<GameObject>& obj)
 		{
 			spotLights.push_back(obj);
+			RenderDamage::MarkScene();
 		}
 		static void SetDirectionalLight(const shared_ptr<GameObject>& newDirectionalLight)
 		{
 			directionalLight = newDirectionalLight;
+			RenderDamage::MarkScene();
 		}
 		static void SetActionTex(const shared_ptr<GameObject>& newActionTex)
 		{
@@ -722,10 +1027,12 @@ namespace Graphics::Shape
 		static void AddBillboard(const shared_ptr<GameObject>& obj)
 		{
 			billboards.push_back(obj);
+			RenderDamage::MarkScene();
 		}
 		static void SetSkybox(const shared_ptr<GameObject>& obj)
 		{
 			skybox = obj;
+			RenderDamage::MarkScene();
 		}
 
 		/// <summary>
@@ -770,6 +1077,16 @@ namespace Graphics::Shape
 			return skybox;
 		}
 	private:
+		/// <summary>
+		/// View depth of a transparent object as an unsigned key that sorts back to front,
+		/// together with the index of the object in the transparent objects vector.
+		/// </summary>
+		struct TransparentSortKey
+		{
+			uint32_t key;
+			uint32_t index;
+		};
+
 		static inline map<string, vector<string>> categoryNames;
 		static inline vector<shared_ptr<GameObject>> objects;
 		static inline vector<shared_ptr<GameObject>> opaqueObjects;
@@ -781,5 +1098,19 @@ namespace Graphics::Shape
 		static inline shared_ptr<GameObject> border;
 		static inline vector<shared_ptr<GameObject>> billboards;
 		static inline shared_ptr<GameObject> skybox;
+
+		//reused every frame so that sorting never allocates once the scene has settled
+		static inline vector<TransparentSortKey> sortKeys;
+		static inline vector<TransparentSortKey> sortScratch;
+		static inline vector<shared_ptr<GameObject>> sortedObjects;
+
+		/// <summary>
+		/// Insertion sort that gives up after maxMoves element moves, returns true if keys ended up sorted.
+		/// </summary>
+		static bool InsertionSortKeys(vector<TransparentSortKey>& keys, size_t maxMoves);
+		/// <summary>
+		/// Stable least significant digit radix sort, passes where every key shares the same byte are skipped.
+		/// </summary>
+		static void RadixSortKeys(vector<TransparentSortKey>& keys, vector<TransparentSortKey>& scratch);
 	};
 }
\ No newline at end of file
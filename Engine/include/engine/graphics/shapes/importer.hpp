@@ -50,6 +50,7 @@ namespace Graphics::Shape
 			const bool& isEnabled = true);
 
 		static void ProcessNode(
+			const string& meshKey,
 			string& name,
 			unsigned int& id,
 			const bool& isEnabled,
@@ -73,6 +74,23 @@ namespace Graphics::Shape
 
 		static void DecomposeTransform(const aiMatrix4x4& transform, vec3& outPosition, vec3& outRotation, vec3& outScale);
 	private:
+		/// <summary>
+		/// Creates the gameobject of an imported model around its shared mesh data.
+		/// </summary>
+		static void InitializeModel(
+			const shared_ptr<MeshData>& meshData,
+			string& name,
+			unsigned int& id,
+			const bool& isEnabled,
+			const string& modelPath,
+			const string& vertShader,
+			const string& fragShader,
+			const string& diffTexture,
+			const string& specTexture,
+			const string& normalTexture,
+			const string& heightTexture,
+			const float& shininess);
+
 		static bool ValidateScene(const aiScene* scene);
 
 		//check mesh data
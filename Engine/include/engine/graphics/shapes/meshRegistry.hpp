@@ -0,0 +1,62 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+//engine
+#include "gameobject.hpp"
+
+namespace Graphics::Shape
+{
+	using std::string;
+	using std::vector;
+	using std::shared_ptr;
+	using std::weak_ptr;
+	using std::unordered_map;
+
+	/// <summary>
+	/// Hands out shared mesh data by source and import settings, so duplicated and reimported
+	/// models use the same vertex buffers and the same cpu copy of their geometry. The registry
+	/// only keeps weak references, the data lives as long as a mesh uses it. Main thread only.
+	/// </summary>
+	class MeshRegistry
+	{
+	public:
+		/// <summary>
+		/// Key of a model file imported with importFlags. Every gameobject keeps its own copy of
+		/// the model file, so the key comes from the file contents and not from its path.
+		/// Returns an empty key if the file can not be read.
+		/// </summary>
+		static string GetKey(const string& modelPath, unsigned int importFlags);
+
+		/// <summary>
+		/// Returns the data registered under key or nullptr if nothing uses it anymore.
+		/// </summary>
+		static shared_ptr<MeshData> Find(const string& key);
+
+		/// <summary>
+		/// Uploads the geometry and registers it under key, an empty key creates data
+		/// that is never shared, like the merged meshes of static batches.
+		/// </summary>
+		static shared_ptr<MeshData> Create(
+			const string& key,
+			const vector<AssimpVertex>& vertices,
+			const vector<unsigned int>& indices);
+
+		/// <summary>
+		/// Number of registered meshes that are still in use.
+		/// </summary>
+		static size_t GetMeshCount();
+	private:
+		static inline unordered_map<string, weak_ptr<MeshData>> meshes;
+
+		static void RemoveExpired();
+	};
+}
@@ -49,11 +49,29 @@ namespace Graphics::Shape
 			string& name = tempName,
 			unsigned int& id = tempID,
 			const bool& isEnabled = true,
-			const bool& isMeshEnabled = true);
+			const bool& isMeshEnabled = true,
+			const shared_ptr<MeshData>& meshData = nullptr);
 
 		static void Render(
 			const shared_ptr<GameObject>& obj,
 			const mat4& view,
 			const mat4& projection);
+
+		/// <summary>
+		/// Writes only the depth of the model, opaque materials use a shader without discard
+		/// so early depth testing stays enabled, alpha tested ones sample the diffuse alpha.
+		/// </summary>
+		static void RenderDepth(
+			const shared_ptr<GameObject>& obj,
+			const mat4& view,
+			const mat4& projection);
+	private:
+		/// <summary>
+		/// Draws every index of the mesh, or only the ranges of a static batch
+		/// that pass the occlusion test, merged into as few ranges as possible.
+		/// </summary>
+		static void DrawElements(
+			const shared_ptr<GameObject>& obj,
+			const mat4& modelViewProjection);
 	};
 }
\ No newline at end of file
@@ -28,7 +28,7 @@ namespace Graphics::Shape
 			const vec3& rot = vec3(0),
 			const vec3& scale = vec3(1));
 
-		static void RenderBorder(const shared_ptr<GameObject>& obj, const mat4& view, const mat4& projection);
+		static void RenderBorder();
 	};
 }
 #endif
\ No newline at end of file
@@ -43,9 +43,13 @@ namespace Graphics::Shape
 			unsigned int& thisId = id,
 			const bool& isEnabled = true);
 
+		/// <summary>
+		/// Drawn after the opaque objects at the far plane with GL_LEQUAL,
+		/// so every pixel already covered by geometry is rejected before shading.
+		/// </summary>
 		static void RenderSkybox(
 			const shared_ptr<GameObject>& obj,
-			mat4& view,
+			const mat4& view,
 			const mat4& projection);
 
 		/// <summary>
@@ -57,9 +61,36 @@ namespace Graphics::Shape
 		/// -Y (bottom),
 		/// +Z (front),
 		/// -Z (back)
+		/// The faces are decoded in parallel and stored as a cooked cubemap in the documents folder,
+		/// loading the same faces again reads the cooked file instead of decoding the images.
 		/// </summary>
 		static void AssignSkyboxTextures(vector<string> textures, bool flipTextures);
 	private:
 		static inline unsigned int skyboxTexture;
+
+		struct CubemapFace
+		{
+			int width{};
+			int height{};
+			int channels{};
+			vector<unsigned char> pixels;
+		};
+
+		/// <summary>
+		/// Decodes every distinct face image once on the job system workers.
+		/// </summary>
+		static void DecodeFaces(const vector<string>& textures, bool flipTextures, vector<CubemapFace>& faces);
+
+		/// <summary>
+		/// The file name is a hash of the face paths followed by a hash of their sizes and write times,
+		/// so editing any face image misses the old cooked file. Returns an empty string if a face is missing.
+		/// </summary>
+		static string GetCookedCubemapPath(const vector<string>& textures, bool flipTextures);
+		static bool LoadCookedCubemap(const string& cookedPath, vector<CubemapFace>& faces);
+
+		/// <summary>
+		/// Writes the cooked faces and deletes older cooked files of the same face set.
+		/// </summary>
+		static void SaveCookedCubemap(const string& cookedPath, const vector<CubemapFace>& faces);
 	};
 }
\ No newline at end of file
@@ -60,6 +60,6 @@ namespace Graphics::Shape
 			unsigned int& billboardID = tempID,
 			const bool& isBillboardEnabled = true);
 
-		static void RenderSpotLight(const shared_ptr<GameObject>& obj, const mat4& view, const mat4& projection);
+		static void RenderSpotLight(const shared_ptr<GameObject>& obj);
 	};
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 
 //external
@@ -17,6 +18,7 @@
 namespace Graphics
 {
 	using std::unordered_map;
+	using std::unordered_set;
 	using std::shared_ptr;
 
 	using Graphics::Shape::GameObject;
@@ -37,12 +39,21 @@ namespace Graphics
 			const string& texturePath,
 			const Material::TextureType type = Material::TextureType::diffuse,
 			bool flipTexture = false);
-		static void DeleteTexture(unsigned int texture)
+		/// <summary>
+		/// Deletes the texture and drops everything cached under its id, GL may hand the id out again.
+		/// </summary>
+		static void DeleteTexture(unsigned int texture);
+
+		/// <summary>
+		/// Returns true if the texture was loaded from an image with an alpha channel.
+		/// </summary>
+		static bool HasAlphaChannel(unsigned int texture)
 		{
-			glDeleteTextures(1, &texture);
+			return texturesWithAlpha.find(texture) != texturesWithAlpha.end();
 		}
 
 	private:
 		static inline unordered_map<string, unsigned int> textures;
+		static inline unordered_set<unsigned int> texturesWithAlpha;
 	};
 }
\ No newline at end of file
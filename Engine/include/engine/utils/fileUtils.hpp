@@ -7,11 +7,16 @@
 
 #include <string>
 #include <filesystem>
+#include <fstream>
+#include <functional>
+#include <cstdint>
 
 namespace Utils
 {
 	using std::string;
 	using std::filesystem::path;
+	using std::ofstream;
+	using std::function;
 
 	class File
 	{
@@ -83,6 +88,20 @@ namespace Utils
 			const string& fileName, 
 			const string& extension = "",
 			const bool& bypassParenthesesCheck = false);
+
+		/// <summary>
+		/// Fnv-1a of the contents of a file.
+		/// </summary>
+		/// <returns>False if the file could not be opened.</returns>
+		static bool HashContents(const string& filePath, uint64_t& outHash);
+
+		/// <summary>
+		/// Writes a file through a temporary file that replaces the target only after write succeeded,
+		/// so a crash or a failed write never leaves a truncated file behind.
+		/// </summary>
+		/// <param name="write">Fills the binary stream of the temporary file.</param>
+		/// <returns>False if the file could not be written.</returns>
+		static bool WriteAtomically(const string& filePath, const function<void(ofstream&)>& write);
 	private:
 		static string GetValueBetweenParentheses(const string& input);
 	};
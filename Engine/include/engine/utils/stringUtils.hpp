@@ -8,6 +8,7 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <cstdint>
 
 //external
 #include "glm.hpp"
@@ -101,5 +102,13 @@ namespace Utils
 		/// <param name="c"></param>
 		/// <returns></returns>
 		static bool IsValidSymbolInPath(const char& c);
+
+		static constexpr uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+
+		/// <summary>
+		/// Fnv-1a of a block of bytes, unlike std::hash it gives the same result in every build.
+		/// </summary>
+		/// <param name="hash">Result of the previous block to continue a hash over several blocks.</param>
+		static uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = fnvOffsetBasis);
 	};
 }
\ No newline at end of file
@@ -6,8 +6,10 @@
 #pragma once
 
 #include <string>
+#include <functional>
 
 using std::string;
+using std::function;
 
 namespace Core
 {
@@ -16,5 +18,19 @@ namespace Core
 	public:
 		static void Initialize(const string& version);
 		static void Run();
+
+		/// <summary>
+		/// Registers gameplay code that runs at a fixed rate, independent of the framerate.
+		/// Transforms moved here are interpolated between steps when rendered.
+		/// </summary>
+		static void AddFixedUpdate(const function<void(double)>& callback);
+		/// <summary>
+		/// Registers code that runs once per rendered frame, such as input and camera handling.
+		/// </summary>
+		static void AddUpdate(const function<void(double)>& callback);
+		/// <summary>
+		/// Sets the simulation step length in seconds and how many steps a single frame may run.
+		/// </summary>
+		static void SetFixedTimestep(double seconds, int maxStepsPerFrame = 8);
 	};
-}
\ No newline at end of file
+}
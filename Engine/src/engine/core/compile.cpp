@@ -3,9 +3,9 @@
 //This is free software, and you are welcome to redistribute it under certain conditions.
 //Read LICENSE.md for more information.
 #if ENGINE_MODE
+#include <Windows.h>
 #include <iostream>
 #include <filesystem>
-#include <thread>
 #include <iostream>
 #include <fstream>
 #include <cstdio>
@@ -31,17 +31,18 @@
 #include "gui_engine.hpp"
 #include "gui_settings.hpp"
 #include "configFile.hpp"
+#include "jobSystem.hpp"
+#include "staticBatchFile.hpp"
 
 using std::cout;
 using std::filesystem::directory_iterator;
 using std::filesystem::path;
 using std::exception;
 using std::filesystem::exists;
-using std::thread;
 using std::ofstream;
 using std::runtime_error;
 using std::array;
-using std::unique_ptr;
+using std::lock_guard;
 
 using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
@@ -57,6 +58,8 @@ using EngineFile::SceneFile;
 using Graphics::GUI::EngineGUI;
 using Graphics::GUI::GUISettings;
 using EngineFile::ConfigFile;
+using Core::JobSystem;
+using EngineFile::StaticBatchFile;
 
 namespace Core
 {
@@ -69,7 +72,8 @@ namespace Core
 
 		if (SceneFile::unsavedChanges) SceneFile::SaveScene();
 
-		thread CompileThread([]()
+		//the build mostly waits on cmake, so it gets its own thread instead of blocking a worker
+		JobSystem::RunLongJob([]()
 			{
 				//
 				// REMOVE OLD GAME EXE IF ANY EXISTS
@@ -94,6 +98,9 @@ namespace Core
 				//
 				RunInstaller();
 
+				//the engine is closing, nothing is touched anymore
+				if (JobSystem::IsCancelled()) return;
+
 				string gameStem = path(Engine::gameExePath).stem().string();
 				if (gameStem != "Game")
 				{
@@ -147,6 +154,12 @@ namespace Core
 					}
 				}
 
+				//
+				// MERGE STATIC MODELS OF THE COPIED SCENES
+				//
+
+				StaticBatchFile::CookScenes(gameDocsFolder);
+
 				//
 				// CREATE FIRST SCENE FILE WHICH GAME LOADS FROM WHEN GAME EXE IS RAN
 				//
@@ -178,9 +191,8 @@ namespace Core
 					"Compilation succeeded!\n");
 
 				finishedBuild = true;
-			});
-
-		CompileThread.detach();
+			},
+			StopInstaller);
 	}
 	
 	void Compilation::RunInstaller()
@@ -229,26 +241,111 @@ namespace Core
 		}
 		}
 
-		//command to run the batch file and capture errors
-		string fullCommand = command + " 2>&1"; //redirect stderr to stdout
+		//both output streams go to one pipe, only the child process inherits its write end
+		SECURITY_ATTRIBUTES securityAttributes{};
+		securityAttributes.nLength = sizeof(securityAttributes);
+		securityAttributes.bInheritHandle = TRUE;
 
-		array<char, 128> buffer{};
-		unique_ptr<FILE, decltype(&_pclose)> pipe(_popen(fullCommand.c_str(), "r"), _pclose);
+		HANDLE readPipe = nullptr;
+		HANDLE writePipe = nullptr;
+		if (!CreatePipe(&readPipe, &writePipe, &securityAttributes, 0))
+		{
+			throw runtime_error("CreatePipe() failed!");
+		}
+		SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+
+		//cmd, cmake and every compiler they start live in one job object,
+		//so cancelling the build ends the whole process tree and not just cmd
+		HANDLE jobObject = CreateJobObjectW(nullptr, nullptr);
+		JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits{};
+		limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+		SetInformationJobObject(jobObject, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+
+		STARTUPINFOA si{};
+		si.cb = sizeof(si);
+		si.dwFlags = STARTF_USESTDHANDLES;
+		si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+		si.hStdOutput = writePipe;
+		si.hStdError = writePipe;
+		PROCESS_INFORMATION pi{};
+
+		//started suspended so it can not spawn anything before it is in the job object
+		bool isStarted = CreateProcessA(
+			nullptr,
+			command.data(),
+			nullptr,
+			nullptr,
+			TRUE,
+			CREATE_SUSPENDED | CREATE_NO_WINDOW,
+			nullptr,
+			nullptr,
+			&si,
+			&pi);
+
+		//the pipe only reports its end once no process holds the write end anymore
+		CloseHandle(writePipe);
+
+		if (!isStarted)
+		{
+			CloseHandle(readPipe);
+			CloseHandle(jobObject);
+			throw runtime_error("CreateProcess() failed!");
+		}
 
-		if (!pipe)
+		AssignProcessToJobObject(jobObject, pi.hProcess);
 		{
-			throw runtime_error("_popen() failed!");
+			lock_guard<mutex> lock(installerMutex);
+			installerJob = jobObject;
 		}
+		//shutdown may have looked for the job before it was stored
+		if (JobSystem::IsCancelled()) TerminateJobObject(jobObject, 1);
+		ResumeThread(pi.hThread);
 
 		//read the output line by line and add to the provided vector
-		while (fgets(
-			buffer.data(), 
-			static_cast<int>(buffer.size()), 
-			pipe.get()) != nullptr)
+		array<char, 128> buffer{};
+		string line{};
+		DWORD bytesRead = 0;
+		while (ReadFile(
+			readPipe,
+			buffer.data(),
+			static_cast<DWORD>(buffer.size()),
+			&bytesRead,
+			nullptr)
+			&& bytesRead > 0)
 		{
-			output.emplace_back(buffer.data());
-			cout << buffer.data() << "\n";
+			if (JobSystem::IsCancelled()) break;
+
+			line.append(buffer.data(), bytesRead);
+			for (size_t end = line.find('\n'); end != string::npos; end = line.find('\n'))
+			{
+				string message = line.substr(0, end + 1);
+				output.emplace_back(message);
+				cout << message << "\n";
+				line.erase(0, end + 1);
+			}
+		}
+		if (!line.empty()
+			&& !JobSystem::IsCancelled())
+		{
+			output.emplace_back(line);
+			cout << line << "\n";
+		}
+
+		{
+			lock_guard<mutex> lock(installerMutex);
+			installerJob = nullptr;
 		}
+		//closing the job object ends anything that is still running after a cancel
+		CloseHandle(pi.hThread);
+		CloseHandle(pi.hProcess);
+		CloseHandle(readPipe);
+		CloseHandle(jobObject);
+	}
+
+	void Compilation::StopInstaller()
+	{
+		lock_guard<mutex> lock(installerMutex);
+		if (installerJob != nullptr) TerminateJobObject(installerJob, 1);
 	}
 
 	void Compilation::RenderBuildingWindow()
@@ -393,32 +490,62 @@ namespace Core
 			}
 			else
 			{
-				SceneFile::SaveScene();
+				//the previous run is still copying and cooking its scenes
+				if (isPreparingRun)
+				{
+					ConsoleManager::WriteConsoleMessage(
+						Caller::INPUT,
+						Type::INFO,
+						"A run is already being prepared, please wait until the game starts.\n");
+					return;
+				}
 
-				//
-				// CREATE NEW GAME DOCUMENTS FOLDER AND PLACE ALL SCENES AND THEIR CONTENT TO IT
-				//
+				SceneFile::SaveScene();
 
-				if (exists(gameProjectFolder)) File::DeleteFileOrfolder(gameProjectFolder + "\\scenes");
+				isPreparingRun = true;
 
+				//cooking parses every static model again, which would stall the editor on the main thread
 				string engineProjectFolder = path(Engine::projectPath).string();
-				for (const auto& entry : directory_iterator(path(engineProjectFolder)))
-				{
-					string stem = path(entry).stem().string();
-
-					if (stem != "models"
-						&& stem != "textures"
-						&& stem != "project")
+				string gameParentPath = Engine::gameParentPath;
+				string gameExePath = Engine::gameExePath;
+				JobSystem::RunLongJob([gameProjectFolder, engineProjectFolder, gameParentPath, gameExePath]()
 					{
-						string origin = path(entry).string();
-						string originFileName = path(entry).filename().string();
-						string target = gameProjectFolder + "\\" + originFileName;
+						//the flag is cleared on every way out, including a cancelled run
+						struct RunGuard
+						{
+							~RunGuard() { isPreparingRun = false; }
+						} runGuard;
 
-						File::CopyFileOrFolder(origin, target);
-					}
-				}
+						//
+						// CREATE NEW GAME DOCUMENTS FOLDER AND PLACE ALL SCENES AND THEIR CONTENT TO IT
+						//
+
+						if (exists(gameProjectFolder)) File::DeleteFileOrfolder(gameProjectFolder + "\\scenes");
+
+						for (const auto& entry : directory_iterator(path(engineProjectFolder)))
+						{
+							string stem = path(entry).stem().string();
+
+							if (stem != "models"
+								&& stem != "textures"
+								&& stem != "project")
+							{
+								string origin = path(entry).string();
+								string originFileName = path(entry).filename().string();
+								string target = gameProjectFolder + "\\" + originFileName;
+
+								File::CopyFileOrFolder(origin, target);
+							}
+						}
+
+						if (JobSystem::IsCancelled()) return;
+
+						StaticBatchFile::CookScenes(gameProjectFolder);
+
+						if (JobSystem::IsCancelled()) return;
 
-				File::RunApplication(Engine::gameParentPath, Engine::gameExePath);
+						File::RunApplication(gameParentPath, gameExePath);
+					});
 			}
 		}
 	}
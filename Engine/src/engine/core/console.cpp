@@ -7,6 +7,12 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 
 //external
 #include "magic_enum.hpp"
@@ -22,6 +28,9 @@
 #include "selectobject.hpp"
 #include "gameobject.hpp"
 #include "gui_console.hpp"
+#include "sceneGenerator.hpp"
+#include "renderDamage.hpp"
+#include "jobSystem.hpp"
 #if ENGINE_MODE
 #include "gui_engine.hpp"
 #endif
@@ -31,12 +40,21 @@ using std::chrono::system_clock;
 using std::chrono::milliseconds;
 using std::chrono::microseconds;
 using std::stringstream;
-using std::setw;
-using std::setfill;
 using std::ofstream;
+using std::array;
+using std::atomic;
+using std::thread;
+using std::mutex;
+using std::lock_guard;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::memory_order_seq_cst;
+using std::atomic_thread_fence;
 using std::error_code;
 using std::errc;
 using std::cout;
+using std::max;
 using glm::vec3;
 
 using Core::Engine;
@@ -47,6 +65,8 @@ using Graphics::Shape::GameObject;
 using Graphics::Shape::Mesh;
 using Graphics::Shape::Material;
 using Graphics::GUI::GUIConsole;
+using EngineFile::SceneGenerator;
+using Graphics::RenderDamage;
 #if ENGINE_MODE
 using Graphics::GUI::EngineGUI;
 #endif
@@ -55,6 +75,57 @@ namespace Core
 {
     ofstream logFile;
 
+    //lock-free bounded multi-producer single-consumer ring for the log writer thread,
+    //each slot sequence tells producers and the writer whose turn it is to use that slot
+    struct LogSlot
+    {
+        atomic<size_t> sequence;
+        string message;
+    };
+    constexpr size_t logRingCapacity = 4096;
+    array<LogSlot, logRingCapacity> logRing;
+    atomic<size_t> logEnqueuePos = 0;
+    size_t logDequeuePos = 0;
+
+    atomic<bool> logHasMessages = false;
+    atomic<bool> logWriterRunning = false;
+    atomic<size_t> logQueuedCount = 0;
+    atomic<size_t> logWrittenCount = 0;
+    thread logWriterThread;
+    //set once the writer thread has exited, late messages are then drained by their own producer
+    atomic<bool> logWriterStopped = false;
+    //orders writes from outside the writer thread with the writer, the final drain and closing the log file
+    mutex logOutputMutex;
+
+    static bool DequeueLoggerLog(string& message)
+    {
+        LogSlot& slot = logRing[logDequeuePos & (logRingCapacity - 1)];
+        size_t sequence = slot.sequence.load(memory_order_acquire);
+        if (sequence != logDequeuePos + 1) return false;
+
+        message = move(slot.message);
+        slot.sequence.store(logDequeuePos + logRingCapacity, memory_order_release);
+        logDequeuePos++;
+        return true;
+    }
+
+    //caller holds logOutputMutex
+    static void WriteLoggerLogDirectly(const string& message)
+    {
+        cout << message;
+        if (logFile.is_open()) logFile << message << "\n";
+    }
+
+    //caller holds logOutputMutex and the writer thread has exited, so the caller is the only consumer
+    static void DrainStoppedLogger()
+    {
+        string message;
+        while (DequeueLoggerLog(message))
+        {
+            WriteLoggerLogDirectly(message);
+        }
+    }
+
     string ConsoleManager::GetCurrentTimestamp()
     {
         auto now = system_clock::now();
@@ -66,15 +137,16 @@ namespace Core
         tm tm;
         localtime_s(&tm, &now_c);
 
-        stringstream ss{};
-        ss
-            << "["
-            << setw(2) << setfill('0') << tm.tm_hour << ":"
-            << setw(2) << setfill('0') << tm.tm_min << ":"
-            << setw(2) << setfill('0') << tm.tm_sec << ":"
-            << setw(3) << setfill('0') << ms.count()
-            << "] ";
-        return ss.str();
+        char buffer[32];
+        snprintf(
+            buffer,
+            sizeof(buffer),
+            "[%02d:%02d:%02d:%03d] ",
+            tm.tm_hour,
+            tm.tm_min,
+            tm.tm_sec,
+            static_cast<int>(ms.count()));
+        return buffer;
     }
 
     void ConsoleManager::InitializeLogger()
@@ -94,39 +166,186 @@ namespace Core
                 "Error: Failed to open log file! Reason: " +
                 ec.message() + "\n\n");
         }
+
+        for (size_t i = 0; i < logRingCapacity; i++)
+        {
+            logRing[i].sequence.store(i, memory_order_relaxed);
+        }
+        logEnqueuePos = 0;
+        logDequeuePos = 0;
+
+        logWriterStopped = false;
+        logWriterRunning = true;
+        logWriterThread = thread(LogWriterLoop);
     }
 
-    void ConsoleManager::PrintLogsToBuffer()
+    void ConsoleManager::LogWriterLoop()
     {
-        for (const auto& log : storedLogs)
+        string consoleBatch;
+        string fileBatch;
+        string message;
+
+        while (true)
         {
-            GUIConsole::AddTextToConsole(log);
+            logHasMessages.wait(false);
+            logHasMessages.store(false);
+
+            size_t count = 0;
+            while (DequeueLoggerLog(message))
+            {
+                consoleBatch += message;
+                fileBatch += message;
+                fileBatch += "\n";
+                count++;
+            }
+
+            if (count > 0)
+            {
+                {
+                    lock_guard<mutex> lock(logOutputMutex);
+                    cout << consoleBatch;
+                    cout.flush();
+                    if (logFile.is_open())
+                    {
+                        logFile << fileBatch;
+                        logFile.flush();
+                    }
+                }
+                consoleBatch.clear();
+                fileBatch.clear();
+
+                logWrittenCount.fetch_add(count);
+                logWrittenCount.notify_all();
+            }
+
+            if (!logWriterRunning) break;
         }
-        storedLogs.clear();
     }
 
-    void ConsoleManager::AddLoggerLog(const string& message)
+    void ConsoleManager::QueueLoggerLog(string&& message)
     {
-        if (logFile.is_open())
+        if (!logWriterRunning)
+        {
+            lock_guard<mutex> lock(logOutputMutex);
+            WriteLoggerLogDirectly(message);
+            return;
+        }
+
+        size_t pos = logEnqueuePos.load(memory_order_relaxed);
+        while (true)
+        {
+            LogSlot& slot = logRing[pos & (logRingCapacity - 1)];
+            size_t sequence = slot.sequence.load(memory_order_acquire);
+
+            if (sequence == pos)
+            {
+                if (logEnqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    slot.message = move(message);
+                    slot.sequence.store(pos + 1, memory_order_release);
+                    break;
+                }
+            }
+            else if (sequence < pos)
+            {
+                //ring is full, wake the writer and wait for it to free a slot,
+                //once the writer has stopped the slots are freed here instead
+                if (logWriterStopped)
+                {
+                    lock_guard<mutex> lock(logOutputMutex);
+                    DrainStoppedLogger();
+                }
+                else
+                {
+                    logHasMessages.store(true);
+                    logHasMessages.notify_one();
+                    std::this_thread::yield();
+                }
+                pos = logEnqueuePos.load(memory_order_relaxed);
+            }
+            else pos = logEnqueuePos.load(memory_order_relaxed);
+        }
+
+        logQueuedCount.fetch_add(1);
+        logHasMessages.store(true);
+        logHasMessages.notify_one();
+
+        //the writer may have stopped after this producer saw it running,
+        //a message queued after the final drain of CloseLogger is written here instead of being lost
+        atomic_thread_fence(memory_order_seq_cst);
+        if (logWriterStopped)
         {
-            logFile << message << "\n";
+            lock_guard<mutex> lock(logOutputMutex);
+            DrainStoppedLogger();
         }
     }
 
-    void ConsoleManager::AddConsoleLog(const std::string& message)
+    void ConsoleManager::FlushLogger()
     {
-        storedLogs.push_back(message);
+        if (!logWriterRunning) return;
+
+        size_t target = logQueuedCount.load();
+        size_t written = logWrittenCount.load();
+        while (written < target)
+        {
+            logWrittenCount.wait(written);
+            written = logWrittenCount.load();
+        }
+    }
+
+    void ConsoleManager::PrintLogsToBuffer()
+    {
+        vector<StoredLog> logs;
+        {
+            lock_guard<mutex> lock(storedLogsMutex);
+            if (storedLogs.empty()) return;
+            logs.swap(storedLogs);
+        }
+
+        for (const auto& log : logs)
+        {
+            GUIConsole::AddTextToConsole(log.message, log.caller, log.type);
+        }
+    }
+
+    void ConsoleManager::AddLoggerLog(const string& message)
+    {
+        QueueLoggerLog(string(message));
+    }
+
+    void ConsoleManager::AddConsoleLog(const std::string& message, Caller caller, Type type)
+    {
+        lock_guard<mutex> lock(storedLogsMutex);
+        storedLogs.push_back({ message, caller, type });
     }
 
     void ConsoleManager::CloseLogger()
     {
+        if (logWriterRunning)
+        {
+            FlushLogger();
+
+            logWriterRunning = false;
+            logHasMessages.store(true);
+            logHasMessages.notify_one();
+            logWriterThread.join();
+        }
+
+        lock_guard<mutex> lock(logOutputMutex);
+
+        //write anything that was queued while the writer was stopping,
+        //producers that still get a message in afterwards drain it themselves
+        logWriterStopped = true;
+        atomic_thread_fence(memory_order_seq_cst);
+        DrainStoppedLogger();
+
         if (logFile.is_open())
         {
             logFile.close();
         }
     }
 
-    void ConsoleManager::WriteConsoleMessage(Caller caller, Type type, const string& message, bool onlyMessage, bool internalMessage)
+    void ConsoleManager::WriteMessage(Caller caller, Type type, const string& message, bool onlyMessage, bool internalMessage)
     {
         string timeStamp = GetCurrentTimestamp();
         string theCaller = string(magic_enum::enum_name(caller));
@@ -168,12 +387,22 @@ namespace Core
             || (!sendDebugMessages
             && type != Type::DEBUG)))
         {
-            if (Engine::isEngineRunning) GUIConsole::AddTextToConsole(internalMsg);
-            else AddConsoleLog(internalMsg);
+            //the gui console is only touched by the main thread,
+            //messages from other threads wait until the next frame picks them up
+            if (Engine::isEngineRunning
+                && JobSystem::IsMainThread())
+            {
+                GUIConsole::AddTextToConsole(internalMsg, caller, type);
+                RenderDamage::MarkGUI();
+            }
+            else
+            {
+                AddConsoleLog(internalMsg, caller, type);
+                if (Engine::isEngineRunning) RenderDamage::WakeMainThread();
+            }
         }
 
-        cout << externalMsg;
-        AddLoggerLog(externalMsg);
+        QueueLoggerLog(move(externalMsg));
     }
 
     void ConsoleManager::ParseConsoleCommand(const string& command)
@@ -206,7 +435,8 @@ namespace Core
                 << "qqq - quits the engine\n"
                 << "srm 'int' - sets the render mode (shaded (1), wireframe (2)\n"
                 << "rc - resets the camera back to its original position and rotation\n"
-                << "dbg - prints debug info about selected gameobject (click on object before using this command)"
+                << "dbg - prints debug info about selected gameobject (click on object before using this command)\n"
+                << "gen 'name' 'models' 'point lights' 'spot lights' 'billboards' 'uniform/grid/cluster' 'seed' - generates a stress test scene into the scenes folder, everything after models is optional\n"
 #if ENGINE_MODE
 #else
                 << "toggle - enables or disables selected gameobject based on its enabled state (click on object before using this command)"
@@ -281,6 +511,7 @@ namespace Core
                  && cleanedCommands.size() == 2)
         {
             wireframeMode = cleanedCommands[1] != "1";
+            RenderDamage::MarkScene();
             glPolygonMode(
                 GL_FRONT_AND_BACK,
                 wireframeMode ? GL_LINE : GL_FILL);
@@ -293,6 +524,25 @@ namespace Core
                 Type::INFO,
                 "Set wireframe mode to " + wireframeModeValue + ".\n");
         }
+        else if (cleanedCommands[0] == "gen"
+                 && cleanedCommands.size() >= 3
+                 && cleanedCommands.size() <= 8)
+        {
+            SceneGenerator::Settings settings{};
+            settings.sceneFolder = Engine::scenesPath + "\\" + cleanedCommands[1];
+            settings.modelCount = max(0, atoi(cleanedCommands[2].c_str()));
+            if (cleanedCommands.size() > 3) settings.pointLightCount = max(0, atoi(cleanedCommands[3].c_str()));
+            if (cleanedCommands.size() > 4) settings.spotLightCount = max(0, atoi(cleanedCommands[4].c_str()));
+            if (cleanedCommands.size() > 5) settings.billboardCount = max(0, atoi(cleanedCommands[5].c_str()));
+            if (cleanedCommands.size() > 6)
+            {
+                if (cleanedCommands[6] == "grid") settings.distribution = SceneGenerator::Distribution::grid;
+                else if (cleanedCommands[6] == "cluster") settings.distribution = SceneGenerator::Distribution::cluster;
+            }
+            if (cleanedCommands.size() > 7) settings.seed = static_cast<unsigned int>(strtoul(cleanedCommands[7].c_str(), nullptr, 10));
+
+            SceneGenerator::Generate(settings);
+        }
         else
         {
             WriteConsoleMessage(
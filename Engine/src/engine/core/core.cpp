@@ -28,10 +28,15 @@
 #include "fileUtils.hpp"
 #include "stringUtils.hpp"
 #include "gameobject.hpp"
+#include "profiler.hpp"
+#include "headless.hpp"
+#include "simulation.hpp"
+#include "jobSystem.hpp"
 #if ENGINE_MODE
 #include "gui_engine.hpp"
 #include "gui_settings.hpp"
 #include "compile.hpp"
+#include "projectDirectory.hpp"
 #else
 #include "gui_game.hpp"
 #endif
@@ -58,10 +63,15 @@ using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
 using Type = Core::ConsoleManager::Type;
 using Graphics::Shape::GameObjectManager;
+using Core::Profiler;
+using Core::Headless;
+using Core::Simulation;
+using Core::JobSystem;
 #if ENGINE_MODE
 using Graphics::GUI::EngineGUI;
 using Graphics::GUI::GUISettings;
 using Core::Compilation;
+using EngineFile::ProjectDirectory;
 #else
 using Graphics::GUI::GameGUI;
 #endif
@@ -92,7 +102,8 @@ namespace Core
 			}
 		}
 #endif
-		if (IsThisProcessAlreadyRunning(name + ".exe"))
+		if (!Headless::isEnabled
+			&& IsThisProcessAlreadyRunning(name + ".exe"))
 		{
 			CreateErrorPopup((name + " is already running!").c_str());
 		}
@@ -353,6 +364,8 @@ namespace Core
 
 		ConsoleManager::InitializeLogger();
 
+		JobSystem::Initialize();
+
 		ConfigFile::LoadConfigFile();
 
 		//
@@ -431,8 +444,16 @@ namespace Core
 		Render::RenderSetup();
 
 		string lastSavedScenePath = Engine::docsPath + "\\lastSavedScene.txt";
+		//headless runs always load the scene passed from the command line
+		if (Headless::isEnabled
+			&& !Headless::scenePath.empty())
+		{
+			double loadStart = Profiler::GetTimeMilliseconds();
+			SceneFile::LoadScene(Headless::scenePath);
+			Headless::sceneLoadMilliseconds = Profiler::GetTimeMilliseconds() - loadStart;
+		}
 		//attempt to load last saved scene
-		if (exists(lastSavedScenePath))
+		else if (exists(lastSavedScenePath))
 		{
 			ifstream lastSavedSceneFile(lastSavedScenePath);
 			if (!lastSavedSceneFile.is_open())
@@ -475,6 +496,11 @@ namespace Core
 		else SceneFile::LoadScene(scenesPath + "\\Scene1\\scene.txt");
 
 #if ENGINE_MODE
+		if (!Headless::isEnabled)
+		{
+			ProjectDirectory::Initialize(path(projectPath).parent_path().string());
+		}
+
 #if DISCORD_MODE
 		string appID{};
 		//app id specific for the engine
@@ -530,6 +556,14 @@ namespace Core
 			<< "===================="
 			<< "\n";
 
+		//nobody is there to close the popup in headless runs
+		if (Headless::isEnabled)
+		{
+			ConsoleManager::CloseLogger();
+			glfwTerminate();
+			quick_exit(EXIT_FAILURE);
+		}
+
 		int result = MessageBoxA(nullptr, errorMessage, title.c_str(), MB_ICONERROR | MB_OK);
 
 		if (result == IDOK) Shutdown(true);
@@ -592,17 +626,24 @@ namespace Core
 			false);
 
 		isEngineRunning = true;
-#if ENGINE_MODE
-		if (!ConsoleManager::storedLogs.empty())
+
+		if (Headless::isEnabled)
 		{
-			ConsoleManager::PrintLogsToBuffer();
+			Headless::RunBenchmark();
+			return;
 		}
-#endif
-
 		while (isEngineRunning)
 		{
+			Profiler::BeginFrame();
 			TimeManager::UpdateDeltaTime();
+
+			//work and messages that other threads handed back to the main thread
+			JobSystem::ExecuteMainThreadJobs();
+			ConsoleManager::PrintLogsToBuffer();
+
+			Simulation::Update(TimeManager::deltaTime);
 			Render::WindowLoop();
+			Profiler::EndFrame();
 #if DISCORD_MODE
 			RunDiscordRichPresence();
 #endif
@@ -691,6 +732,8 @@ namespace Core
 	bool Engine::IsUserIdle()
 	{
 		//checks if window is minimized
+		if (glfwGetWindowAttrib(Render::window, GLFW_ICONIFIED)) return true;
+
 		int width, height;
 		glfwGetWindowSize(Render::window, &width, &height);
 		if (width == 0 || height == 0) return true;
@@ -704,8 +747,10 @@ namespace Core
 		{
 			isEngineRunning = false;
 
+			JobSystem::Shutdown();
 			ConsoleManager::CloseLogger();
 #if ENGINE_MODE
+			ProjectDirectory::Shutdown();
 			EngineGUI::Shutdown();
 #else
 			GameGUI::Shutdown();
@@ -750,7 +795,9 @@ namespace Core
 					Type::INFO,
 					"Cleaning up resources...\n");
 
+				JobSystem::Shutdown();
 #if ENGINE_MODE
+				ProjectDirectory::Shutdown();
 				EngineGUI::Shutdown();
 #else
 				GameGUI::Shutdown();
@@ -0,0 +1,176 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <time.h>
+#include <cerrno>
+#endif
+#include <thread>
+#include <algorithm>
+#include <cmath>
+
+//external
+#include "glfw3.h"
+
+//engine
+#include "framePacer.hpp"
+#include "configFile.hpp"
+
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::this_thread::yield;
+using std::max;
+using std::min;
+using std::clamp;
+using std::abs;
+using std::floor;
+
+using EngineFile::ConfigFile;
+
+#ifdef _WIN32
+//older sdks dont define this yet, windows versions before 10 1803 reject it and we fall back
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+namespace Core
+{
+	void FramePacer::Initialize()
+	{
+		const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+		if (mode != nullptr
+			&& mode->refreshRate > 0)
+		{
+			monitorRefreshRate = mode->refreshRate;
+		}
+
+#ifdef _WIN32
+		waitableTimer = CreateWaitableTimerExW(
+			NULL,
+			NULL,
+			CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+			TIMER_ALL_ACCESS);
+		if (waitableTimer == NULL)
+		{
+			waitableTimer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+		}
+#endif
+		ResetDeadline();
+	}
+
+	int FramePacer::GetTargetFPS()
+	{
+		static const int& targetFPS = ConfigFile::GetInt("window_targetFPS");
+		static const bool& vsync = ConfigFile::GetBool("window_vsync");
+
+		if (targetFPS > 0) return targetFPS;
+		return vsync ? 0 : monitorRefreshRate;
+	}
+
+	void FramePacer::WaitForNextFrame()
+	{
+		int targetFPS = GetTargetFPS();
+		steady_clock::time_point now = steady_clock::now();
+
+		if (targetFPS > 0)
+		{
+			steady_clock::duration period = duration_cast<steady_clock::duration>(
+				duration<double>(1.0 / static_cast<double>(targetFPS)));
+
+			nextFrameTime += period;
+
+			//a late frame starts a new schedule instead of trying to catch up with short frames
+			if (nextFrameTime <= now
+				|| nextFrameTime > now + period)
+			{
+				nextFrameTime = now;
+			}
+			else
+			{
+				double remaining = duration<double>(nextFrameTime - now).count();
+				if (remaining > sleepMargin)
+				{
+					double sleepTime = remaining - sleepMargin;
+					steady_clock::time_point sleepStart = steady_clock::now();
+					SleepFor(sleepTime);
+					double slept = duration<double>(steady_clock::now() - sleepStart).count();
+
+					//track how late the os wakes us up, the margin decays slowly when it improves
+					double oversleep = max(slept - sleepTime, 0.0);
+					sleepMargin = clamp(
+						max(oversleep + 0.00025, sleepMargin * 0.99),
+						0.0005,
+						0.004);
+				}
+
+				//the os scheduler is not precise enough for the last fraction of a millisecond
+				while (steady_clock::now() < nextFrameTime) yield();
+			}
+		}
+
+		now = steady_clock::now();
+		if (!skipNextSample)
+		{
+			double expected = 1.0 / static_cast<double>(targetFPS > 0 ? targetFPS : monitorRefreshRate);
+			RecordJitter(duration<double>(now - lastFrameTime).count(), expected);
+		}
+		skipNextSample = false;
+		lastFrameTime = now;
+	}
+
+	void FramePacer::ResetDeadline()
+	{
+		nextFrameTime = steady_clock::now();
+		skipNextSample = true;
+	}
+
+	void FramePacer::SleepFor(double seconds)
+	{
+#ifdef _WIN32
+		if (waitableTimer != NULL)
+		{
+			//negative due time is relative, in 100 nanosecond units
+			LARGE_INTEGER dueTime{};
+			dueTime.QuadPart = -static_cast<LONGLONG>(seconds * 10000000.0);
+			if (SetWaitableTimer(waitableTimer, &dueTime, 0, NULL, NULL, FALSE))
+			{
+				WaitForSingleObject(waitableTimer, INFINITE);
+				return;
+			}
+		}
+		Sleep(static_cast<DWORD>(seconds * 1000.0));
+#else
+		//absolute deadline so that signal interruptions dont stretch the sleep
+		timespec deadline{};
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		long long nanoseconds = static_cast<long long>(deadline.tv_nsec)
+			+ static_cast<long long>(seconds * 1000000000.0);
+		deadline.tv_sec += static_cast<time_t>(nanoseconds / 1000000000);
+		deadline.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {}
+#endif
+	}
+
+	void FramePacer::RecordJitter(double frameSeconds, double expectedSeconds)
+	{
+		double errorMilliseconds = (frameSeconds - expectedSeconds) * 1000.0;
+		worstJitter = max(worstJitter, abs(errorMilliseconds));
+
+		int center = jitterBucketCount / 2;
+		int bucket = static_cast<int>(floor(errorMilliseconds / jitterBucketWidth)) + center;
+		jitterHistogram[clamp(bucket, 0, jitterBucketCount - 1)]++;
+	}
+
+	void FramePacer::ResetJitterHistogram()
+	{
+		jitterHistogram.fill(0.0f);
+		worstJitter = 0.0;
+	}
+}
@@ -0,0 +1,384 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+
+//external
+#include "glad.h"
+#include "glfw3.h"
+#include "matrix_transform.hpp"
+
+//engine
+#include "headless.hpp"
+#include "core.hpp"
+#include "console.hpp"
+#include "render.hpp"
+#include "camera.hpp"
+#include "configFile.hpp"
+#include "stringUtils.hpp"
+#include "selectobject.hpp"
+#include "gameobject.hpp"
+#include "profiler.hpp"
+#include "renderTargetPool.hpp"
+
+using std::ifstream;
+using std::ofstream;
+using std::sort;
+using std::min;
+using std::max;
+using std::to_string;
+using std::chrono::high_resolution_clock;
+using std::chrono::duration;
+using std::milli;
+using glm::perspective;
+using glm::radians;
+using glm::degrees;
+using glm::mix;
+
+using Graphics::Render;
+using Graphics::Camera;
+using EngineFile::ConfigFile;
+using Utils::String;
+using Core::Select;
+using Core::Profiler;
+using Graphics::RenderTarget;
+using Graphics::RenderTargetPool;
+using Graphics::Shape::GameObjectManager;
+using Caller = Core::ConsoleManager::Caller;
+using Type = Core::ConsoleManager::Type;
+
+namespace Core
+{
+	void Headless::ParseArguments(int argc, char* argv[])
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "--headless") isEnabled = true;
+			else if (argument == "--scene" && hasValue) scenePath = argv[++i];
+			else if (argument == "--output" && hasValue) outputPath = argv[++i];
+			else if (argument == "--camera-path" && hasValue) cameraPathFile = argv[++i];
+			else if (argument == "--frames" && hasValue) frameCount = max(1, atoi(argv[++i]));
+			else if (argument == "--warmup" && hasValue) warmupFrames = max(0, atoi(argv[++i]));
+			else if (argument == "--width" && hasValue) width = max(1, atoi(argv[++i]));
+			else if (argument == "--height" && hasValue) height = max(1, atoi(argv[++i]));
+			else if (argument == "--camera-radius" && hasValue) cameraRadius = static_cast<float>(atof(argv[++i]));
+			else if (argument == "--camera-height" && hasValue) cameraHeight = static_cast<float>(atof(argv[++i]));
+			else if (argument == "--context" && hasValue)
+			{
+				string value = argv[++i];
+				if (value == "osmesa") contextAPI = ContextAPI::osmesa;
+				else if (value == "egl") contextAPI = ContextAPI::egl;
+				else contextAPI = ContextAPI::native;
+			}
+		}
+	}
+
+	void Headless::LoadCameraPath()
+	{
+		cameraPath.clear();
+		if (cameraPathFile.empty()) return;
+
+		ifstream pathFile(cameraPathFile);
+		if (!pathFile.is_open())
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Failed to open camera path file '" + cameraPathFile + "'! Using the default orbit instead.\n");
+			return;
+		}
+
+		//each line is one key: x, y, z, yaw, pitch
+		string line;
+		while (getline(pathFile, line))
+		{
+			vector<string> values = String::Split(line, ',');
+			if (values.size() < 5) continue;
+
+			CameraKey key{};
+			key.position = vec3(
+				static_cast<float>(atof(values[0].c_str())),
+				static_cast<float>(atof(values[1].c_str())),
+				static_cast<float>(atof(values[2].c_str())));
+			key.yaw = static_cast<float>(atof(values[3].c_str()));
+			key.pitch = static_cast<float>(atof(values[4].c_str()));
+			cameraPath.push_back(key);
+		}
+		pathFile.close();
+	}
+
+	void Headless::UpdateCamera(int frame)
+	{
+		float progress = static_cast<float>(frame) / static_cast<float>(max(frameCount - 1, 1));
+
+		if (cameraPath.size() >= 2)
+		{
+			//keys are spread evenly over all measured frames
+			float keyPosition = progress * static_cast<float>(cameraPath.size() - 1);
+			size_t index = min(static_cast<size_t>(keyPosition), cameraPath.size() - 2);
+			float t = keyPosition - static_cast<float>(index);
+
+			const CameraKey& a = cameraPath[index];
+			const CameraKey& b = cameraPath[index + 1];
+			Render::camera.SetCameraPosition(mix(a.position, b.position, t));
+			Render::camera.SetCameraRotation(vec3(
+				mix(a.yaw, b.yaw, t),
+				mix(a.pitch, b.pitch, t),
+				0.0f));
+		}
+		else
+		{
+			//default path is one full orbit around the world origin, always looking at the origin
+			float angle = progress * 2.0f * glm::pi<float>();
+			vec3 position = vec3(
+				cos(angle) * cameraRadius,
+				cameraHeight,
+				sin(angle) * cameraRadius);
+
+			Render::camera.SetCameraPosition(position);
+			Render::camera.SetCameraRotation(vec3(
+				degrees(angle) + 180.0f,
+				-degrees(atan2(cameraHeight, cameraRadius)),
+				0.0f));
+		}
+	}
+
+	void Headless::RunBenchmark()
+	{
+		LoadCameraPath();
+
+		static const float& fov = ConfigFile::GetFloat("camera_fov");
+		static const float& nearClip = ConfigFile::GetFloat("camera_nearClip");
+		static const float& farClip = ConfigFile::GetFloat("camera_farClip");
+
+		Camera::aspectRatio = static_cast<float>(width) / static_cast<float>(height);
+		glfwSwapInterval(0);
+
+		//the default framebuffer of a hidden window is subject to the pixel ownership test,
+		//so frames go into an offscreen target that always owns every pixel
+		RenderTarget* target = RenderTargetPool::Acquire(width, height, GL_RGBA8, true);
+
+		//gpu times are read back a few frames later so the cpu never waits on the query results
+		constexpr int queryLatency = 4;
+		GLuint queries[queryLatency];
+		glGenQueries(queryLatency, queries);
+
+		int totalFrames = warmupFrames + frameCount;
+		vector<double> cpuTimes;
+		vector<double> gpuTimes;
+		vector<double> pickTimes;
+		cpuTimes.reserve(frameCount);
+		gpuTimes.reserve(frameCount);
+		pickTimes.reserve(frameCount);
+
+		auto ReadGPUTime = [&](int frame)
+			{
+				GLuint64 elapsed = 0;
+				glGetQueryObjectui64v(queries[frame % queryLatency], GL_QUERY_RESULT, &elapsed);
+				if (frame >= warmupFrames) gpuTimes.push_back(static_cast<double>(elapsed) / 1000000.0);
+			};
+
+		ConsoleManager::WriteConsoleMessage(
+			Caller::INPUT,
+			Type::INFO,
+			"Running headless benchmark for " + to_string(frameCount) + " frames at "
+			+ to_string(width) + "x" + to_string(height) + "...\n");
+
+		for (int frame = 0; frame < totalFrames; frame++)
+		{
+			auto frameStart = high_resolution_clock::now();
+
+			if (frame >= queryLatency) ReadGPUTime(frame - queryLatency);
+
+			UpdateCamera(max(frame - warmupFrames, 0));
+
+			Render::projection = perspective(
+				radians(fov),
+				Camera::aspectRatio,
+				nearClip,
+				farClip);
+			Render::view = Render::camera.GetViewMatrix();
+
+			glBeginQuery(GL_TIME_ELAPSED, queries[frame % queryLatency]);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+			glViewport(0, 0, width, height);
+			glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+			glEnable(GL_DEPTH_TEST);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			Render::RenderScene();
+
+			glEndQuery(GL_TIME_ELAPSED);
+
+			glfwPollEvents();
+
+			if (frame >= warmupFrames)
+			{
+				cpuTimes.push_back(duration<double, milli>(high_resolution_clock::now() - frameStart).count());
+
+				//picking is timed separately so it doesnt skew the frame times
+				double pickStart = Profiler::GetTimeMilliseconds();
+				Select::Ray ray = Select::RayFromMouse(
+					static_cast<float>(width),
+					static_cast<float>(height),
+					width * 0.5,
+					height * 0.5,
+					Render::view,
+					Render::projection);
+				Select::CheckRayObjectIntersections(ray, GameObjectManager::GetObjects());
+				pickTimes.push_back(Profiler::GetTimeMilliseconds() - pickStart);
+			}
+		}
+
+		for (int frame = max(totalFrames - queryLatency, 0); frame < totalFrames; frame++)
+		{
+			ReadGPUTime(frame);
+		}
+		glDeleteQueries(queryLatency, queries);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, target->framebuffer);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(width / 2, height / 2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, centerPixel);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderTargetPool::Release(target);
+
+		WriteResults(cpuTimes, gpuTimes, pickTimes);
+
+		Engine::Shutdown(true);
+	}
+
+	void Headless::WriteResults(
+		const vector<double>& cpuTimes,
+		const vector<double>& gpuTimes,
+		const vector<double>& pickTimes)
+	{
+		auto WriteArray = [](ofstream& file, const vector<double>& values)
+			{
+				file << "[";
+				for (size_t i = 0; i < values.size(); i++)
+				{
+					if (i > 0) file << ",";
+					file << to_string(values[i]);
+				}
+				file << "]";
+			};
+
+		//quotes, backslashes and control characters would otherwise end or break the json string
+		auto EscapeString = [](const string& value)
+			{
+				string escaped;
+				escaped.reserve(value.size());
+				for (char c : value)
+				{
+					switch (c)
+					{
+					case '"': escaped += "\\\""; break;
+					case '\\': escaped += "\\\\"; break;
+					case '\n': escaped += "\\n"; break;
+					case '\r': escaped += "\\r"; break;
+					case '\t': escaped += "\\t"; break;
+					default:
+						if (static_cast<unsigned char>(c) < 0x20)
+						{
+							char code[7];
+							snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+							escaped += code;
+						}
+						else escaped += c;
+					}
+				}
+				return escaped;
+			};
+
+		auto WriteStatistics = [](ofstream& file, vector<double> values)
+			{
+				if (values.empty())
+				{
+					file << "{}";
+					return;
+				}
+
+				sort(values.begin(), values.end());
+				auto Percentile = [&values](double percentile)
+					{
+						size_t index = static_cast<size_t>(percentile / 100.0 * static_cast<double>(values.size() - 1) + 0.5);
+						return values[min(index, values.size() - 1)];
+					};
+
+				double sum = 0.0;
+				for (double value : values) sum += value;
+
+				file
+					<< "{\"mean\":" << to_string(sum / static_cast<double>(values.size()))
+					<< ",\"min\":" << to_string(values.front())
+					<< ",\"p50\":" << to_string(Percentile(50.0))
+					<< ",\"p90\":" << to_string(Percentile(90.0))
+					<< ",\"p95\":" << to_string(Percentile(95.0))
+					<< ",\"p99\":" << to_string(Percentile(99.0))
+					<< ",\"max\":" << to_string(values.back())
+					<< "}";
+			};
+
+		string filePath = outputPath.empty()
+			? Engine::docsPath + "\\benchmark_results.json"
+			: outputPath;
+
+		ofstream resultsFile(filePath);
+		if (!resultsFile.is_open())
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Failed to open benchmark results file '" + filePath + "'!\n");
+			return;
+		}
+
+		const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+		const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+
+		resultsFile << "{\n";
+		resultsFile << "\"scene\":\"" << EscapeString(scenePath) << "\",\n";
+		resultsFile << "\"renderer\":\"" << EscapeString(renderer ? renderer : "unknown") << "\",\n";
+		resultsFile << "\"vendor\":\"" << EscapeString(vendor ? vendor : "unknown") << "\",\n";
+		resultsFile << "\"width\":" << width << ",\n";
+		resultsFile << "\"height\":" << height << ",\n";
+		resultsFile << "\"frames\":" << cpuTimes.size() << ",\n";
+		resultsFile << "\"warmupFrames\":" << warmupFrames << ",\n";
+		resultsFile << "\"objects\":" << GameObjectManager::GetObjects().size() << ",\n";
+		resultsFile << "\"center_rgba\":["
+			<< static_cast<int>(centerPixel[0]) << ","
+			<< static_cast<int>(centerPixel[1]) << ","
+			<< static_cast<int>(centerPixel[2]) << ","
+			<< static_cast<int>(centerPixel[3]) << "],\n";
+		resultsFile << "\"load_ms\":" << to_string(sceneLoadMilliseconds) << ",\n";
+		resultsFile << "\"cpu_ms\":";
+		WriteStatistics(resultsFile, cpuTimes);
+		resultsFile << ",\n\"gpu_ms\":";
+		WriteStatistics(resultsFile, gpuTimes);
+		resultsFile << ",\n\"pick_ms\":";
+		WriteStatistics(resultsFile, pickTimes);
+		resultsFile << ",\n\"frame_cpu_ms\":";
+		WriteArray(resultsFile, cpuTimes);
+		resultsFile << ",\n\"frame_gpu_ms\":";
+		WriteArray(resultsFile, gpuTimes);
+		resultsFile << "\n}\n";
+		resultsFile.close();
+
+		ConsoleManager::WriteConsoleMessage(
+			Caller::FILE,
+			Type::INFO,
+			"Wrote headless benchmark results to '" + filePath + "'.\n");
+	}
+}
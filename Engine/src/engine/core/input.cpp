@@ -635,7 +635,7 @@ namespace Core
 
         if (Render::camera.cameraEnabled)
         {
-            float moveSpeedMultiplier = stof(ConfigFile::GetValue("camera_speedMultiplier"));
+            float moveSpeedMultiplier = ConfigFile::GetFloat("camera_speedMultiplier");
 
             bool isLeftShiftPressed;
 #if ENGINE_MODE
@@ -738,7 +738,7 @@ namespace Core
         {
             float yoffset = ImGui::GetIO().MouseWheel;
             float combinedOffset = increment * static_cast<float>(yoffset);
-            float currentSpeed = stof(ConfigFile::GetValue("camera_speedMultiplier"));
+            float currentSpeed = ConfigFile::GetFloat("camera_speedMultiplier");
             float newSpeed = currentSpeed + currentSpeed * combinedOffset;
 
             if (newSpeed > 100.0f) newSpeed = 100.0f;
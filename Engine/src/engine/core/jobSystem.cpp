@@ -0,0 +1,265 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <string>
+
+//engine
+#include "jobSystem.hpp"
+#include "console.hpp"
+#include "renderDamage.hpp"
+
+using std::lock_guard;
+using std::unique_lock;
+using std::make_unique;
+using std::make_shared;
+using std::move;
+using std::to_string;
+using std::memory_order_acq_rel;
+using std::this_thread::yield;
+using std::this_thread::get_id;
+
+using Caller = Core::ConsoleManager::Caller;
+using Type = Core::ConsoleManager::Type;
+using Graphics::RenderDamage;
+
+namespace Core
+{
+	//index of the queue owned by the current worker thread, -1 on every other thread
+	static thread_local int workerIndex = -1;
+
+	void JobSystem::Initialize(unsigned int workerCount)
+	{
+		mainThreadID = get_id();
+		isCancelled = false;
+
+		if (workerCount == 0)
+		{
+			unsigned int coreCount = thread::hardware_concurrency();
+			workerCount = coreCount > 1 ? coreCount - 1 : 1;
+		}
+
+		queues.clear();
+		for (unsigned int i = 0; i < workerCount + 1; i++)
+		{
+			queues.push_back(make_unique<WorkQueue>());
+		}
+
+		isRunning = true;
+		for (unsigned int i = 0; i < workerCount; i++)
+		{
+			workers.emplace_back(WorkerLoop, i);
+		}
+
+		ConsoleManager::WriteConsoleMessage(
+			Caller::INITIALIZE,
+			Type::DEBUG,
+			"Started job system with " + to_string(workerCount) + " workers.\n");
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (!isRunning) return;
+
+		isCancelled = true;
+		{
+			//a long job can be stuck in a blocking call on an external process,
+			//its cancel callback ends that process so the join below returns
+			lock_guard<mutex> lock(longJobMutex);
+			for (LongJob& longJob : longJobs)
+			{
+				if (!longJob.isFinished->load()
+					&& longJob.onCancel)
+				{
+					longJob.onCancel();
+				}
+			}
+			for (LongJob& longJob : longJobs)
+			{
+				longJob.worker.join();
+			}
+			longJobs.clear();
+		}
+
+		{
+			lock_guard<mutex> lock(sleepMutex);
+			isRunning = false;
+		}
+		sleepCondition.notify_all();
+
+		for (thread& worker : workers)
+		{
+			if (worker.joinable()) worker.join();
+		}
+		workers.clear();
+
+		lock_guard<mutex> lock(mainThreadMutex);
+		mainThreadJobs.clear();
+	}
+
+	void JobSystem::Run(function<void()> job, JobCounter* counter)
+	{
+		if (counter != nullptr) counter->count.fetch_add(1, memory_order_acq_rel);
+
+		//nothing to hand the job to before initialization or after shutdown
+		if (!isRunning)
+		{
+			Job inlineJob{ move(job), counter };
+			Execute(inlineJob);
+			return;
+		}
+
+		WorkQueue& queue = *queues[GetLocalQueueIndex()];
+		{
+			lock_guard<mutex> lock(queue.queueMutex);
+			queue.jobs.push_back({ move(job), counter });
+		}
+
+		//taking the sleep mutex orders this with a worker that is about to sleep
+		{
+			lock_guard<mutex> lock(sleepMutex);
+			queuedJobs++;
+		}
+		sleepCondition.notify_one();
+	}
+
+	void JobSystem::RunLongJob(function<void()> job, function<void()> onCancel)
+	{
+		lock_guard<mutex> lock(longJobMutex);
+
+		//threads of long jobs that already returned are joined before a new one starts
+		for (auto it = longJobs.begin(); it != longJobs.end();)
+		{
+			if (it->isFinished->load())
+			{
+				it->worker.join();
+				it = longJobs.erase(it);
+			}
+			else ++it;
+		}
+
+		shared_ptr<atomic<bool>> isFinished = make_shared<atomic<bool>>(false);
+		thread worker([task = move(job), isFinished]()
+			{
+				task();
+				isFinished->store(true);
+			});
+		longJobs.push_back({ move(worker), isFinished, move(onCancel) });
+	}
+
+	void JobSystem::RunOnMainThread(function<void()> job, JobCounter* counter)
+	{
+		if (counter != nullptr) counter->count.fetch_add(1, memory_order_acq_rel);
+
+		if (IsMainThread())
+		{
+			Job inlineJob{ move(job), counter };
+			Execute(inlineJob);
+			return;
+		}
+
+		{
+			lock_guard<mutex> lock(mainThreadMutex);
+			mainThreadJobs.push_back({ move(job), counter });
+		}
+		RenderDamage::WakeMainThread();
+	}
+
+	void JobSystem::ExecuteMainThreadJobs()
+	{
+		vector<Job> jobs;
+		{
+			lock_guard<mutex> lock(mainThreadMutex);
+			if (mainThreadJobs.empty()) return;
+			jobs.swap(mainThreadJobs);
+		}
+
+		for (Job& job : jobs)
+		{
+			Execute(job);
+		}
+	}
+
+	void JobSystem::Wait(const JobCounter& counter)
+	{
+		size_t index = GetLocalQueueIndex();
+		while (!counter.IsDone())
+		{
+			//jobs may be waiting on main thread work, which would never run while the main thread waits
+			if (IsMainThread()) ExecuteMainThreadJobs();
+
+			if (!TryRunJob(index)) yield();
+		}
+	}
+
+	void JobSystem::WorkerLoop(unsigned int index)
+	{
+		workerIndex = static_cast<int>(index);
+
+		while (true)
+		{
+			if (TryRunJob(index)) continue;
+
+			unique_lock<mutex> lock(sleepMutex);
+			sleepCondition.wait(lock, []() { return queuedJobs > 0 || !isRunning; });
+
+			//queued jobs are still finished before the worker exits
+			if (!isRunning
+				&& queuedJobs == 0)
+			{
+				break;
+			}
+		}
+	}
+
+	bool JobSystem::TryRunJob(size_t index)
+	{
+		Job job;
+		bool found = false;
+
+		//newest job from the own queue first, its data is most likely still in cache
+		{
+			WorkQueue& queue = *queues[index];
+			lock_guard<mutex> lock(queue.queueMutex);
+			if (!queue.jobs.empty())
+			{
+				job = move(queue.jobs.back());
+				queue.jobs.pop_back();
+				found = true;
+			}
+		}
+
+		//otherwise steal the oldest job of another queue, starting from the neighbour to spread thieves out
+		for (size_t i = 1; !found && i < queues.size(); i++)
+		{
+			WorkQueue& queue = *queues[(index + i) % queues.size()];
+			lock_guard<mutex> lock(queue.queueMutex);
+			if (!queue.jobs.empty())
+			{
+				job = move(queue.jobs.front());
+				queue.jobs.pop_front();
+				found = true;
+			}
+		}
+
+		if (!found) return false;
+
+		queuedJobs--;
+		Execute(job);
+		return true;
+	}
+
+	void JobSystem::Execute(Job& job)
+	{
+		job.task();
+		if (job.counter != nullptr) job.counter->count.fetch_sub(1, memory_order_acq_rel);
+	}
+
+	size_t JobSystem::GetLocalQueueIndex()
+	{
+		return workerIndex >= 0
+			? static_cast<size_t>(workerIndex)
+			: queues.size() - 1;
+	}
+}
@@ -0,0 +1,239 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <fstream>
+#include <algorithm>
+
+//external
+#include "glad.h"
+
+//engine
+#include "profiler.hpp"
+#include "console.hpp"
+
+using std::ofstream;
+using std::min;
+using std::max;
+using std::to_string;
+using std::chrono::duration;
+using std::milli;
+
+using Caller = Core::ConsoleManager::Caller;
+using Type = Core::ConsoleManager::Type;
+
+namespace Core
+{
+	double Profiler::GetTimeMilliseconds()
+	{
+		return duration<double, milli>(high_resolution_clock::now() - epoch).count();
+	}
+
+	ProfileFrame& Profiler::CurrentFrame()
+	{
+		return isFrameActive
+			? pendingFrames[frameIndex % frameLatency]
+			: looseFrame;
+	}
+
+	void Profiler::BeginFrame()
+	{
+		if (isClearRequested)
+		{
+			isClearRequested = false;
+			history.clear();
+			for (auto& frame : pendingFrames)
+			{
+				frame.zones.clear();
+				frame.usedQueries = 0;
+			}
+			looseFrame.zones.clear();
+		}
+
+		if (!isEnabled) return;
+
+		//this slot was last used frameLatency frames ago, so its gpu results are ready
+		ProfileFrame& frame = pendingFrames[frameIndex % frameLatency];
+		if (!frame.zones.empty()) ResolveFrame(frame);
+
+		frame.zones.clear();
+		frame.usedQueries = 0;
+		frame.index = frameIndex;
+		frame.cpuStart = GetTimeMilliseconds();
+		frame.cpuEnd = frame.cpuStart;
+		frame.gpuTime = -1.0;
+
+		openZones.clear();
+		isFrameActive = true;
+	}
+
+	void Profiler::EndFrame()
+	{
+		if (!isFrameActive) return;
+
+		CurrentFrame().cpuEnd = GetTimeMilliseconds();
+		isFrameActive = false;
+		frameIndex++;
+	}
+
+	void Profiler::BeginZone(const char* name, bool measureGPU)
+	{
+		ProfileFrame& frame = CurrentFrame();
+
+		ProfileZoneData zone{};
+		zone.name = name;
+		zone.depth = static_cast<int>(openZones.size());
+		zone.cpuStart = GetTimeMilliseconds();
+		zone.cpuEnd = zone.cpuStart;
+
+		//gpu timings are only taken inside frames where they can be read back later
+		if (measureGPU && isFrameActive) zone.gpuStartQuery = RecordGPUTimestamp(frame);
+
+		if (!isFrameActive && frame.zones.empty()) frame.cpuStart = zone.cpuStart;
+
+		openZones.push_back(static_cast<int>(frame.zones.size()));
+		frame.zones.push_back(zone);
+	}
+
+	void Profiler::EndZone()
+	{
+		if (openZones.empty()) return;
+
+		ProfileFrame& frame = CurrentFrame();
+		ProfileZoneData& zone = frame.zones[openZones.back()];
+		openZones.pop_back();
+
+		zone.cpuEnd = GetTimeMilliseconds();
+		if (zone.gpuStartQuery != -1) zone.gpuEndQuery = RecordGPUTimestamp(frame);
+
+		//zones outside of frames are stored as their own entry once the outermost one ends
+		if (!isFrameActive
+			&& openZones.empty()
+			&& !isPaused)
+		{
+			looseFrame.index = frameIndex;
+			looseFrame.cpuEnd = zone.cpuEnd;
+			looseFrame.gpuTime = -1.0;
+
+			history.push_back(looseFrame);
+			if (history.size() > maxHistory) history.pop_front();
+
+			looseFrame.zones.clear();
+		}
+		else if (!isFrameActive && openZones.empty()) looseFrame.zones.clear();
+	}
+
+	int Profiler::RecordGPUTimestamp(ProfileFrame& frame)
+	{
+		if (frame.usedQueries == static_cast<int>(frame.queryPool.size()))
+		{
+			unsigned int query;
+			glGenQueries(1, &query);
+			frame.queryPool.push_back(query);
+		}
+
+		int index = frame.usedQueries++;
+		//timestamps are used instead of GL_TIME_ELAPSED because elapsed queries cannot be nested
+		glQueryCounter(frame.queryPool[index], GL_TIMESTAMP);
+		return index;
+	}
+
+	void Profiler::ResolveFrame(ProfileFrame& frame)
+	{
+		if (frame.usedQueries > 0)
+		{
+			vector<GLuint64> timestamps(frame.usedQueries);
+			for (int i = 0; i < frame.usedQueries; i++)
+			{
+				glGetQueryObjectui64v(frame.queryPool[i], GL_QUERY_RESULT, &timestamps[i]);
+			}
+
+			//gpu clock has its own epoch, so gpu zones are aligned to the cpu start of the first gpu zone
+			const ProfileZoneData* firstZone = nullptr;
+			for (const auto& zone : frame.zones)
+			{
+				if (zone.gpuStartQuery != -1)
+				{
+					firstZone = &zone;
+					break;
+				}
+			}
+
+			GLuint64 base = timestamps[firstZone->gpuStartQuery];
+			double alignedBase = firstZone->cpuStart;
+			double gpuEnd = alignedBase;
+			for (auto& zone : frame.zones)
+			{
+				if (zone.gpuStartQuery == -1
+					|| zone.gpuEndQuery == -1)
+				{
+					continue;
+				}
+
+				zone.gpuStart = alignedBase + static_cast<double>(timestamps[zone.gpuStartQuery] - base) / 1000000.0;
+				zone.gpuEnd = alignedBase + static_cast<double>(timestamps[zone.gpuEndQuery] - base) / 1000000.0;
+				gpuEnd = max(gpuEnd, zone.gpuEnd);
+			}
+			frame.gpuTime = gpuEnd - alignedBase;
+		}
+
+		if (isPaused) return;
+
+		history.push_back(frame);
+		history.back().queryPool.clear();
+		if (history.size() > maxHistory) history.pop_front();
+	}
+
+	void Profiler::ClearHistory()
+	{
+		//called from the gui in the middle of a frame, the open zones still need their frame
+		history.clear();
+		isClearRequested = true;
+	}
+
+	bool Profiler::ExportChromeTrace(const string& filePath)
+	{
+		ofstream traceFile(filePath);
+		if (!traceFile.is_open())
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Failed to open profiler trace file '" + filePath + "' for writing!\n");
+			return false;
+		}
+
+		traceFile << "{\"traceEvents\":[\n";
+		traceFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+		traceFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+		//trace event timestamps and durations are in microseconds
+		auto WriteEvent = [&traceFile](const char* name, int tid, double start, double end)
+			{
+				traceFile
+					<< ",\n{\"name\":\"" << name
+					<< "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+					<< ",\"ts\":" << to_string(start * 1000.0)
+					<< ",\"dur\":" << to_string((end - start) * 1000.0) << "}";
+			};
+
+		for (const auto& frame : history)
+		{
+			for (const auto& zone : frame.zones)
+			{
+				WriteEvent(zone.name, 1, zone.cpuStart, zone.cpuEnd);
+				if (zone.gpuStart >= 0.0) WriteEvent(zone.name, 2, zone.gpuStart, zone.gpuEnd);
+			}
+		}
+
+		traceFile << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		traceFile.close();
+
+		ConsoleManager::WriteConsoleMessage(
+			Caller::FILE,
+			Type::INFO,
+			"Exported " + to_string(history.size()) + " profiled frames to '" + filePath + "'.\n");
+		return true;
+	}
+}
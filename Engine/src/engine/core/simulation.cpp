@@ -0,0 +1,75 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+
+//engine
+#include "simulation.hpp"
+#include "gameobject.hpp"
+#include "renderDamage.hpp"
+#include "profiler.hpp"
+
+using std::min;
+using std::shared_ptr;
+
+using Graphics::Shape::GameObjectManager;
+using Graphics::Shape::GameObject;
+using Graphics::RenderDamage;
+
+namespace Core
+{
+	void Simulation::AddFixedUpdate(const function<void(double)>& callback)
+	{
+		fixedUpdates.push_back(callback);
+	}
+
+	void Simulation::AddUpdate(const function<void(double)>& callback)
+	{
+		updates.push_back(callback);
+	}
+
+	void Simulation::Update(double deltaTime)
+	{
+		ProfileZone simulationZone("Simulation::Update");
+
+		if (!fixedUpdates.empty())
+		{
+			accumulator = min(accumulator + deltaTime, fixedDeltaTime * maxStepsPerFrame);
+
+			while (accumulator >= fixedDeltaTime)
+			{
+				StorePreviousStates();
+
+				isInFixedStep = true;
+				for (const auto& fixedUpdate : fixedUpdates)
+				{
+					fixedUpdate(fixedDeltaTime);
+				}
+				isInFixedStep = false;
+
+				accumulator -= fixedDeltaTime;
+				stepCount++;
+			}
+
+			interpolationAlpha = static_cast<float>(accumulator / fixedDeltaTime);
+
+			//interpolated frames differ even when no step ran
+			RenderDamage::MarkScene();
+		}
+
+		for (const auto& update : updates)
+		{
+			update(deltaTime);
+		}
+	}
+
+	void Simulation::StorePreviousStates()
+	{
+		for (const shared_ptr<GameObject>& obj : GameObjectManager::GetObjects())
+		{
+			obj->GetTransform()->StorePreviousState();
+		}
+	}
+}
@@ -17,7 +17,6 @@ using std::cout;
 using std::to_string;
 using std::chrono::milliseconds;
 using std::this_thread::sleep_for;
-using std::min;
 
 namespace Core
 {
@@ -42,12 +41,9 @@ namespace Core
         duration<double> frame_duration = current_time - last_frame_time;
         last_frame_time = current_time;
 
-        double uncappedDeltaTime = frame_duration.count();
-
-        const double targetFPS = 60.0;
-        const double targetFrameTime = 1.0 / targetFPS;
-
-        deltaTime = min(uncappedDeltaTime, targetFrameTime);
+        //not clamped, slow frames take proportionally longer steps
+        //so that movement speed does not depend on the framerate
+        deltaTime = frame_duration.count();
 
         smoothed_frame_count++;
 
@@ -65,4 +61,9 @@ namespace Core
             last_smoothed_update = current_time;
         }
 	}
+
+    void TimeManager::SkipIdleTime()
+    {
+        last_frame_time = high_resolution_clock::now();
+    }
 }
\ No newline at end of file
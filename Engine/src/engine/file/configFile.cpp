@@ -19,6 +19,7 @@
 #include "sceneFile.hpp"
 #include "render.hpp"
 #include "stringUtils.hpp"
+#include "renderDamage.hpp"
 #if ENGINE_MODE
 #include "gui_settings.hpp"
 #endif
@@ -36,6 +37,7 @@ using Type = Core::ConsoleManager::Type;
 using Utils::File;
 using Graphics::Render;
 using Utils::String;
+using Graphics::RenderDamage;
 #if ENGINE_MODE
 using Graphics::GUI::GUISettings;
 #endif
@@ -75,11 +77,7 @@ namespace EngineFile
 				return;
 			}
 
-			keys.clear();
-			values.clear();
-
 			string line;
-			map<string, string> configValue;
 			while (getline(configFile, line))
 			{
 				if (!line.empty()
@@ -102,13 +100,25 @@ namespace EngineFile
 						}
 					}
 
-					keys.push_back(key);
-					values.push_back(value);
+					AssignValue(key, value);
 				}
 			}
 
 			configFile.close();
 
+			//config files from older versions dont have the newer keys yet
+			vector<string> defaultKeys;
+			vector<string> defaultValues;
+			GetDefaultValues(defaultKeys, defaultValues);
+			for (size_t i = 0; i < defaultKeys.size(); i++)
+			{
+				if (values.find(defaultKeys[i]) == values.end()
+					|| placeholderKeys.contains(defaultKeys[i]))
+				{
+					AssignValue(defaultKeys[i], defaultValues[i]);
+				}
+			}
+
 			ConsoleManager::WriteConsoleMessage(
 				Caller::FILE,
 				Type::DEBUG,
@@ -134,12 +144,9 @@ namespace EngineFile
 			return;
 		}
 
-		for (int i = 0; i < keys.size(); i++)
+		for (const string& key : keys)
 		{
-			string key = keys[i];
-			string value = values[i];
-
-			configFile << key << "= " << value << "\n";
+			configFile << key << "= " << values[key].stringValue << "\n";
 		}
 
 		configFile.close();
@@ -154,19 +161,11 @@ namespace EngineFile
 
 	string ConfigFile::GetValue(const string& key, bool silent)
 	{
-		int keyIndex = -1;
-		for (int i = 0; i < keys.size(); i++)
-		{
-			if (keys[i] == key)
-			{
-				keyIndex = i;
-				break;
-			}
-		}
-
-		if (keyIndex != -1)
+		auto it = values.find(key);
+		if (it != values.end()
+			&& !placeholderKeys.contains(key))
 		{
-			return values[keyIndex];
+			return it->second.stringValue;
 		}
 		else 
 		{
@@ -183,23 +182,20 @@ namespace EngineFile
 
 	void ConfigFile::SetValue(const string& key, const string& value)
 	{
-		int keyIndex = -1;
-		for (int i = 0; i < keys.size(); i++)
+		auto it = values.find(key);
+		if (it != values.end()
+			&& !placeholderKeys.contains(key))
 		{
-			if (keys[i] == key)
-			{
-				keyIndex = i;
-				break;
-			}
-		}
-
-		if (keyIndex != -1)
-		{
-			values[keyIndex] = value;
+			ConfigValue& configValue = AssignValue(key, value);
+			RenderDamage::MarkScene();
 
-			if (key == "gui_fontScale")
+			auto callbackIt = callbacks.find(key);
+			if (callbackIt != callbacks.end())
 			{
-				ImGui::GetIO().FontGlobalScale = stof(value);
+				for (const auto& callback : callbackIt->second)
+				{
+					callback(configValue);
+				}
 			}
 		}
 		else
@@ -211,65 +207,82 @@ namespace EngineFile
 		}
 	}
 
-	void ConfigFile::CreateNewConfigFile()
+	const float& ConfigFile::GetFloat(const string& key) { return FindValue(key).floatValue; }
+	const int& ConfigFile::GetInt(const string& key) { return FindValue(key).intValue; }
+	const bool& ConfigFile::GetBool(const string& key) { return FindValue(key).boolValue; }
+	const vec3& ConfigFile::GetVec3(const string& key) { return FindValue(key).vec3Value; }
+
+	void ConfigFile::AddChangeCallback(const string& key, const function<void(const ConfigValue&)>& callback)
 	{
-		if (configFilePath == "") configFilePath = Engine::docsPath + "\\config.txt";
+		callbacks[key].push_back(callback);
+	}
 
-		keys.clear();
-		values.clear();
+	const ConfigValue& ConfigFile::FindValue(const string& key)
+	{
+		auto it = values.find(key);
+		if (it != values.end()) return it->second;
 
-#if ENGINE_MODE
-		/*
-		* 
-		* DISABLED FOR NOW
-		* WILL BE UPDATED IN A FUTURE VERSION
-		* 
-		keys.push_back("firstUse");
-			values.push_back("1");
-		*/
+		ConsoleManager::WriteConsoleMessage(
+			Caller::FILE,
+			Type::EXCEPTION,
+			"Error: Cannot get config key " + key + " value because it does not exist!\n");
 
-		keys.push_back("gameName");
-			values.push_back("Game");
-#endif
-		keys.push_back("gui_fontScale");
-			values.push_back("1.5");
-
-		keys.push_back("window_vsync");
-			values.push_back("1");
-
-		keys.push_back("aspect_ratio");
-			values.push_back("1");
-
-		keys.push_back("camera_speedMultiplier");
-			values.push_back("1.0");
-		keys.push_back("camera_fov");
-			values.push_back("90.0");
-		keys.push_back("camera_nearClip");
-			values.push_back("0.001");
-		keys.push_back("camera_farClip");
-			values.push_back("200.0");
-#if ENGINE_MODE
-		keys.push_back("grid_color");
-			values.push_back("0.4, 0.4, 0.4");
-		keys.push_back("grid_transparency");
-			values.push_back("0.25");
-		keys.push_back("grid_maxDistance");
-			values.push_back("50.0");
-
-		keys.push_back("gui_sceneWindow");
-			values.push_back("1");
-		keys.push_back("gui_inspector");
-			values.push_back("1");
-		keys.push_back("gui_sceneHierarchy");
-			values.push_back("1");
-		keys.push_back("gui_projectHierarchy");
-			values.push_back("1");
-		keys.push_back("gui_console");
-			values.push_back("1");
-		keys.push_back("gui_firstTime");
-			values.push_back("0");
-#endif
+		//callers keep the returned reference, so the placeholder is the entry the key is later loaded into
+		placeholderKeys.insert(key);
+		return values.emplace(key, ConfigValue()).first->second;
+	}
+
+	ConfigValue& ConfigFile::AssignValue(const string& key, const string& value)
+	{
+		auto it = values.find(key);
+		if (it == values.end())
+		{
+			keys.push_back(key);
+			it = values.emplace(key, ConfigValue()).first;
+		}
+		else if (placeholderKeys.erase(key) > 0) keys.push_back(key);
+
+		ConfigValue& configValue = it->second;
+		configValue.stringValue = value;
+
+		//strtof is used instead of stof so that non-numeric values like gameName dont throw
+		auto ParseFloat = [](const string& text, float& result)
+			{
+				if (text.empty()) return false;
+				char* end = nullptr;
+				result = strtof(text.c_str(), &end);
+				return *end == '\0';
+			};
+
+		//single number values
+		float parsedFloat = 0.0f;
+		configValue.floatValue = ParseFloat(value, parsedFloat) ? parsedFloat : 0.0f;
+		configValue.intValue = static_cast<int>(configValue.floatValue);
+		configValue.boolValue = configValue.intValue != 0
+			|| value == "true";
+
+		//comma separated values are read as vec3, single values fill all three components
+		vector<string> splitValue = String::Split(value, ',');
+		vec3 parsedVec3{};
+		if (splitValue.size() == 3
+			&& ParseFloat(splitValue[0], parsedVec3.x)
+			&& ParseFloat(splitValue[1], parsedVec3.y)
+			&& ParseFloat(splitValue[2], parsedVec3.z))
+		{
+			configValue.vec3Value = parsedVec3;
+		}
+		else configValue.vec3Value = vec3(configValue.floatValue);
 
+		return configValue;
+	}
+
+	void ConfigFile::CreateNewConfigFile()
+	{
+		if (configFilePath == "") configFilePath = Engine::docsPath + "\\config.txt";
+
+		vector<string> defaultKeys;
+		vector<string> defaultValues;
+		GetDefaultValues(defaultKeys, defaultValues);
 
 		ofstream configFile(configFilePath);
 
@@ -282,16 +295,89 @@ namespace EngineFile
 			return;
 		}
 
-		for (int i = 0; i < keys.size(); i++)
+		for (size_t i = 0; i < defaultKeys.size(); i++)
 		{
-			string key = keys[i];
-			string value = values[i];
-
-			configFile << key << "= " << value << "\n";
+			configFile << defaultKeys[i] << "= " << defaultValues[i] << "\n";
 		}
 
 		configFile.close();
 
 		LoadConfigFile();
 	}
+
+	void ConfigFile::GetDefaultValues(vector<string>& defaultKeys, vector<string>& defaultValues)
+	{
+#if ENGINE_MODE
+		/*
+		* 
+		* DISABLED FOR NOW
+		* WILL BE UPDATED IN A FUTURE VERSION
+		* 
+		defaultKeys.push_back("firstUse");
+			defaultValues.push_back("1");
+		*/
+
+		defaultKeys.push_back("gameName");
+			defaultValues.push_back("Game");
+#endif
+		defaultKeys.push_back("gui_fontScale");
+			defaultValues.push_back("1.5");
+
+		defaultKeys.push_back("window_vsync");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("window_targetFPS");
+			defaultValues.push_back("0");
+#if ENGINE_MODE
+		defaultKeys.push_back("window_renderOnDemand");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("window_unfocusedFPS");
+			defaultValues.push_back("10");
+#endif
+
+		defaultKeys.push_back("graphics_depthPrepass");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("graphics_occlusionCulling");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("graphics_renderScale");
+			defaultValues.push_back("1.0");
+		defaultKeys.push_back("graphics_dynamicResolution");
+			defaultValues.push_back("0");
+		defaultKeys.push_back("graphics_gpuBudget");
+			defaultValues.push_back("14.0");
+		defaultKeys.push_back("graphics_upscaleSharpness");
+			defaultValues.push_back("0.3");
+
+		defaultKeys.push_back("aspect_ratio");
+			defaultValues.push_back("1");
+
+		defaultKeys.push_back("camera_speedMultiplier");
+			defaultValues.push_back("1.0");
+		defaultKeys.push_back("camera_fov");
+			defaultValues.push_back("90.0");
+		defaultKeys.push_back("camera_nearClip");
+			defaultValues.push_back("0.001");
+		defaultKeys.push_back("camera_farClip");
+			defaultValues.push_back("200.0");
+#if ENGINE_MODE
+		defaultKeys.push_back("grid_color");
+			defaultValues.push_back("0.4, 0.4, 0.4");
+		defaultKeys.push_back("grid_transparency");
+			defaultValues.push_back("0.25");
+		defaultKeys.push_back("grid_maxDistance");
+			defaultValues.push_back("50.0");
+
+		defaultKeys.push_back("gui_sceneWindow");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("gui_inspector");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("gui_sceneHierarchy");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("gui_projectHierarchy");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("gui_console");
+			defaultValues.push_back("1");
+		defaultKeys.push_back("gui_firstTime");
+			defaultValues.push_back("0");
+#endif
+	}
 }
\ No newline at end of file
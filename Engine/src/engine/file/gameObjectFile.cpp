@@ -7,6 +7,7 @@
 #include <filesystem>
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <vector>
 
@@ -28,7 +29,9 @@
 #include "selectobject.hpp"
 #include "gameobject.hpp"
 #include "texture.hpp"
+#include "profiler.hpp"
 #include "gameobject.hpp"
+#include "staticBatchFile.hpp"
 #if ENGINE_MODE
 #include "gui_scenewindow.hpp"
 #endif
@@ -48,6 +51,7 @@ using std::to_string;
 using std::unordered_map;
 using std::shared_ptr;
 using std::vector;
+using std::unordered_set;
 
 using Core::Engine;
 using Core::ConsoleManager;
@@ -67,6 +71,7 @@ using Graphics::Shape::GameObject;
 using Graphics::Shape::GameObjectManager;
 using Graphics::Texture;
 using Graphics::Shader;
+using Core::ProfileZone;
 using Graphics::Shape::GameObject;
 #if ENGINE_MODE
 using Graphics::GUI::GUISceneWindow;
@@ -76,6 +81,8 @@ namespace EngineFile
 {
 	void GameObjectFile::SaveGameObjects()
 	{
+		ProfileZone saveZone("GameObjectFile::SaveGameObjects");
+
 		for (const auto& obj : GameObjectManager::GetObjects())
 		{
 			if (obj->GetParentBillboardHolder() == nullptr)
@@ -170,6 +177,10 @@ namespace EngineFile
 				if (meshType == Mesh::MeshType::model)
 				{
 					data.push_back("shininess= " + to_string(obj->GetBasicShape()->GetShininess()) + "\n");
+
+					data.push_back("occluder= " + to_string(obj->GetMesh()->IsOccluder()) + "\n");
+
+					data.push_back("static= " + to_string(obj->IsStatic()) + "\n");
 				}
 				else if (meshType == Mesh::MeshType::point_light)
 				{
@@ -310,8 +321,47 @@ namespace EngineFile
 		return "";
 	}
 
+	bool GameObjectFile::ReadKeyValues(const string& file, unordered_map<string, string>& data)
+	{
+		ifstream txtFile(file);
+		if (!txtFile.is_open()) return false;
+
+		string line;
+		while (getline(txtFile, line))
+		{
+			if (!line.empty()
+				&& line.find("=") != string::npos)
+			{
+				vector<string> splitLine = String::Split(line, '=');
+				string key = splitLine[0];
+				string value = splitLine.size() > 1 ? splitLine[1] : "";
+
+				//remove one space in front of value if it exists
+				if (!value.empty() && value[0] == ' ') value.erase(0, 1);
+				//remove one space in front of each value comma if it exists
+				for (size_t i = 0; i < value.length(); i++)
+				{
+					if (value[i] == ','
+						&& i + 1 < value.length()
+						&& value[i + 1] == ' ')
+					{
+						value.erase(i + 1, 1);
+					}
+				}
+
+				data[key] = value;
+			}
+		}
+
+		txtFile.close();
+
+		return true;
+	}
+
 	void GameObjectFile::LoadGameObjects()
 	{
+		ProfileZone loadZone("GameObjectFile::LoadGameObjects");
+
 		if (Engine::currentGameobjectsPath.empty())
 		{
 			ConsoleManager::WriteConsoleMessage(
@@ -332,16 +382,22 @@ namespace EngineFile
 		vector<string> validAssimpPaths;
 		vector<string> validGameobjectPaths;
 
+		//static models that were merged by the game build are created from the batch file instead
+		unordered_set<string> batchedFolders = StaticBatchFile::LoadBatches(path(Engine::scenePath).parent_path().string());
+
 		//look through parent gameobjects folder
 		for (const auto& folder : directory_iterator(Engine::currentGameobjectsPath))
 		{
+			bool isBatched = batchedFolders.find(path(folder).filename().string()) != batchedFolders.end();
+
 			//look for assimp model files (fbx, glfw, obj)
 			for (const auto& file : directory_iterator(folder))
 			{
 				string extension = path(file).extension().string();
-				if (extension == ".fbx"
+				if (!isBatched
+					&& (extension == ".fbx"
 					|| extension == ".obj"
-					|| extension == ".glfw")
+					|| extension == ".glfw"))
 				{
 					validAssimpPaths.push_back(path(file).string());
 				}
@@ -401,6 +457,8 @@ namespace EngineFile
 				LoadDirectionalLight(filePath);
 			}
 		}
+
+		StaticBatchFile::CreateBatchModels();
 #if ENGINE_MODE
 		GUISceneWindow::waitBeforeCountsUpdate = false;
 		GUISceneWindow::UpdateCounts();
@@ -421,8 +479,8 @@ namespace EngineFile
 		// READ FROM MODEL FILE
 		//
 
-		ifstream txtFile(txtFilePath);
-		if (!txtFile.is_open())
+		unordered_map<string, string> data;
+		if (!ReadKeyValues(txtFilePath, data))
 		{
 			ConsoleManager::WriteConsoleMessage(
 				Caller::FILE,
@@ -431,51 +489,6 @@ namespace EngineFile
 			return;
 		}
 
-		unordered_map<string, string> data;
-		string line;
-		while (getline(txtFile, line))
-		{
-			if (!line.empty()
-				&& line.find("=") != string::npos)
-			{
-				vector<string> splitLine = String::Split(line, '=');
-				string key = splitLine[0];
-				string value = splitLine[1];
-
-				//remove one space in front of value if it exists
-				if (value[0] == ' ') value.erase(0, 1);
-				//remove one space in front of each value comma if it exists
-				for (size_t i = 0; i < value.length(); i++)
-				{
-					if (value[i] == ','
-						&& i + 1 < value.length()
-						&& value[i + 1] == ' ')
-					{
-						value.erase(i + 1, 1);
-					}
-				}
-
-				if (key == "name"
-					|| key == "id"
-					|| key == "enabled"
-					|| key == "mesh enabled"
-					|| key == "type"
-					|| key == "position"
-					|| key == "rotation"
-					|| key == "scale"
-
-					|| key == "textures"
-					|| key == "shaders"
-					|| key == "model"
-					|| key == "shininess")
-				{
-					data[key] = value;
-				}
-			}
-		}
-
-		txtFile.close();
-
 		//
 		// ASSIGN MODEL DATA TO VARIABLES
 		//
@@ -493,6 +506,8 @@ namespace EngineFile
 		vector<string> shaders{};
 		string model{};
 		float shininess{};
+		bool isOccluder{};
+		bool isStatic{};
 
 		for (const auto& [key, value] : data)
 		{
@@ -640,6 +655,14 @@ namespace EngineFile
 			{
 				shininess = stof(value);
 			}
+			else if (key == "occluder")
+			{
+				isOccluder = stoi(value);
+			}
+			else if (key == "static")
+			{
+				isStatic = stoi(value);
+			}
 		}
 
 		//
@@ -737,6 +760,8 @@ namespace EngineFile
 			Texture::LoadTexture(foundObj, heightTexture, Material::TextureType::normal, false);
 
 			foundObj->GetBasicShape()->SetShininess(shininess);
+			foundObj->GetMesh()->SetOccluder(isOccluder);
+			foundObj->SetStatic(isStatic);
 
 			GameObject::nextID = ID + 1;
 		}
@@ -748,8 +773,8 @@ namespace EngineFile
 		// READ FROM POINT LIGHT FILE
 		//
 
-		ifstream pointLightFile(file);
-		if (!pointLightFile.is_open())
+		unordered_map<string, string> data;
+		if (!ReadKeyValues(file, data))
 		{
 			ConsoleManager::WriteConsoleMessage(
 				Caller::FILE,
@@ -758,60 +783,6 @@ namespace EngineFile
 			return;
 		}
 
-		unordered_map<string, string> data;
-		string line;
-		while (getline(pointLightFile, line))
-		{
-			if (!line.empty()
-				&& line.find("=") != string::npos)
-			{
-				vector<string> splitLine = String::Split(line, '=');
-				string key = splitLine[0];
-				string value = splitLine[1];
-
-				//remove one space in front of value if it exists
-				if (value[0] == ' ') value.erase(0, 1);
-				//remove one space in front of each value comma if it exists
-				for (size_t i = 0; i < value.length(); i++)
-				{
-					if (value[i] == ','
-						&& i + 1 < value.length()
-						&& value[i + 1] == ' ')
-					{
-						value.erase(i + 1, 1);
-					}
-				}
-
-				if (key == "name"
-					|| key == "id"
-					|| key == "enabled"
-					|| key == "mesh enabled"
-					|| key == "type"
-					|| key == "position"
-					|| key == "rotation"
-					|| key == "scale"
-
-					|| key == "shaders"
-					|| key == "txtFile"
-
-					|| key == "diffuse"
-					|| key == "intensity"
-					|| key == "distance"
-
-					|| key == "billboard name"
-					|| key == "billboard id"
-					|| key == "billboard enabled"
-					|| key == "billboard shaders"
-					|| key == "billboard texture"
-					|| key == "billboard shininess")
-				{
-					data[key] = value;
-				}
-			}
-		}
-
-		pointLightFile.close();
-
 		//
 		// ASSIGN POINT LIGHT DATA TO VARIABLES
 		//
@@ -1011,8 +982,8 @@ namespace EngineFile
 		// READ FROM SPOTLIGHT FILE
 		//
 
-		ifstream spotLightFile(file);
-		if (!spotLightFile.is_open())
+		unordered_map<string, string> data;
+		if (!ReadKeyValues(file, data))
 		{
 			ConsoleManager::WriteConsoleMessage(
 				Caller::FILE,
@@ -1021,62 +992,6 @@ namespace EngineFile
 			return;
 		}
 
-		unordered_map<string, string> data;
-		string line;
-		while (getline(spotLightFile, line))
-		{
-			if (!line.empty()
-				&& line.find("=") != string::npos)
-			{
-				vector<string> splitLine = String::Split(line, '=');
-				string key = splitLine[0];
-				string value = splitLine[1];
-
-				//remove one space in front of value if it exists
-				if (value[0] == ' ') value.erase(0, 1);
-				//remove one space in front of each value comma if it exists
-				for (size_t i = 0; i < value.length(); i++)
-				{
-					if (value[i] == ','
-						&& i + 1 < value.length()
-						&& value[i + 1] == ' ')
-					{
-						value.erase(i + 1, 1);
-					}
-				}
-
-				if (key == "name"
-					|| key == "id"
-					|| key == "enabled"
-					|| key == "mesh enabled"
-					|| key == "type"
-					|| key == "position"
-					|| key == "rotation"
-					|| key == "scale"
-
-					|| key == "shaders"
-					|| key == "txtFile"
-
-					|| key == "diffuse"
-					|| key == "intensity"
-					|| key == "distance"
-					|| key == "inner angle"
-					|| key == "outer angle"
-
-					|| key == "billboard name"
-					|| key == "billboard id"
-					|| key == "billboard enabled"
-					|| key == "billboard shaders"
-					|| key == "billboard texture"
-					|| key == "billboard shininess")
-				{
-					data[key] = value;
-				}
-			}
-		}
-
-		spotLightFile.close();
-
 		//
 		// ASSIGN SPOTLIGHT DATA TO VARIABLES
 		//
@@ -1282,8 +1197,8 @@ namespace EngineFile
 		// READ FROM DIRECTIONAL LIGHT FILE
 		//
 
-		ifstream directionalLightFile(file);
-		if (!directionalLightFile.is_open())
+		unordered_map<string, string> data;
+		if (!ReadKeyValues(file, data))
 		{
 			ConsoleManager::WriteConsoleMessage(
 				Caller::FILE,
@@ -1292,60 +1207,6 @@ namespace EngineFile
 			return;
 		}
 
-		unordered_map<string, string> data;
-		string line;
-		while (getline(directionalLightFile, line))
-		{
-			if (!line.empty()
-				&& line.find("=") != string::npos)
-			{
-				vector<string> splitLine = String::Split(line, '=');
-				string key = splitLine[0];
-				string value = splitLine[1];
-
-				//remove one space in front of value if it exists
-				if (value[0] == ' ') value.erase(0, 1);
-				//remove one space in front of each value comma if it exists
-				for (size_t i = 0; i < value.length(); i++)
-				{
-					if (value[i] == ','
-						&& i + 1 < value.length()
-						&& value[i + 1] == ' ')
-					{
-						value.erase(i + 1, 1);
-					}
-				}
-
-				if (key == "name"
-					|| key == "id"
-					|| key == "enabled"
-					|| key == "mesh enabled"
-					|| key == "type"
-					|| key == "position"
-					|| key == "rotation"
-					|| key == "scale"
-
-					|| key == "shaders"
-					|| key == "txtFile"
-
-					|| key == "diffuse"
-					|| key == "intensity"
-					|| key == "distance"
-
-					|| key == "billboard name"
-					|| key == "billboard id"
-					|| key == "billboard enabled"
-					|| key == "billboard shaders"
-					|| key == "billboard texture"
-					|| key == "billboard shininess")
-				{
-					data[key] = value;
-				}
-			}
-		}
-
-		directionalLightFile.close();
-
 		//
 		// ASSIGN DIRECTIONAL LIGHT DATA TO VARIABLES
 		//
@@ -0,0 +1,430 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+#if ENGINE_MODE
+#include <filesystem>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#elif _WIN32
+#include <Windows.h>
+#endif
+
+//engine
+#include "projectDirectory.hpp"
+#include "console.hpp"
+#include "renderDamage.hpp"
+
+using std::filesystem::path;
+using std::filesystem::directory_iterator;
+using std::filesystem::recursive_directory_iterator;
+using std::filesystem::directory_options;
+using std::filesystem::exists;
+using std::error_code;
+using std::hash;
+using std::move;
+using std::wstring;
+using std::sort;
+using std::unique;
+using std::find_if;
+using std::lock_guard;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+
+using Core::ConsoleManager;
+using Caller = Core::ConsoleManager::Caller;
+using Type = Core::ConsoleManager::Type;
+using Graphics::RenderDamage;
+
+namespace EngineFile
+{
+	void ProjectDirectory::Initialize(const string& rootPath)
+	{
+		Shutdown();
+
+		root = DirectoryEntry();
+		root.fullPath = rootPath;
+		root.name = path(rootPath).filename().string();
+		root.isDirectory = true;
+
+		Rebuild();
+
+		isWatching = true;
+		watcherThread = thread(WatcherLoop);
+	}
+
+	void ProjectDirectory::Update()
+	{
+		vector<string> changed;
+		{
+			lock_guard<mutex> lock(changedMutex);
+			changed.swap(changedDirectories);
+		}
+
+		if (isDirty.exchange(false))
+		{
+			Rebuild();
+			return;
+		}
+		if (changed.empty()) return;
+
+		sort(changed.begin(), changed.end());
+		changed.erase(unique(changed.begin(), changed.end()), changed.end());
+
+		for (const string& changedPath : changed)
+		{
+			DirectoryEntry* directory = FindClosestDirectory(changedPath);
+			if (directory == nullptr)
+			{
+				Rebuild();
+				return;
+			}
+
+			//refreshing moves the entries of the folder, so the lookup is rebuilt from the cached tree
+			RefreshDirectory(*directory);
+			entriesByPath.clear();
+			AddToLookup(root);
+		}
+	}
+
+	void ProjectDirectory::MarkDirty()
+	{
+		isDirty = true;
+	}
+
+	void ProjectDirectory::Shutdown()
+	{
+		isWatching = false;
+		if (watcherThread.joinable()) watcherThread.join();
+	}
+
+	const DirectoryEntry* ProjectDirectory::FindEntry(const string& fullPath)
+	{
+		auto it = entriesByPath.find(NormalizePath(fullPath));
+		return it != entriesByPath.end() ? it->second : nullptr;
+	}
+
+	void ProjectDirectory::Rebuild()
+	{
+		root.children.clear();
+		entriesByPath.clear();
+
+		if (!exists(root.fullPath)) return;
+
+		ReadDirectory(root);
+		AddToLookup(root);
+	}
+
+	void ProjectDirectory::ReadDirectory(DirectoryEntry& directory)
+	{
+		//files can disappear while the tree is read, so errors skip the entry instead of throwing
+		error_code ec;
+		for (const auto& entry : directory_iterator(directory.fullPath, ec))
+		{
+			DirectoryEntry child;
+			child.fullPath = entry.path().string();
+			child.name = entry.path().filename().string();
+			child.extension = entry.path().extension().string();
+			child.isDirectory = entry.is_directory(ec);
+
+			if (child.isDirectory) ReadDirectory(child);
+
+			directory.children.push_back(move(child));
+		}
+	}
+
+	void ProjectDirectory::AddToLookup(DirectoryEntry& entry)
+	{
+		entriesByPath[NormalizePath(entry.fullPath)] = &entry;
+		for (auto& child : entry.children)
+		{
+			AddToLookup(child);
+		}
+	}
+
+	void ProjectDirectory::RefreshDirectory(DirectoryEntry& directory)
+	{
+		vector<DirectoryEntry> previousChildren = move(directory.children);
+		directory.children.clear();
+
+		error_code ec;
+		for (const auto& entry : directory_iterator(directory.fullPath, ec))
+		{
+			DirectoryEntry child;
+			child.fullPath = entry.path().string();
+			child.name = entry.path().filename().string();
+			child.extension = entry.path().extension().string();
+			child.isDirectory = entry.is_directory(ec);
+
+			if (child.isDirectory)
+			{
+				//changes inside a subfolder are reported for that subfolder, only new ones are read here
+				auto previous = find_if(
+					previousChildren.begin(),
+					previousChildren.end(),
+					[&child](const DirectoryEntry& previousChild)
+					{
+						return previousChild.isDirectory
+							&& previousChild.name == child.name;
+					});
+				if (previous != previousChildren.end()) child.children = move(previous->children);
+				else ReadDirectory(child);
+			}
+
+			directory.children.push_back(move(child));
+		}
+	}
+
+	DirectoryEntry* ProjectDirectory::FindClosestDirectory(const string& fullPath)
+	{
+		string rootPath = NormalizePath(root.fullPath);
+		path current = path(NormalizePath(fullPath));
+
+		while (true)
+		{
+			string currentPath = current.string();
+			if (currentPath.size() < rootPath.size()
+				|| currentPath.compare(0, rootPath.size(), rootPath) != 0)
+			{
+				return nullptr;
+			}
+
+			auto it = entriesByPath.find(currentPath);
+			if (it != entriesByPath.end()
+				&& it->second->isDirectory)
+			{
+				return it->second;
+			}
+
+			if (!current.has_parent_path()
+				|| current.parent_path() == current)
+			{
+				return nullptr;
+			}
+			current = current.parent_path();
+		}
+	}
+
+	void ProjectDirectory::AddChangedDirectory(const string& fullPath)
+	{
+		lock_guard<mutex> lock(changedMutex);
+		changedDirectories.push_back(fullPath);
+	}
+
+	string ProjectDirectory::NormalizePath(const string& fullPath)
+	{
+		return path(fullPath).lexically_normal().make_preferred().string();
+	}
+
+	void ProjectDirectory::WatcherLoop()
+	{
+#ifdef __linux__
+		int fd = inotify_init1(IN_NONBLOCK);
+		if (fd < 0)
+		{
+			PollingLoop();
+			return;
+		}
+
+		//inotify watches are not recursive, so every folder gets its own watch
+		const uint32_t mask =
+			IN_CREATE
+			| IN_DELETE
+			| IN_MOVED_FROM
+			| IN_MOVED_TO
+			| IN_MODIFY
+			| IN_DELETE_SELF;
+		//events only carry the watch descriptor, so every watch remembers its folder
+		unordered_map<int, string> watchedDirectories;
+		auto AddWatches = [fd, mask, &watchedDirectories]()
+			{
+				error_code ec;
+				watchedDirectories[inotify_add_watch(fd, root.fullPath.c_str(), mask)] = root.fullPath;
+				for (auto it = recursive_directory_iterator(root.fullPath, directory_options::skip_permission_denied, ec);
+					it != recursive_directory_iterator();
+					it.increment(ec))
+				{
+					if (ec) break;
+					if (it->is_directory(ec))
+					{
+						watchedDirectories[inotify_add_watch(fd, it->path().c_str(), mask)] = it->path().string();
+					}
+				}
+			};
+		AddWatches();
+
+		alignas(inotify_event) char buffer[4096];
+		while (isWatching)
+		{
+			pollfd pfd{ fd, POLLIN, 0 };
+			if (poll(&pfd, 1, 250) <= 0) continue;
+
+			ssize_t length = read(fd, buffer, sizeof(buffer));
+			if (length <= 0) continue;
+
+			bool addedDirectory = false;
+			for (char* ptr = buffer; ptr < buffer + length; )
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+				if ((event->mask & IN_ISDIR)
+					&& (event->mask & (IN_CREATE | IN_MOVED_TO)))
+				{
+					addedDirectory = true;
+				}
+
+				//lost events can only be recovered by reading everything again
+				if (event->mask & IN_Q_OVERFLOW) isDirty = true;
+				else
+				{
+					auto it = watchedDirectories.find(event->wd);
+					if (it != watchedDirectories.end()) AddChangedDirectory(it->second);
+				}
+				ptr += sizeof(inotify_event) + event->len;
+			}
+
+			//adding a watch to an already watched folder is a no-op, so new folders are simply rescanned
+			if (addedDirectory) AddWatches();
+
+			RenderDamage::WakeMainThread();
+		}
+
+		close(fd);
+#elif _WIN32
+		HANDLE directory = CreateFileW(
+			path(root.fullPath).wstring().c_str(),
+			FILE_LIST_DIRECTORY,
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+			nullptr);
+		if (directory == INVALID_HANDLE_VALUE)
+		{
+			PollingLoop();
+			return;
+		}
+
+		//overlapped reads so the loop can notice shutdown while nothing changes
+		OVERLAPPED overlapped{};
+		overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+		const DWORD filter =
+			FILE_NOTIFY_CHANGE_FILE_NAME
+			| FILE_NOTIFY_CHANGE_DIR_NAME
+			| FILE_NOTIFY_CHANGE_LAST_WRITE
+			| FILE_NOTIFY_CHANGE_SIZE;
+
+		alignas(DWORD) char buffer[16384];
+		bool isReading = false;
+		bool hasFailed = false;
+		DWORD length = 0;
+		while (isWatching)
+		{
+			if (!isReading)
+			{
+				ResetEvent(overlapped.hEvent);
+				if (!ReadDirectoryChangesW(
+					directory,
+					buffer,
+					sizeof(buffer),
+					TRUE,
+					filter,
+					nullptr,
+					&overlapped,
+					nullptr))
+				{
+					hasFailed = true;
+					break;
+				}
+				isReading = true;
+			}
+
+			if (WaitForSingleObject(overlapped.hEvent, 250) != WAIT_OBJECT_0) continue;
+			isReading = false;
+
+			if (!GetOverlappedResult(directory, &overlapped, &length, FALSE))
+			{
+				hasFailed = true;
+				break;
+			}
+
+			//an empty result means the buffer overflowed and the changes are lost
+			if (length == 0) isDirty = true;
+			else
+			{
+				for (const char* ptr = buffer; ; )
+				{
+					//names are relative to the root, the folder holding the changed entry is the one to read again
+					const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(ptr);
+					wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+					AddChangedDirectory((path(root.fullPath) / name).parent_path().string());
+
+					if (info->NextEntryOffset == 0) break;
+					ptr += info->NextEntryOffset;
+				}
+			}
+
+			RenderDamage::WakeMainThread();
+		}
+
+		if (isReading)
+		{
+			CancelIo(directory);
+			GetOverlappedResult(directory, &overlapped, &length, TRUE);
+		}
+		CloseHandle(overlapped.hEvent);
+		CloseHandle(directory);
+
+		if (hasFailed && isWatching) PollingLoop();
+#else
+		PollingLoop();
+#endif
+	}
+
+	void ProjectDirectory::PollingLoop()
+	{
+		//hashes every path and write time, a different hash means something was added, removed or changed
+		auto GetSignature = []()
+			{
+				size_t signature = 0;
+				error_code ec;
+				for (auto it = recursive_directory_iterator(root.fullPath, directory_options::skip_permission_denied, ec);
+					it != recursive_directory_iterator();
+					it.increment(ec))
+				{
+					if (ec) break;
+					size_t entryHash = hash<string>{}(it->path().string())
+						^ static_cast<size_t>(it->last_write_time(ec).time_since_epoch().count());
+					signature ^= entryHash + 0x9e3779b9 + (signature << 6) + (signature >> 2);
+				}
+				return signature;
+			};
+
+		size_t lastSignature = GetSignature();
+		while (isWatching)
+		{
+			//sleeps in short steps so shutdown doesn't wait for a full poll interval
+			for (int waited = 0;
+				waited < pollIntervalMilliseconds && isWatching;
+				waited += 100)
+			{
+				sleep_for(milliseconds(100));
+			}
+			if (!isWatching) break;
+
+			size_t signature = GetSignature();
+			if (signature != lastSignature)
+			{
+				lastSignature = signature;
+				isDirty = true;
+				RenderDamage::WakeMainThread();
+			}
+		}
+	}
+}
+#endif
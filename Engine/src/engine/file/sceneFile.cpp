@@ -28,6 +28,7 @@
 #include "console.hpp"
 #include "gameObjectFile.hpp"
 #include "skybox.hpp"
+#include "profiler.hpp"
 
 using std::ifstream;
 using std::ofstream;
@@ -59,11 +60,14 @@ using Caller = Core::ConsoleManager::Caller;
 using Type = Core::ConsoleManager::Type;
 using EngineFile::GameObjectFile;
 using Graphics::Shape::Skybox;
+using Core::ProfileZone;
 
 namespace EngineFile
 {
 	void SceneFile::LoadScene(const string& scenePath)
 	{
+		ProfileZone loadSceneZone("SceneFile::LoadScene");
+
 		if (!exists(scenePath))
 		{
 			if (scenePath != Engine::scenesPath + "\\Scene1\\scene.txt")
@@ -313,6 +317,8 @@ namespace EngineFile
 
 	void SceneFile::SaveScene(SaveType saveType, const string& targetLevel)
 	{
+		ProfileZone saveSceneZone("SceneFile::SaveScene");
+
 		GameObjectFile::SaveGameObjects();
 
 		ofstream sceneFile(Engine::scenePath);
@@ -0,0 +1,432 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+//engine
+#include "sceneGenerator.hpp"
+#include "core.hpp"
+#include "console.hpp"
+#include "profiler.hpp"
+
+using std::ofstream;
+using std::to_string;
+using std::max;
+using std::uniform_real_distribution;
+using std::normal_distribution;
+using std::filesystem::exists;
+using std::filesystem::path;
+using std::filesystem::current_path;
+using std::filesystem::create_directories;
+using std::filesystem::copy_file;
+using std::filesystem::copy_options;
+using std::filesystem::filesystem_error;
+
+using Core::Engine;
+using Core::ConsoleManager;
+using Caller = Core::ConsoleManager::Caller;
+using Type = Core::ConsoleManager::Type;
+using Core::Profiler;
+using Core::ProfileZone;
+
+namespace EngineFile
+{
+	bool SceneGenerator::ParseArguments(int argc, char* argv[], Settings& settings)
+	{
+		bool isRequested = false;
+
+		for (int i = 1; i < argc; i++)
+		{
+			string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "--generate-scene" && hasValue)
+			{
+				settings.sceneFolder = argv[++i];
+				isRequested = true;
+			}
+			else if (argument == "--models" && hasValue) settings.modelCount = max(0, atoi(argv[++i]));
+			else if (argument == "--point-lights" && hasValue) settings.pointLightCount = max(0, atoi(argv[++i]));
+			else if (argument == "--spot-lights" && hasValue) settings.spotLightCount = max(0, atoi(argv[++i]));
+			else if (argument == "--billboards" && hasValue) settings.billboardCount = max(0, atoi(argv[++i]));
+			else if (argument == "--seed" && hasValue) settings.seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+			else if (argument == "--extent" && hasValue) settings.extent = max(1.0f, static_cast<float>(atof(argv[++i])));
+			else if (argument == "--model" && hasValue) settings.modelPath = argv[++i];
+			else if (argument == "--distribution" && hasValue)
+			{
+				string value = argv[++i];
+				if (value == "grid") settings.distribution = Distribution::grid;
+				else if (value == "cluster") settings.distribution = Distribution::cluster;
+				else settings.distribution = Distribution::uniform;
+			}
+		}
+
+		return isRequested;
+	}
+
+	bool SceneGenerator::Generate(const Settings& settings)
+	{
+		ProfileZone generateZone("SceneGenerator::Generate");
+
+		if (settings.sceneFolder.empty())
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: No scene folder was given for the scene generator!\n");
+			return false;
+		}
+
+		//the generator also runs from the command line before the engine has set its paths
+		string filesPath = Engine::filesPath.empty()
+			? current_path().string() + "\\files"
+			: Engine::filesPath;
+		string modelPath = settings.modelPath.empty()
+			? filesPath + "\\models\\cube.fbx"
+			: settings.modelPath;
+
+		if (settings.modelCount > 0
+			&& !exists(modelPath))
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Scene generator model '" + modelPath + "' does not exist!\n");
+			return false;
+		}
+
+		if (exists(settings.sceneFolder + "\\scene.txt"))
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Scene folder '" + settings.sceneFolder + "' already contains a scene! Pick an empty folder.\n");
+			return false;
+		}
+
+		string gameobjectsFolder = settings.sceneFolder + "\\gameobjects";
+		create_directories(gameobjectsFolder);
+
+		double startTime = Profiler::GetTimeMilliseconds();
+
+		mt19937 random(settings.seed);
+		uniform_real_distribution<float> rotation(0.0f, 360.0f);
+		uniform_real_distribution<float> scale(0.5f, 2.0f);
+		uniform_real_distribution<float> color(0.2f, 1.0f);
+
+		unsigned int nextID = 1;
+
+		for (int i = 0; i < settings.modelCount; i++)
+		{
+			vec3 pos = NextPosition(settings, random, i, settings.modelCount);
+			vec3 rot = vec3(0.0f, rotation(random), 0.0f);
+			float uniformScale = scale(random);
+
+			if (!WriteModel(
+				gameobjectsFolder,
+				modelPath,
+				"Model " + to_string(i),
+				nextID++,
+				pos,
+				rot,
+				vec3(uniformScale)))
+			{
+				return false;
+			}
+		}
+
+		for (int i = 0; i < settings.pointLightCount; i++)
+		{
+			vec3 pos = NextPosition(settings, random, i, settings.pointLightCount);
+			vec3 diffuse = vec3(color(random), color(random), color(random));
+
+			if (!WriteLight(
+				gameobjectsFolder,
+				"Point light " + to_string(i),
+				nextID,
+				false,
+				true,
+				true,
+				pos,
+				vec3(0),
+				diffuse,
+				1.0f,
+				5.0f))
+			{
+				return false;
+			}
+			//each light also owns the id of its billboard
+			nextID += 2;
+		}
+
+		for (int i = 0; i < settings.spotLightCount; i++)
+		{
+			vec3 pos = NextPosition(settings, random, i, settings.spotLightCount);
+			vec3 diffuse = vec3(color(random), color(random), color(random));
+
+			if (!WriteLight(
+				gameobjectsFolder,
+				"Spotlight " + to_string(i),
+				nextID,
+				true,
+				true,
+				true,
+				pos,
+				vec3(0.0f, rotation(random), 0.0f),
+				diffuse,
+				1.0f,
+				10.0f))
+			{
+				return false;
+			}
+			nextID += 2;
+		}
+
+		//billboards only exist attached to lights, so standalone billboards are disabled point lights
+		//with a hidden mesh, an enabled holder would take a light slot from the real point lights
+		for (int i = 0; i < settings.billboardCount; i++)
+		{
+			vec3 pos = NextPosition(settings, random, i, settings.billboardCount);
+
+			if (!WriteLight(
+				gameobjectsFolder,
+				"Billboard " + to_string(i),
+				nextID,
+				false,
+				false,
+				false,
+				pos,
+				vec3(0),
+				vec3(1),
+				0.0f,
+				0.0f))
+			{
+				return false;
+			}
+			nextID += 2;
+		}
+
+		ofstream sceneFile(settings.sceneFolder + "\\scene.txt");
+		if (!sceneFile.is_open())
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Couldn't write into scene file '" + settings.sceneFolder + "\\scene.txt'!\n");
+			return false;
+		}
+
+		//start above the edge of the scene looking towards its center
+		sceneFile << "camera_position= 0.000000,"
+			<< to_string(settings.extent * 0.25f) << ","
+			<< to_string(settings.extent) << "\n";
+		sceneFile << "camera_rotation= -90.000000,-15.000000,0.000000\n";
+		sceneFile << "renderBillboards= 1\n";
+		sceneFile << "renderLightBorders= 1\n";
+		sceneFile.close();
+
+		int total = settings.modelCount
+			+ settings.pointLightCount
+			+ settings.spotLightCount
+			+ settings.billboardCount;
+		double duration = Profiler::GetTimeMilliseconds() - startTime;
+
+		ConsoleManager::WriteConsoleMessage(
+			Caller::FILE,
+			Type::INFO,
+			"Generated scene '" + settings.sceneFolder + "' with " + to_string(total)
+			+ " gameobjects in " + to_string(static_cast<int>(duration)) + " ms.\n");
+
+		return true;
+	}
+
+	vec3 SceneGenerator::NextPosition(
+		const Settings& settings,
+		mt19937& random,
+		int index,
+		int total)
+	{
+		float extent = settings.extent;
+		float height = extent * 0.25f;
+
+		switch (settings.distribution)
+		{
+		case Distribution::grid:
+		{
+			//square grid on the ground, extra layers only once the ground is full
+			int side = max(1, static_cast<int>(ceil(sqrt(static_cast<float>(total)))));
+			int layerSize = side * side;
+			int layer = index / layerSize;
+			int x = (index % layerSize) % side;
+			int z = (index % layerSize) / side;
+			float spacing = (extent * 2.0f) / static_cast<float>(side);
+
+			return vec3(
+				-extent + (static_cast<float>(x) + 0.5f) * spacing,
+				static_cast<float>(layer) * spacing,
+				-extent + (static_cast<float>(z) + 0.5f) * spacing);
+		}
+		case Distribution::cluster:
+		{
+			//every cluster center comes from its own generator so centers stay
+			//the same no matter how many objects of other types were generated
+			int clusterCount = max(1, total / 250);
+			int cluster = index % clusterCount;
+
+			mt19937 clusterRandom(settings.seed + static_cast<unsigned int>(cluster) * 7919u);
+			uniform_real_distribution<float> centerXZ(-extent, extent);
+			uniform_real_distribution<float> centerY(0.0f, height);
+			vec3 center = vec3(
+				centerXZ(clusterRandom),
+				centerY(clusterRandom),
+				centerXZ(clusterRandom));
+
+			normal_distribution<float> offset(0.0f, extent * 0.05f);
+			return center + vec3(offset(random), offset(random), offset(random));
+		}
+		case Distribution::uniform:
+		default:
+		{
+			uniform_real_distribution<float> xz(-extent, extent);
+			uniform_real_distribution<float> y(0.0f, height);
+			float x = xz(random);
+			float yValue = y(random);
+			float z = xz(random);
+			return vec3(x, yValue, z);
+		}
+		}
+	}
+
+	bool SceneGenerator::WriteModel(
+		const string& gameobjectsFolder,
+		const string& modelPath,
+		const string& name,
+		unsigned int id,
+		const vec3& pos,
+		const vec3& rot,
+		const vec3& scale)
+	{
+		string objectFolder = gameobjectsFolder + "\\" + name;
+		string txtFilePath = objectFolder + "\\" + name + ".txt";
+		string targetModelPath = objectFolder + "\\" + name + path(modelPath).extension().string();
+
+		try
+		{
+			create_directories(objectFolder);
+			copy_file(modelPath, targetModelPath, copy_options::overwrite_existing);
+		}
+		catch (const filesystem_error& e)
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Failed to create model folder '" + objectFolder + "'! " + e.what() + ".\n");
+			return false;
+		}
+
+		ofstream objectFile(txtFilePath);
+		if (!objectFile.is_open())
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Couldn't write into object txt file path '" + txtFilePath + "'!\n");
+			return false;
+		}
+
+		objectFile << "name= " << name << "\n";
+		objectFile << "id= " << id << "\n";
+		objectFile << "enabled= 1\n";
+		objectFile << "mesh enabled= 1\n";
+		objectFile << "type= model\n";
+		objectFile << "position= " << to_string(pos.x) << ", " << to_string(pos.y) << ", " << to_string(pos.z) << "\n";
+		objectFile << "rotation= " << to_string(rot.x) << ", " << to_string(rot.y) << ", " << to_string(rot.z) << "\n";
+		objectFile << "scale= " << to_string(scale.x) << ", " << to_string(scale.y) << ", " << to_string(scale.z) << "\n";
+		objectFile << "\n";
+		objectFile << "textures= DEFAULTDIFF, DEFAULTSPEC, EMPTY, EMPTY\n";
+		objectFile << "shaders= GameObject.vert, GameObject.frag\n";
+		objectFile << "txtFile= " << txtFilePath << "\n";
+		objectFile << "shininess= 32.000000\n";
+		objectFile.close();
+
+		return true;
+	}
+
+	bool SceneGenerator::WriteLight(
+		const string& gameobjectsFolder,
+		const string& name,
+		unsigned int id,
+		bool isSpotlight,
+		bool isEnabled,
+		bool isMeshEnabled,
+		const vec3& pos,
+		const vec3& rot,
+		const vec3& diffuse,
+		float intensity,
+		float distance)
+	{
+		string objectFolder = gameobjectsFolder + "\\" + name;
+		string txtFilePath = objectFolder + "\\" + name + ".txt";
+
+		try
+		{
+			create_directories(objectFolder);
+		}
+		catch (const filesystem_error& e)
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Failed to create light folder '" + objectFolder + "'! " + e.what() + ".\n");
+			return false;
+		}
+
+		ofstream objectFile(txtFilePath);
+		if (!objectFile.is_open())
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Couldn't write into object txt file path '" + txtFilePath + "'!\n");
+			return false;
+		}
+
+		objectFile << "name= " << name << "\n";
+		objectFile << "id= " << id << "\n";
+		objectFile << "enabled= " << isEnabled << "\n";
+		objectFile << "mesh enabled= " << isMeshEnabled << "\n";
+		objectFile << "type= " << (isSpotlight ? "spot_light" : "point_light") << "\n";
+		objectFile << "position= " << to_string(pos.x) << ", " << to_string(pos.y) << ", " << to_string(pos.z) << "\n";
+		objectFile << "rotation= " << to_string(rot.x) << ", " << to_string(rot.y) << ", " << to_string(rot.z) << "\n";
+		objectFile << "scale= 1.000000, 1.000000, 1.000000\n";
+		objectFile << "\n";
+		objectFile << "shaders= Basic_model.vert, Basic.frag\n";
+		objectFile << "txtFile= " << txtFilePath << "\n";
+		objectFile << "diffuse= " << to_string(diffuse.x) << ", " << to_string(diffuse.y) << ", " << to_string(diffuse.z) << "\n";
+		objectFile << "intensity= " << to_string(intensity) << "\n";
+		objectFile << "distance= " << to_string(distance) << "\n";
+		if (isSpotlight)
+		{
+			objectFile << "inner angle= 15.000000\n";
+			objectFile << "outer angle= 30.000000\n";
+		}
+		objectFile << "\n";
+		objectFile << "---attached billboard data---\n";
+		objectFile << "\n";
+		objectFile << "billboard name= Billboard\n";
+		objectFile << "billboard id= " << (id + 1) << "\n";
+		objectFile << "billboard enabled= 1\n";
+		objectFile << "billboard shaders= Basic_texture.vert, Basic_texture.frag\n";
+		objectFile << "billboard texture= " << (isSpotlight ? "spotLight.png" : "pointLight.png") << "\n";
+		objectFile << "billboard shininess= 32.000000\n";
+		objectFile.close();
+
+		return true;
+	}
+}
@@ -0,0 +1,531 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <map>
+#include <memory>
+#include <algorithm>
+
+//external
+#include "glm.hpp"
+#include "quaternion.hpp"
+#include "matrix_transform.hpp"
+#include "assimp/postprocess.h"
+
+//engine
+#include "staticBatchFile.hpp"
+#include "gameObjectFile.hpp"
+#include "importer.hpp"
+#include "model.hpp"
+#include "texture.hpp"
+#include "core.hpp"
+#include "console.hpp"
+#include "stringUtils.hpp"
+#include "fileUtils.hpp"
+#include "jobSystem.hpp"
+
+using std::ifstream;
+using std::ofstream;
+using std::ios;
+using std::unordered_map;
+using std::map;
+using std::shared_ptr;
+using std::sort;
+using std::remove_if;
+using std::to_string;
+using std::stof;
+using std::move;
+using std::filesystem::exists;
+using std::filesystem::path;
+using std::filesystem::directory_iterator;
+using std::filesystem::recursive_directory_iterator;
+using std::filesystem::is_directory;
+using glm::vec3;
+using glm::vec4;
+using glm::mat3;
+using glm::mat4;
+using glm::quat;
+using glm::translate;
+using glm::radians;
+using glm::normalize;
+using glm::transpose;
+using glm::inverse;
+
+using Core::Engine;
+using Core::ConsoleManager;
+using Core::JobSystem;
+using Caller = Core::ConsoleManager::Caller;
+using Type = Core::ConsoleManager::Type;
+using Graphics::Texture;
+using Graphics::Shape::GameObject;
+using Graphics::Shape::Importer;
+using Graphics::Shape::Model;
+using Graphics::Shape::AssimpMesh;
+using Graphics::Shape::Material;
+using Utils::String;
+using Utils::File;
+
+namespace EngineFile
+{
+	//guards the allocations against a damaged file
+	static constexpr uint32_t maxBatchStringLength = 4096;
+
+	static bool IsTexturePlaceholder(const string& texture)
+	{
+		return texture == "DEFAULTDIFF"
+			|| texture == "DEFAULTSPEC"
+			|| texture == "EMPTY";
+	}
+
+	static bool ReadString(ifstream& file, string& value)
+	{
+		uint32_t length = 0;
+		file.read(reinterpret_cast<char*>(&length), sizeof(length));
+		if (!file || length > maxBatchStringLength) return false;
+
+		value.resize(length);
+		file.read(value.data(), length);
+		return static_cast<bool>(file);
+	}
+
+	template<typename T>
+	static bool ReadVector(ifstream& file, vector<T>& values, size_t count)
+	{
+		values.resize(count);
+		file.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+		return static_cast<bool>(file);
+	}
+
+#if ENGINE_MODE
+	static void WriteString(ofstream& file, const string& value)
+	{
+		uint32_t length = static_cast<uint32_t>(value.size());
+		file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		file.write(value.data(), length);
+	}
+
+	template<typename T>
+	static void WriteVector(ofstream& file, const vector<T>& values)
+	{
+		file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+
+	/// <summary>
+	/// Hashed by contents, the same image copied into two gameobject folders is still the same material.
+	/// </summary>
+	static string HashTexture(const string& texturePath)
+	{
+		if (IsTexturePlaceholder(texturePath)) return texturePath;
+
+		uint64_t hash = 0;
+		if (!File::HashContents(texturePath, hash)) return texturePath;
+
+		return to_string(hash);
+	}
+
+	void StaticBatchFile::CookScenes(const string& folder)
+	{
+		if (!exists(folder)) return;
+
+		vector<string> sceneFolders;
+		for (const auto& entry : recursive_directory_iterator(folder))
+		{
+			if (entry.is_regular_file()
+				&& entry.path().filename() == "scene.txt")
+			{
+				sceneFolders.push_back(entry.path().parent_path().string());
+			}
+		}
+
+		for (const string& sceneFolder : sceneFolders)
+		{
+			//the engine is closing, the remaining scenes are left uncooked
+			if (JobSystem::IsCancelled()) return;
+
+			CookScene(sceneFolder);
+		}
+	}
+
+	void StaticBatchFile::CookScene(const string& sceneFolder)
+	{
+		string batchFilePath = sceneFolder + "\\" + fileName;
+		if (exists(batchFilePath)) File::DeleteFileOrfolder(batchFilePath);
+
+		string gameobjectsFolder = sceneFolder + "\\gameobjects";
+		if (!exists(gameobjectsFolder)) return;
+
+		//sorted so that the same scene always cooks into the same file
+		vector<string> objectFolders;
+		for (const auto& entry : directory_iterator(gameobjectsFolder))
+		{
+			if (is_directory(entry)) objectFolders.push_back(entry.path().string());
+		}
+		sort(objectFolders.begin(), objectFolders.end());
+
+		vector<StaticBatch> batches;
+		//material and cell of a batch to the batch that is still being filled
+		map<string, size_t> openBatches;
+
+		for (const string& objectFolder : objectFolders)
+		{
+			//parsing a model can take a while, a cancelled cook writes no batch file at all
+			if (JobSystem::IsCancelled()) return;
+
+			string modelPath{};
+			for (const auto& file : directory_iterator(objectFolder))
+			{
+				string extension = path(file).extension().string();
+				if (extension == ".fbx"
+					|| extension == ".obj"
+					|| extension == ".glfw")
+				{
+					modelPath = path(file).string();
+					break;
+				}
+			}
+			if (modelPath == "") continue;
+
+			string txtFilePath = objectFolder + "\\" + path(modelPath).stem().string() + ".txt";
+			//flagged occluders stay separate, a merged batch would be too dense to rasterize as one
+			unordered_map<string, string> data;
+			if (!GameObjectFile::ReadKeyValues(txtFilePath, data)
+				|| data["type"] != "model"
+				|| data["static"] != "1"
+				|| data["occluder"] == "1"
+				|| data["enabled"] != "1"
+				|| data["mesh enabled"] != "1")
+			{
+				continue;
+			}
+
+			vector<string> textures = String::Split(data["textures"], ',');
+			vector<string> shaders = String::Split(data["shaders"], ',');
+			vector<string> position = String::Split(data["position"], ',');
+			vector<string> rotation = String::Split(data["rotation"], ',');
+			vector<string> scale = String::Split(data["scale"], ',');
+			if (textures.size() < 4
+				|| shaders.size() < 2
+				|| position.size() < 3
+				|| rotation.size() < 3
+				|| scale.size() < 3)
+			{
+				ConsoleManager::WriteConsoleMessage(
+					Caller::FILE,
+					Type::EXCEPTION,
+					"Error: Static model '" + txtFilePath + "' has incomplete data! It was not batched.\n");
+				continue;
+			}
+
+			Assimp::Importer importer;
+			const aiScene* scene = importer.ReadFile(
+				modelPath,
+				aiProcess_Triangulate
+				| aiProcess_GenSmoothNormals
+				| aiProcess_FlipUVs
+				| aiProcess_CalcTangentSpace);
+			if (!scene
+				|| scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE
+				|| !scene->mRootNode
+				|| scene->mNumMeshes == 0)
+			{
+				ConsoleManager::WriteConsoleMessage(
+					Caller::FILE,
+					Type::EXCEPTION,
+					"Assimp error: " + string(importer.GetErrorString()) + "\n");
+				continue;
+			}
+
+			AssimpMesh mesh = Importer::ProcessMesh(scene->mMeshes[0], scene);
+			if (mesh.vertices.empty()
+				|| mesh.indices.empty())
+			{
+				continue;
+			}
+
+			//the same matrix the model is rendered with, so the batch looks exactly like the separate models
+			mat4 model = translate(mat4(1.0f), String::StringToVec3(position));
+			model *= glm::mat4_cast(quat(radians(String::StringToVec3(rotation))));
+			model = glm::scale(model, String::StringToVec3(scale));
+			mat3 directionMatrix = mat3(model);
+			mat3 normalMatrix = transpose(inverse(directionMatrix));
+
+			vec3 boundsMin = vec3(model * vec4(mesh.vertices[0].pos, 1.0f));
+			vec3 boundsMax = boundsMin;
+			for (AssimpVertex& vertex : mesh.vertices)
+			{
+				vertex.pos = vec3(model * vec4(vertex.pos, 1.0f));
+				vertex.normal = normalize(normalMatrix * vertex.normal);
+				vertex.tangent = directionMatrix * vertex.tangent;
+				vertex.bitangent = directionMatrix * vertex.bitangent;
+
+				boundsMin = glm::min(boundsMin, vertex.pos);
+				boundsMax = glm::max(boundsMax, vertex.pos);
+			}
+
+			StaticBatch material{};
+			string objectFolderName = path(objectFolder).filename().string();
+			string key{};
+			for (int i = 0; i < 4; i++)
+			{
+				material.textures[i] = IsTexturePlaceholder(textures[i])
+					? textures[i]
+					: "gameobjects\\" + objectFolderName + "\\" + textures[i];
+
+				key += HashTexture(IsTexturePlaceholder(textures[i])
+					? textures[i]
+					: objectFolder + "\\" + textures[i]) + "|";
+			}
+			material.vertShader = shaders[0];
+			material.fragShader = shaders[1];
+			material.shininess = data["shininess"] != "" ? stof(data["shininess"]) : 32.0f;
+
+			vec3 cell = glm::floor((boundsMin + boundsMax) * 0.5f / cellSize);
+			key += shaders[0] + "|" + shaders[1] + "|" + data["shininess"] + "|"
+				+ to_string(static_cast<int>(cell.x)) + ","
+				+ to_string(static_cast<int>(cell.y)) + ","
+				+ to_string(static_cast<int>(cell.z));
+
+			auto it = openBatches.find(key);
+			if (it == openBatches.end()
+				|| batches[it->second].vertices.size() + mesh.vertices.size() > maxBatchVertices)
+			{
+				batches.push_back(material);
+				openBatches[key] = batches.size() - 1;
+			}
+			StaticBatch& batch = batches[openBatches[key]];
+
+			unsigned int baseVertex = static_cast<unsigned int>(batch.vertices.size());
+			batch.ranges.push_back({
+				static_cast<unsigned int>(batch.indices.size()),
+				static_cast<unsigned int>(mesh.indices.size()),
+				boundsMin,
+				boundsMax });
+			batch.members.push_back(objectFolderName);
+
+			batch.vertices.insert(batch.vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+			for (unsigned int index : mesh.indices)
+			{
+				batch.indices.push_back(baseVertex + index);
+			}
+		}
+
+		//a batch of one model saves no draw calls, that model stays a regular gameobject
+		batches.erase(remove_if(batches.begin(), batches.end(), [](const StaticBatch& batch)
+			{
+				return batch.members.size() < 2;
+			}), batches.end());
+		if (batches.empty()) return;
+
+		bool isWritten = File::WriteAtomically(batchFilePath, [&batches](ofstream& batchFile)
+			{
+				uint32_t header[3] = { batchFileMagic, batchFileVersion, static_cast<uint32_t>(batches.size()) };
+				batchFile.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+				for (const StaticBatch& batch : batches)
+				{
+					for (const string& texture : batch.textures)
+					{
+						WriteString(batchFile, texture);
+					}
+					WriteString(batchFile, batch.vertShader);
+					WriteString(batchFile, batch.fragShader);
+					batchFile.write(reinterpret_cast<const char*>(&batch.shininess), sizeof(batch.shininess));
+
+					uint32_t counts[3] =
+					{
+						static_cast<uint32_t>(batch.vertices.size()),
+						static_cast<uint32_t>(batch.indices.size()),
+						static_cast<uint32_t>(batch.ranges.size())
+					};
+					batchFile.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+
+					WriteVector(batchFile, batch.vertices);
+					WriteVector(batchFile, batch.indices);
+					WriteVector(batchFile, batch.ranges);
+					for (const string& member : batch.members)
+					{
+						WriteString(batchFile, member);
+					}
+				}
+			});
+		if (!isWritten)
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Failed to write static batch file '" + batchFilePath + "'!\n");
+			return;
+		}
+
+		size_t modelCount = 0;
+		for (const StaticBatch& batch : batches)
+		{
+			modelCount += batch.members.size();
+		}
+
+		ConsoleManager::WriteConsoleMessage(
+			Caller::FILE,
+			Type::INFO,
+			"Merged " + to_string(modelCount) + " static models of scene '" + path(sceneFolder).stem().string()
+			+ "' into " + to_string(batches.size()) + " batches.\n");
+	}
+#endif
+
+	unordered_set<string> StaticBatchFile::LoadBatches(const string& sceneFolder)
+	{
+		loadedBatches.clear();
+		loadedSceneFolder = sceneFolder;
+
+		unordered_set<string> mergedFolders;
+
+		string batchFilePath = sceneFolder + "\\" + fileName;
+		if (!exists(batchFilePath)) return mergedFolders;
+
+		ifstream batchFile(batchFilePath, ios::binary);
+
+		uint32_t header[3]{};
+		batchFile.read(reinterpret_cast<char*>(header), sizeof(header));
+		bool isValid = batchFile
+			&& header[0] == batchFileMagic
+			&& header[1] == batchFileVersion;
+
+		//everything is read before any model is created, a damaged file falls back to the separate models
+		vector<StaticBatch> batches(isValid ? header[2] : 0);
+		for (StaticBatch& batch : batches)
+		{
+			for (string& texture : batch.textures)
+			{
+				isValid = isValid && ReadString(batchFile, texture);
+			}
+			isValid = isValid
+				&& ReadString(batchFile, batch.vertShader)
+				&& ReadString(batchFile, batch.fragShader);
+			if (!isValid) break;
+
+			batchFile.read(reinterpret_cast<char*>(&batch.shininess), sizeof(batch.shininess));
+
+			uint32_t counts[3]{};
+			batchFile.read(reinterpret_cast<char*>(counts), sizeof(counts));
+			if (!batchFile
+				|| counts[0] > maxBatchVertices
+				|| counts[1] > maxBatchVertices * 8
+				|| counts[2] > counts[1] / 3)
+			{
+				isValid = false;
+				break;
+			}
+
+			isValid = ReadVector(batchFile, batch.vertices, counts[0])
+				&& ReadVector(batchFile, batch.indices, counts[1])
+				&& ReadVector(batchFile, batch.ranges, counts[2]);
+			if (!isValid) break;
+
+			batch.members.resize(counts[2]);
+			for (string& member : batch.members)
+			{
+				isValid = isValid && ReadString(batchFile, member);
+			}
+
+			for (unsigned int index : batch.indices)
+			{
+				if (index >= counts[0]) isValid = false;
+			}
+			for (const MeshRange& range : batch.ranges)
+			{
+				if (static_cast<size_t>(range.indexOffset) + range.indexCount > counts[1]) isValid = false;
+			}
+			if (!isValid) break;
+		}
+		batchFile.close();
+
+		if (!isValid)
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::EXCEPTION,
+				"Error: Static batch file '" + batchFilePath + "' is invalid! Loading every static model on its own.\n");
+			return mergedFolders;
+		}
+
+		for (const StaticBatch& batch : batches)
+		{
+			mergedFolders.insert(batch.members.begin(), batch.members.end());
+		}
+		loadedBatches = move(batches);
+
+		return mergedFolders;
+	}
+
+	void StaticBatchFile::CreateBatchModels()
+	{
+		for (size_t i = 0; i < loadedBatches.size(); i++)
+		{
+			const StaticBatch& batch = loadedBatches[i];
+
+			//same fallbacks as separate models with missing textures
+			string textures[4]{};
+			for (int j = 0; j < 4; j++)
+			{
+				textures[j] = batch.textures[j];
+				if (!IsTexturePlaceholder(textures[j]))
+				{
+					textures[j] = loadedSceneFolder + "\\" + textures[j];
+					if (!exists(textures[j]))
+					{
+						ConsoleManager::WriteConsoleMessage(
+							Caller::FILE,
+							Type::EXCEPTION,
+							"Error: Texture '" + textures[j] + "' of a static batch does not exist!\n");
+
+						textures[j] = j == 0
+							? Engine::filesPath + "\\textures\\diff_missing.png"
+							: j == 1 ? "DEFAULTSPEC" : "EMPTY";
+					}
+				}
+			}
+
+			string name = "StaticBatch" + to_string(i);
+			unsigned int id = GameObject::nextID++;
+
+			shared_ptr<GameObject> obj = Model::Initialize(
+				vec3(0),
+				vec3(0),
+				vec3(1),
+				"",
+				"",
+				Engine::filesPath + "\\shaders\\" + batch.vertShader,
+				Engine::filesPath + "\\shaders\\" + batch.fragShader,
+				textures[0],
+				textures[1],
+				textures[2],
+				textures[3],
+				batch.vertices,
+				batch.indices,
+				batch.shininess,
+				name,
+				id);
+
+			//same slots as GameObjectFile::LoadModel gives them
+			Texture::LoadTexture(obj, textures[2], Material::TextureType::height, false);
+			Texture::LoadTexture(obj, textures[3], Material::TextureType::normal, false);
+
+			obj->SetStatic(true);
+			obj->GetMesh()->SetRanges(batch.ranges);
+		}
+
+		if (!loadedBatches.empty())
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				Type::DEBUG,
+				"Loaded " + to_string(loadedBatches.size()) + " static batches for scene '"
+				+ path(loadedSceneFolder).stem().string() + "'.\n");
+		}
+
+		loadedBatches.clear();
+	}
+}
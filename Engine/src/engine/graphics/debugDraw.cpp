@@ -0,0 +1,257 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <cmath>
+#include <cstddef>
+
+//external
+#include "glad.h"
+#include "constants.hpp"
+
+//engine
+#include "debugDraw.hpp"
+#include "core.hpp"
+
+using std::abs;
+using std::cos;
+using std::sin;
+using std::tan;
+using glm::normalize;
+using glm::cross;
+using glm::inverse;
+using glm::radians;
+using glm::two_pi;
+
+using Core::Engine;
+
+namespace Graphics
+{
+	//edges of a unit cube as point pairs
+	static const vec3 boxLines[] =
+	{
+		{ -0.5f, -0.5f, -0.5f }, {  0.5f, -0.5f, -0.5f },
+		{  0.5f, -0.5f, -0.5f }, {  0.5f,  0.5f, -0.5f },
+		{  0.5f,  0.5f, -0.5f }, { -0.5f,  0.5f, -0.5f },
+		{ -0.5f,  0.5f, -0.5f }, { -0.5f, -0.5f, -0.5f },
+
+		{ -0.5f, -0.5f,  0.5f }, {  0.5f, -0.5f,  0.5f },
+		{  0.5f, -0.5f,  0.5f }, {  0.5f,  0.5f,  0.5f },
+		{  0.5f,  0.5f,  0.5f }, { -0.5f,  0.5f,  0.5f },
+		{ -0.5f,  0.5f,  0.5f }, { -0.5f, -0.5f,  0.5f },
+
+		//connecting edges
+		{ -0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f,  0.5f },
+		{  0.5f, -0.5f, -0.5f }, {  0.5f, -0.5f,  0.5f },
+		{  0.5f,  0.5f, -0.5f }, {  0.5f,  0.5f,  0.5f },
+		{ -0.5f,  0.5f, -0.5f }, { -0.5f,  0.5f,  0.5f }
+	};
+
+	static const vec3 pyramidLines[] =
+	{
+		//four corner edges
+		{ 0.0f,  0.5f,  0.0f }, { -0.5f, -0.5f, -0.5f },
+		{ 0.0f,  0.5f,  0.0f }, {  0.5f, -0.5f, -0.5f },
+		{ 0.0f,  0.5f,  0.0f }, { -0.5f, -0.5f,  0.5f },
+		{ 0.0f,  0.5f,  0.0f }, {  0.5f, -0.5f,  0.5f },
+
+		//four bottom edges
+		{  0.5f, -0.5f,  0.5f }, { -0.5f, -0.5f,  0.5f },
+		{  0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f, -0.5f },
+		{ -0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f,  0.5f },
+		{  0.5f, -0.5f, -0.5f }, {  0.5f, -0.5f,  0.5f }
+	};
+
+	void DebugDraw::DrawLine(const vec3& from, const vec3& to, const vec4& color, bool depthTest)
+	{
+		vector<LineVertex>& lines = depthTest ? depthTestedLines : overlayLines;
+		lines.push_back({ from, color });
+		lines.push_back({ to, color });
+	}
+
+	void DebugDraw::DrawLines(const vec3* points, size_t count, const mat4& model, const vec4& color, bool depthTest)
+	{
+		vector<LineVertex>& lines = depthTest ? depthTestedLines : overlayLines;
+		lines.reserve(lines.size() + count);
+		for (size_t i = 0; i + 1 < count; i += 2)
+		{
+			lines.push_back({ vec3(model * vec4(points[i], 1.0f)), color });
+			lines.push_back({ vec3(model * vec4(points[i + 1], 1.0f)), color });
+		}
+	}
+
+	void DebugDraw::DrawBox(const mat4& model, const vec4& color, bool depthTest)
+	{
+		DrawLines(boxLines, sizeof(boxLines) / sizeof(boxLines[0]), model, color, depthTest);
+	}
+
+	void DebugDraw::DrawBox(const vec3& minBound, const vec3& maxBound, const vec4& color, bool depthTest)
+	{
+		mat4 model = mat4(1.0f);
+		model[0][0] = maxBound.x - minBound.x;
+		model[1][1] = maxBound.y - minBound.y;
+		model[2][2] = maxBound.z - minBound.z;
+		model[3] = vec4((minBound + maxBound) * 0.5f, 1.0f);
+
+		DrawBox(model, color, depthTest);
+	}
+
+	void DebugDraw::DrawPyramid(const mat4& model, const vec4& color, bool depthTest)
+	{
+		DrawLines(pyramidLines, sizeof(pyramidLines) / sizeof(pyramidLines[0]), model, color, depthTest);
+	}
+
+	void DebugDraw::DrawSphere(
+		const vec3& center,
+		float radius,
+		const vec4& color,
+		bool depthTest,
+		int segments)
+	{
+		float step = two_pi<float>() / static_cast<float>(segments);
+		for (int i = 0; i < segments; i++)
+		{
+			float a0 = step * static_cast<float>(i);
+			float a1 = step * static_cast<float>(i + 1);
+			float c0 = cos(a0) * radius;
+			float s0 = sin(a0) * radius;
+			float c1 = cos(a1) * radius;
+			float s1 = sin(a1) * radius;
+
+			DrawLine(center + vec3(c0, s0, 0.0f), center + vec3(c1, s1, 0.0f), color, depthTest);
+			DrawLine(center + vec3(c0, 0.0f, s0), center + vec3(c1, 0.0f, s1), color, depthTest);
+			DrawLine(center + vec3(0.0f, c0, s0), center + vec3(0.0f, c1, s1), color, depthTest);
+		}
+	}
+
+	void DebugDraw::DrawCone(
+		const vec3& apex,
+		const vec3& direction,
+		float length,
+		float angle,
+		const vec4& color,
+		bool depthTest,
+		int segments)
+	{
+		vec3 forward = normalize(direction);
+		//any axis that is not parallel to the direction works for building the base circle
+		vec3 helper = abs(forward.y) < 0.99f ? vec3(0.0f, 1.0f, 0.0f) : vec3(1.0f, 0.0f, 0.0f);
+		vec3 right = normalize(cross(forward, helper));
+		vec3 up = cross(right, forward);
+
+		vec3 baseCenter = apex + forward * length;
+		float baseRadius = tan(radians(angle)) * length;
+
+		float step = two_pi<float>() / static_cast<float>(segments);
+		for (int i = 0; i < segments; i++)
+		{
+			float a0 = step * static_cast<float>(i);
+			float a1 = step * static_cast<float>(i + 1);
+			vec3 p0 = baseCenter + (right * cos(a0) + up * sin(a0)) * baseRadius;
+			vec3 p1 = baseCenter + (right * cos(a1) + up * sin(a1)) * baseRadius;
+
+			DrawLine(p0, p1, color, depthTest);
+
+			//four side lines are enough to read the shape
+			if (i % (segments / 4 > 0 ? segments / 4 : 1) == 0)
+			{
+				DrawLine(apex, p0, color, depthTest);
+			}
+		}
+	}
+
+	void DebugDraw::DrawFrustum(const mat4& viewProjection, const vec4& color, bool depthTest)
+	{
+		mat4 inverseViewProjection = inverse(viewProjection);
+
+		//the clip space cube mapped back to world space
+		vec3 corners[8]{};
+		for (int i = 0; i < 8; i++)
+		{
+			vec4 ndc = vec4(
+				(i & 1) ? 1.0f : -1.0f,
+				(i & 2) ? 1.0f : -1.0f,
+				(i & 4) ? 1.0f : -1.0f,
+				1.0f);
+			vec4 world = inverseViewProjection * ndc;
+			corners[i] = vec3(world) / world.w;
+		}
+
+		for (int i = 0; i < 8; i++)
+		{
+			//connect every corner to the neighbours that differ in exactly one axis
+			for (int axis = 1; axis < 8; axis <<= 1)
+			{
+				if ((i & axis) == 0) DrawLine(corners[i], corners[i | axis], color, depthTest);
+			}
+		}
+	}
+
+	void DebugDraw::Flush(const mat4& view, const mat4& projection)
+	{
+		if (!HasPendingLines()) return;
+
+		if (VAO == 0) Initialize();
+
+		size_t depthTestedCount = depthTestedLines.size();
+		size_t overlayCount = overlayLines.size();
+		size_t totalCount = depthTestedCount + overlayCount;
+
+		//orphan the old storage so the driver does not wait for last frame's draw to finish reading it
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		if (totalCount > bufferCapacity) bufferCapacity = totalCount * 2;
+		glBufferData(GL_ARRAY_BUFFER, bufferCapacity * sizeof(LineVertex), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, depthTestedCount * sizeof(LineVertex), depthTestedLines.data());
+		glBufferSubData(
+			GL_ARRAY_BUFFER,
+			depthTestedCount * sizeof(LineVertex),
+			overlayCount * sizeof(LineVertex),
+			overlayLines.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		shader.Use();
+		shader.SetMat4("projection", projection);
+		shader.SetMat4("view", view);
+
+		glBindVertexArray(VAO);
+
+		if (depthTestedCount > 0)
+		{
+			glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(depthTestedCount));
+		}
+		if (overlayCount > 0)
+		{
+			glDisable(GL_DEPTH_TEST);
+			glDrawArrays(GL_LINES, static_cast<GLint>(depthTestedCount), static_cast<GLsizei>(overlayCount));
+			glEnable(GL_DEPTH_TEST);
+		}
+
+		glBindVertexArray(0);
+
+		depthTestedLines.clear();
+		overlayLines.clear();
+	}
+
+	void DebugDraw::Initialize()
+	{
+		shader = Shader::LoadShader(
+			Engine::filesPath + "\\shaders\\DebugLine.vert",
+			Engine::filesPath + "\\shaders\\DebugLine.frag");
+
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+		//position attribute
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (void*)offsetof(LineVertex, position));
+		glEnableVertexAttribArray(0);
+		//color attribute
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (void*)offsetof(LineVertex, color));
+		glEnableVertexAttribArray(1);
+
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+}
@@ -0,0 +1,209 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+//external
+#include "glad.h"
+
+//engine
+#include "dynamicResolution.hpp"
+#include "configFile.hpp"
+#include "renderDamage.hpp"
+#include "console.hpp"
+#include "core.hpp"
+
+using std::clamp;
+using std::max;
+using std::min;
+using std::round;
+using std::floor;
+using std::sqrt;
+
+using EngineFile::ConfigFile;
+using Graphics::RenderDamage;
+using Core::ConsoleManager;
+using Core::Engine;
+using Caller = Core::ConsoleManager::Caller;
+using Type = Core::ConsoleManager::Type;
+
+namespace Graphics
+{
+	void DynamicResolution::SetOutputSize(int width, int height)
+	{
+		outputWidth = max(width, 1);
+		outputHeight = max(height, 1);
+	}
+
+	void DynamicResolution::BeginScene(unsigned int outputFramebuffer)
+	{
+		static const bool& isDynamic = ConfigFile::GetBool("graphics_dynamicResolution");
+		static const float& renderScale = ConfigFile::GetFloat("graphics_renderScale");
+
+		ReadGPUTimes();
+
+		float maxScale = clamp(renderScale, minScale, 1.0f);
+		if (isDynamic)
+		{
+			UpdateDynamicScale(maxScale);
+			currentScale = min(dynamicScale, maxScale);
+		}
+		else currentScale = maxScale;
+
+		renderWidth = max(static_cast<int>(round(outputWidth * currentScale)), 1);
+		renderHeight = max(static_cast<int>(round(outputHeight * currentScale)), 1);
+
+		isUpscaling = renderWidth < outputWidth || renderHeight < outputHeight;
+		if (isUpscaling)
+		{
+			RenderTargetPool::Fit(sceneTarget, renderWidth, renderHeight, GL_RGB8, true);
+			glBindFramebuffer(GL_FRAMEBUFFER, sceneTarget->framebuffer);
+		}
+		else
+		{
+			renderWidth = outputWidth;
+			renderHeight = outputHeight;
+			glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+
+			//the low resolution target goes back to the pool, which frees it if it stays unused
+			RenderTargetPool::Release(sceneTarget);
+			sceneTarget = nullptr;
+		}
+		glViewport(0, 0, renderWidth, renderHeight);
+
+		if (timerQueries[0] == 0) glGenQueries(queryCount, timerQueries);
+
+		//skip the measurement this frame if every query is still waiting for the gpu
+		isQueryActive = !isQueryPending[queryIndex];
+		if (isQueryActive) glBeginQuery(GL_TIME_ELAPSED, timerQueries[queryIndex]);
+	}
+
+	void DynamicResolution::EndScene(unsigned int outputFramebuffer)
+	{
+		if (isUpscaling) Upscale(outputFramebuffer);
+
+		if (isQueryActive)
+		{
+			glEndQuery(GL_TIME_ELAPSED);
+			isQueryPending[queryIndex] = true;
+			queryIndex = (queryIndex + 1) % queryCount;
+			isQueryActive = false;
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+		glViewport(0, 0, outputWidth, outputHeight);
+	}
+
+	void DynamicResolution::ReadGPUTimes()
+	{
+		//oldest query first so the smoothed time sees the results in order
+		for (int i = 0; i < queryCount; i++)
+		{
+			int index = (queryIndex + i) % queryCount;
+			if (!isQueryPending[index]) continue;
+
+			GLint isAvailable = 0;
+			glGetQueryObjectiv(timerQueries[index], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+			if (!isAvailable) break;
+
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(timerQueries[index], GL_QUERY_RESULT, &elapsed);
+			isQueryPending[index] = false;
+
+			float gpuTime = static_cast<float>(static_cast<double>(elapsed) / 1000000.0);
+			smoothedGPUTime = smoothedGPUTime == 0.0f
+				? gpuTime
+				: smoothedGPUTime + (gpuTime - smoothedGPUTime) * 0.1f;
+		}
+	}
+
+	void DynamicResolution::UpdateDynamicScale(float maxScale)
+	{
+		static const float& gpuBudget = ConfigFile::GetFloat("graphics_gpuBudget");
+
+		if (smoothedGPUTime <= 0.0f
+			|| gpuBudget <= 0.0f
+			|| ++framesSinceScaleChange < scaleChangeInterval)
+		{
+			return;
+		}
+
+		float newScale = dynamicScale;
+		if (smoothedGPUTime > gpuBudget)
+		{
+			//gpu time follows the pixel count, which is the square of the scale
+			newScale = floor(dynamicScale * sqrt(gpuBudget / smoothedGPUTime) / scaleStep) * scaleStep;
+		}
+		//only grow with clear headroom so the scale does not flip between two steps
+		else if (smoothedGPUTime < gpuBudget * 0.7f)
+		{
+			newScale = dynamicScale + scaleStep;
+		}
+		newScale = clamp(newScale, min(minDynamicScale, maxScale), maxScale);
+
+		if (newScale != dynamicScale)
+		{
+			dynamicScale = newScale;
+			framesSinceScaleChange = 0;
+			RenderDamage::MarkScene();
+		}
+	}
+
+	void DynamicResolution::Upscale(unsigned int outputFramebuffer)
+	{
+		static const float& sharpness = ConfigFile::GetFloat("graphics_upscaleSharpness");
+
+		//plain bilinear upscale needs no shader at all
+		if (sharpness <= 0.0f)
+		{
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneTarget->framebuffer);
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFramebuffer);
+			glBlitFramebuffer(
+				0, 0, renderWidth, renderHeight,
+				0, 0, outputWidth, outputHeight,
+				GL_COLOR_BUFFER_BIT,
+				GL_LINEAR);
+			return;
+		}
+
+		if (upscaleVAO == 0)
+		{
+			upscaleShader = Shader::LoadShader(
+				Engine::filesPath + "\\shaders\\Upscale.vert",
+				Engine::filesPath + "\\shaders\\Upscale.frag");
+			glGenVertexArrays(1, &upscaleVAO);
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+		glViewport(0, 0, outputWidth, outputHeight);
+
+		GLboolean wasDepthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+		GLboolean wasBlendEnabled = glIsEnabled(GL_BLEND);
+		glDisable(GL_DEPTH_TEST);
+		glDisable(GL_BLEND);
+
+		upscaleShader.Use();
+		upscaleShader.SetInt("sceneTexture", 0);
+		//the scene only covers the bottom left part of the pooled target
+		upscaleShader.SetVec2("texelSize", 1.0f / sceneTarget->width, 1.0f / sceneTarget->height);
+		upscaleShader.SetVec2("uvScale", sceneTarget->GetUVScale());
+		upscaleShader.SetVec2(
+			"uvMax",
+			(renderWidth - 0.5f) / sceneTarget->width,
+			(renderHeight - 0.5f) / sceneTarget->height);
+		upscaleShader.SetFloat("sharpness", min(sharpness, 1.0f));
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, sceneTarget->colorTexture);
+		glBindVertexArray(upscaleVAO);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindVertexArray(0);
+
+		if (wasDepthTestEnabled) glEnable(GL_DEPTH_TEST);
+		if (wasBlendEnabled) glEnable(GL_BLEND);
+	}
+}
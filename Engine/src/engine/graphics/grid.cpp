@@ -3,9 +3,6 @@
 //This is free software, and you are welcome to redistribute it under certain conditions.
 //Read LICENSE.md for more information.
 #if ENGINE_MODE
-#include <vector>
-#include <algorithm>
-
 //external
 #include "glad.h"
 
@@ -18,8 +15,6 @@
 #include "render.hpp"
 
 using glm::mat4;
-using std::vector;
-using std::clamp;
 
 using Graphics::Shader;
 using Core::Engine;
@@ -31,50 +26,11 @@ namespace Graphics
 {
 	void Grid::InitializeGrid()
 	{
-		float lineLength = static_cast<float>(lineCount) / 2;
-
-		for (int i = 0; i < lineCount; ++i)
-		{
-			float offset = 
-				lineDistance * static_cast<float>(i) 
-				- (lineDistance * static_cast<float>(lineCount) * 0.5f);
-
-			// horizontal lines
-			vertices[i * 4 * 3] = offset;
-			vertices[i * 4 * 3 + 1] = 0.0f;
-			vertices[i * 4 * 3 + 2] = lineLength;
-
-			vertices[i * 4 * 3 + 3] = offset;
-			vertices[i * 4 * 3 + 4] = 0.0f;
-			vertices[i * 4 * 3 + 5] = -lineLength;
-
-			// vertical lines
-			vertices[i * 4 * 3 + 6] = lineLength;
-			vertices[i * 4 * 3 + 7] = 0.0f;
-			vertices[i * 4 * 3 + 8] = offset;
-
-			vertices[i * 4 * 3 + 9] = -lineLength;
-			vertices[i * 4 * 3 + 10] = 0.0f;
-			vertices[i * 4 * 3 + 11] = offset;
-		}
-
 		shader = Shader::LoadShader(
 			Engine::filesPath + "\\shaders\\Grid.vert",
 			Engine::filesPath + "\\shaders\\Grid.frag");
 
 		glGenVertexArrays(1, &VAO);
-		glGenBuffers(1, &VBO);
-
-		glBindVertexArray(VAO);
-
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-		glEnableVertexAttribArray(0);
-
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
 	}
 
 	void Grid::RenderGrid(const mat4& view, const mat4& projection)
@@ -83,26 +39,20 @@ namespace Graphics
 		shader.SetMat4("projection", projection);
 		shader.SetMat4("view", view);
 
-		float transparency = stof(ConfigFile::GetValue("grid_transparency"));
+		static const float& transparency = ConfigFile::GetFloat("grid_transparency");
 		shader.SetFloat("transparency", transparency);
 
-		float maxDistance = stof(ConfigFile::GetValue("grid_maxDistance"));
-		fadeDistance = static_cast<float>(maxDistance * 0.9);
-		shader.SetFloat("fadeDistance", fadeDistance);
+		static const float& maxDistance = ConfigFile::GetFloat("grid_maxDistance");
+		shader.SetFloat("fadeDistance", maxDistance * 0.9f);
 		shader.SetFloat("maxDistance", maxDistance);
 		shader.SetVec3("center", Render::camera.GetCameraPosition());
 
-		string gridColorString = ConfigFile::GetValue("grid_color");
-		vector<string> gridColorSplit = String::Split(gridColorString, ',');
-		vec3 color = vec3(
-			stof(gridColorSplit[0]), 
-			stof(gridColorSplit[1]),
-			stof(gridColorSplit[2]));
+		static const vec3& color = ConfigFile::GetVec3("grid_color");
 		shader.SetVec3("color", color);
 
 		glBindVertexArray(VAO);
 
-		glDrawArrays(GL_LINES, 0, lineCount * 4);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
 
 		glBindVertexArray(0);
 	}
@@ -3,7 +3,10 @@
 //This is free software, and you are welcome to redistribute it under certain conditions.
 //Read LICENSE.md for more information.
 
+#include <algorithm>
+
 //external
+#include "magic_enum.hpp"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -23,6 +26,7 @@ using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
 using Type = Core::ConsoleManager::Type;
 using EngineFile::ConfigFile;
+using std::upper_bound;
 
 namespace Graphics::GUI
 {
@@ -36,7 +40,7 @@ namespace Graphics::GUI
 		ImGuiWindowFlags windowFlags =
 			ImGuiWindowFlags_NoCollapse;
 
-		bool renderConsole = stoi(ConfigFile::GetValue("gui_console"));
+		bool renderConsole = ConfigFile::GetBool("gui_console");
 #else
 		int width, height;
 		glfwGetWindowSize(Render::window, &width, &height);
@@ -55,7 +59,7 @@ namespace Graphics::GUI
 		{
 			if (ImGui::Button("Clear"))
 			{
-				consoleMessages.clear();
+				ClearConsole();
 			}
 
 			ImGui::SameLine();
@@ -66,6 +70,53 @@ namespace Graphics::GUI
 			{
 				ConsoleManager::sendDebugMessages = !ConsoleManager::sendDebugMessages;
 			}
+
+			//caller and type filters
+			bool filterChanged = false;
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(120);
+			string callerPreview = callerFilter == -1
+				? "All callers"
+				: string(magic_enum::enum_name(static_cast<Caller>(callerFilter)));
+			if (ImGui::BeginCombo("##callerFilter", callerPreview.c_str()))
+			{
+				if (ImGui::Selectable("All callers", callerFilter == -1))
+				{
+					callerFilter = -1;
+					filterChanged = true;
+				}
+				for (const auto& [value, name] : magic_enum::enum_entries<Caller>())
+				{
+					if (ImGui::Selectable(string(name).c_str(), callerFilter == static_cast<int>(value)))
+					{
+						callerFilter = static_cast<int>(value);
+						filterChanged = true;
+					}
+				}
+				ImGui::EndCombo();
+			}
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(120);
+			string typePreview = typeFilter == -1
+				? "All types"
+				: string(magic_enum::enum_name(static_cast<Type>(typeFilter)));
+			if (ImGui::BeginCombo("##typeFilter", typePreview.c_str()))
+			{
+				if (ImGui::Selectable("All types", typeFilter == -1))
+				{
+					typeFilter = -1;
+					filterChanged = true;
+				}
+				for (const auto& [value, name] : magic_enum::enum_entries<Type>())
+				{
+					if (ImGui::Selectable(string(name).c_str(), typeFilter == static_cast<int>(value)))
+					{
+						typeFilter = static_cast<int>(value);
+						filterChanged = true;
+					}
+				}
+				ImGui::EndCombo();
+			}
 #if ENGINE_MODE
 			ImGui::SameLine();
 			ImGui::SetCursorPosX(ImGui::GetWindowWidth() - 40);
@@ -81,11 +132,37 @@ namespace Graphics::GUI
 			if (ImGui::BeginChild("ScrollingRegion", scrollingRegionSize, true))
 			{
 				float wrapWidth = ImGui::GetContentRegionAvail().x - 10;
+				if (filterChanged
+					|| wrapWidth != cachedWrapWidth
+					|| ImGui::GetFontSize() != cachedFontSize
+					//rebase the accumulated offsets before they lose float precision
+					|| (!visibleOffsets.empty() && visibleOffsets.front() > 1000000.0f))
+				{
+					cachedWrapWidth = wrapWidth;
+					cachedFontSize = ImGui::GetFontSize();
+					RebuildVisibleMessages();
+				}
+
 				ImGui::PushTextWrapPos(ImGui::GetCursorPos().x + wrapWidth);
 
-				//display the content of the text buffer
-				for (const auto& message : consoleMessages)
+				//only lay out the messages that overlap the visible part of the scrolling region,
+				//everything else is skipped using the cached message heights
+				float startY = ImGui::GetCursorPosY();
+				float baseOffset = visibleOffsets.empty() ? 0.0f : visibleOffsets.front();
+				float scrollTop = ImGui::GetScrollY() + baseOffset;
+				float scrollBottom = scrollTop + ImGui::GetWindowHeight();
+
+				auto firstVisible = upper_bound(visibleOffsets.begin(), visibleOffsets.end(), scrollTop);
+				if (firstVisible != visibleOffsets.begin()) --firstVisible;
+
+				for (size_t i = firstVisible - visibleOffsets.begin();
+					i < visibleSequences.size()
+					&& visibleOffsets[i] < scrollBottom;
+					i++)
 				{
+					const string& message = messageRing[visibleSequences[i] % maxConsoleMessages].text;
+
+					ImGui::SetCursorPosY(startY + visibleOffsets[i] - baseOffset);
 					ImGui::TextWrapped("%s", message.c_str());
 
 					if (ImGui::IsItemClicked()
@@ -99,6 +176,10 @@ namespace Graphics::GUI
 					}
 				}
 
+				//reserve the full height so the scrollbar matches all filtered messages
+				ImGui::SetCursorPosY(startY + visibleEnd - baseOffset);
+				ImGui::Dummy(ImVec2(0.0f, 0.0f));
+
 				ImGui::PopTextWrapPos();
 
 				//scrolls to the bottom if scrolling is allowed
@@ -166,14 +247,78 @@ namespace Graphics::GUI
 			ImGui::End();
 		}
 	}
-	void GUIConsole::AddTextToConsole(const string& message)
+	void GUIConsole::AddTextToConsole(const string& message, Caller caller, Type type)
 	{
-		consoleMessages.push_back(message);
+		if (messageRing.empty()) messageRing.resize(maxConsoleMessages);
 
-		//erases the first added message if a new one was added and count exceeded max count
-		while (consoleMessages.size() > maxConsoleMessages)
+		//overwrites the oldest message once the ring is full
+		if (nextSequence - firstSequence == maxConsoleMessages)
 		{
-			consoleMessages.erase(consoleMessages.begin());
+			if (!visibleSequences.empty()
+				&& visibleSequences.front() == firstSequence)
+			{
+				visibleSequences.pop_front();
+				visibleOffsets.pop_front();
+			}
+			firstSequence++;
+		}
+
+		ConsoleMessage& slot = messageRing[nextSequence % maxConsoleMessages];
+		slot.text = message;
+		slot.caller = caller;
+		slot.type = type;
+		slot.height = CalculateMessageHeight(message);
+
+		if (PassesFilter(slot))
+		{
+			visibleSequences.push_back(nextSequence);
+			visibleOffsets.push_back(visibleEnd);
+			visibleEnd += slot.height;
+		}
+
+		nextSequence++;
+	}
+
+	void GUIConsole::ClearConsole()
+	{
+		firstSequence = nextSequence;
+		visibleSequences.clear();
+		visibleOffsets.clear();
+		visibleEnd = 0.0f;
+	}
+
+	bool GUIConsole::PassesFilter(const ConsoleMessage& message)
+	{
+		return (callerFilter == -1 || callerFilter == static_cast<int>(message.caller))
+			&& (typeFilter == -1 || typeFilter == static_cast<int>(message.type));
+	}
+
+	float GUIConsole::CalculateMessageHeight(const string& text)
+	{
+		//heights are calculated once the console has been laid out for the first time
+		if (cachedWrapWidth <= 0.0f) return 0.0f;
+
+		return ImGui::CalcTextSize(text.c_str(), nullptr, false, cachedWrapWidth).y
+			+ ImGui::GetStyle().ItemSpacing.y;
+	}
+
+	void GUIConsole::RebuildVisibleMessages()
+	{
+		visibleSequences.clear();
+		visibleOffsets.clear();
+		visibleEnd = 0.0f;
+
+		for (size_t sequence = firstSequence; sequence < nextSequence; sequence++)
+		{
+			ConsoleMessage& message = messageRing[sequence % maxConsoleMessages];
+			message.height = CalculateMessageHeight(message.text);
+
+			if (PassesFilter(message))
+			{
+				visibleSequences.push_back(sequence);
+				visibleOffsets.push_back(visibleEnd);
+				visibleEnd += message.height;
+			}
 		}
 	}
 }
\ No newline at end of file
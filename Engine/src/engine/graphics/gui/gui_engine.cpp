@@ -28,6 +28,7 @@
 #include "gui_projectitemslist.hpp"
 #include "gui_firstTime.hpp"
 #include "gui_scenewindow.hpp"
+#include "gui_profiler.hpp"
 #include "input.hpp"
 #include "render.hpp"
 #include "stringUtils.hpp"
@@ -45,6 +46,8 @@
 #include "fileexplorer.hpp"
 #include "compile.hpp"
 #include "configFile.hpp"
+#include "projectDirectory.hpp"
+#include "profiler.hpp"
 
 using std::cout;
 using std::endl;
@@ -74,7 +77,10 @@ using Graphics::Shape::GameObject;
 using Graphics::Shape::GameObjectManager;
 using EngineFile::SceneFile;
 using EngineFile::ConfigFile;
+using EngineFile::ConfigValue;
 using EngineFile::FileExplorer;
+using EngineFile::ProjectDirectory;
+using Core::ProfileZone;
 using Caller = Core::ConsoleManager::Caller;
 using Type = Core::ConsoleManager::Type;
 using Core::Compilation;
@@ -115,6 +121,11 @@ namespace Graphics::GUI
 		ImGui_ImplGlfw_InitForOpenGL(Render::window, true);
 		ImGui_ImplOpenGL3_Init("#version 330");
 
+		ConfigFile::AddChangeCallback("gui_fontScale", [](const ConfigValue& value)
+			{
+				ImGui::GetIO().FontGlobalScale = value.floatValue;
+			});
+
 		io.Fonts->Clear();
 		io.Fonts->AddFontFromFileTTF((Engine::filesPath + "\\fonts\\coda\\Coda-Regular.ttf").c_str(), 16.0f);
 
@@ -128,7 +139,7 @@ namespace Graphics::GUI
 		ImGuiStyle& style = ImGui::GetStyle();
 
 		ImGuiIO& io = ImGui::GetIO();
-		io.FontGlobalScale = stof(ConfigFile::GetValue("gui_fontScale"));
+		io.FontGlobalScale = ConfigFile::GetFloat("gui_fontScale");
 
 		style.Alpha = 1.0f;
 		style.DisabledAlpha = 0.6000000238418579f;
@@ -232,6 +243,8 @@ namespace Graphics::GUI
 
 	void EngineGUI::Render()
 	{
+		ProfileZone guiZone("EngineGUI::Render", true);
+
 		if (isImguiInitialized)
 		{
 			if (!Engine::IsUserIdle())
@@ -240,6 +253,8 @@ namespace Graphics::GUI
 				ImGui_ImplGlfw_NewFrame();
 				ImGui::NewFrame();
 
+				ProjectDirectory::Update();
+
 				if (!Compilation::renderBuildingWindow) RenderTopBar();
 
 				ImGuiDockNodeFlags dockFlags =
@@ -261,9 +276,10 @@ namespace Graphics::GUI
 					GUILinks::RenderLinksWindow();
 					GUIProjectItemsList::RenderProjectItemsList();
 					GUIFirstTime::RenderFirstTime();
+					GUIProfiler::RenderProfiler();
 				}
 
-				bool renderSceneWindow = stoi(ConfigFile::GetValue("gui_sceneWindow"));
+				bool renderSceneWindow = ConfigFile::GetBool("gui_sceneWindow");
 				if (renderSceneWindow) GUISceneWindow::RenderSceneWindow();
 
 				Compilation::RenderBuildingWindow();
@@ -297,7 +313,7 @@ namespace Graphics::GUI
 
 	void EngineGUI::RenderTopBar()
 	{
-		float fontScale = stof(ConfigFile::GetValue("gui_fontScale"));
+		float fontScale = ConfigFile::GetFloat("gui_fontScale");
 
 		ImGui::BeginMainMenuBar();
 
@@ -714,6 +730,11 @@ namespace Graphics::GUI
 				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
 			}
 
+			if (ImGui::MenuItem("Profiler"))
+			{
+				GUIProfiler::renderProfiler = true;
+			}
+
 			/*
 			* 
 			* DISABLED FOR NOW
@@ -941,6 +962,8 @@ namespace Graphics::GUI
 
 	void EngineGUI::Shutdown()
 	{
+		if (!isImguiInitialized) return;
+
 		isImguiInitialized = false;
 
 		ImGui_ImplOpenGL3_Shutdown();
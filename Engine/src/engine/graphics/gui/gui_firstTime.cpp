@@ -34,7 +34,7 @@ namespace Graphics::GUI
 		ImGuiWindowFlags windowFlags =
 			ImGuiWindowFlags_NoCollapse;
 
-		bool renderFirstTime = stoi(ConfigFile::GetValue("gui_firstTime"));
+		bool renderFirstTime = ConfigFile::GetBool("gui_firstTime");
 
 		if (renderFirstTime
 			&& ImGui::Begin("Welcome", NULL, windowFlags))
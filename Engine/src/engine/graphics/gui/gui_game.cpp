@@ -19,6 +19,7 @@
 #include "configFile.hpp"
 #include "render.hpp"
 #include "gui_console.hpp"
+#include "profiler.hpp"
 
 using std::string;
 using std::filesystem::exists;
@@ -27,6 +28,7 @@ using Core::Engine;
 using Utils::File;
 using EngineFile::ConfigFile;
 using Graphics::Render;
+using Core::ProfileZone;
 
 namespace Graphics::GUI
 {
@@ -70,7 +72,7 @@ namespace Graphics::GUI
 		ImGuiStyle& style = ImGui::GetStyle();
 
 		ImGuiIO& io = ImGui::GetIO();
-		io.FontGlobalScale = stof(ConfigFile::GetValue("gui_fontScale"));
+		io.FontGlobalScale = ConfigFile::GetFloat("gui_fontScale");
 
 		style.Alpha = 1.0f;
 		style.DisabledAlpha = 0.6000000238418579f;
@@ -161,6 +163,8 @@ namespace Graphics::GUI
 
 	void GameGUI::Render()
 	{
+		ProfileZone guiZone("GameGUI::Render", true);
+
 		if (isImguiInitialized)
 		{
 			if (!Engine::IsUserIdle())
@@ -214,6 +218,8 @@ namespace Graphics::GUI
 
 	void GameGUI::Shutdown()
 	{
+		if (!isImguiInitialized) return;
+
 		isImguiInitialized = false;
 
 		ImGui_ImplOpenGL3_Shutdown();
@@ -30,6 +30,7 @@
 #include "gui_projectitemslist.hpp"
 #include "fileUtils.hpp"
 #include "console.hpp"
+#include "projectDirectory.hpp"
 
 using std::cout;
 using std::endl;
@@ -50,6 +51,7 @@ using Core::Input;
 using Graphics::Texture;
 using Core::Engine;
 using EngineFile::FileExplorer;
+using EngineFile::ProjectDirectory;
 using Utils::String;
 using EngineFile::ConfigFile;
 using Utils::File;
@@ -69,7 +71,7 @@ namespace Graphics::GUI
 		ImGuiWindowFlags windowFlags =
 			ImGuiWindowFlags_NoCollapse;
 
-		bool renderInspector = stoi(ConfigFile::GetValue("gui_inspector"));
+		bool renderInspector = ConfigFile::GetBool("gui_inspector");
 
 		if (renderInspector
 			&& ImGui::Begin("Inpsector", NULL, windowFlags))
@@ -142,11 +144,7 @@ namespace Graphics::GUI
 					string newFolderName = inputTextBuffer_objName;
 					string newFolderPath = Engine::currentGameobjectsPath + "\\" + newFolderName;
 
-					for (const auto& folder : directory_iterator(Engine::currentGameobjectsPath))
-					{
-						foundExisting = (exists(newFolderPath));
-						if (foundExisting) break;
-					}
+					foundExisting = ProjectDirectory::FindEntry(newFolderPath) != nullptr;
 
 					if (foundExisting)
 					{
@@ -286,7 +284,7 @@ namespace Graphics::GUI
 		shared_ptr<GameObject>& obj = Select::selectedObj;
 
 		int height = obj->GetMesh()->GetMeshType() == Mesh::MeshType::model
-			? 75 : 150;
+			? 125 : 150;
 
 		ImGuiChildFlags childWindowFlags{};
 
@@ -299,6 +297,33 @@ namespace Graphics::GUI
 			string objTypeValue = "Mesh type: " + string(magic_enum::enum_name(objType)) + "   ";
 			ImGui::Text(objTypeValue.c_str());
 
+			if (obj->GetMesh()->GetMeshType() == Mesh::MeshType::model)
+			{
+				bool occluderState = obj->GetMesh()->IsOccluder();
+				if (ImGui::Checkbox("Occluder", &occluderState))
+				{
+					obj->GetMesh()->SetOccluder(occluderState);
+
+					if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+				}
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Always used to hide other models from occlusion culling, regardless of its size.");
+				}
+
+				bool staticState = obj->IsStatic();
+				if (ImGui::Checkbox("Static", &staticState))
+				{
+					obj->SetStatic(staticState);
+
+					if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+				}
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("The model never moves in the game, the game build merges it with static models of the same material.");
+				}
+			}
+
 			if (obj->GetMesh()->GetMeshType() != Mesh::MeshType::model)
 			{
 				bool meshState = obj->GetMesh()->IsEnabled();
@@ -0,0 +1,246 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+#if ENGINE_MODE
+#include <vector>
+#include <string>
+#include <algorithm>
+
+//external
+#include "imgui.h"
+#include "imgui_impl_glfw.h"
+#include "imgui_impl_opengl3.h"
+#include "imgui_internal.h"
+
+//engine
+#include "gui_profiler.hpp"
+#include "gui_engine.hpp"
+#include "core.hpp"
+
+using std::vector;
+using std::string;
+using std::to_string;
+using std::max;
+
+using Core::Engine;
+using Core::Profiler;
+using Core::ProfileZoneData;
+
+namespace Graphics::GUI
+{
+	void GUIProfiler::RenderProfiler()
+	{
+		ImGui::SetNextWindowSizeConstraints(ImVec2(400, 300), ImVec2(3000, 2000));
+		ImGui::SetNextWindowSize(ImVec2(800, 500), ImGuiCond_FirstUseEver);
+		ImGui::SetNextWindowPos(ImVec2(300, 300), ImGuiCond_FirstUseEver);
+
+		ImGuiWindowFlags windowFlags =
+			ImGuiWindowFlags_NoCollapse;
+
+		if (renderProfiler
+			&& ImGui::Begin("Profiler", NULL, windowFlags))
+		{
+			if (ImGui::Checkbox("Enabled", &Profiler::isEnabled))
+			{
+				Profiler::ClearHistory();
+				selectedFrame = -1;
+			}
+			ImGui::SameLine();
+			ImGui::Checkbox("Pause", &Profiler::isPaused);
+			ImGui::SameLine();
+			if (ImGui::Button("Clear"))
+			{
+				Profiler::ClearHistory();
+				selectedFrame = -1;
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Export Chrome trace"))
+			{
+				Profiler::ExportChromeTrace(Engine::docsPath + "\\profiler_trace.json");
+			}
+
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(ImGui::GetWindowWidth() - 40);
+			if (ImGui::Button("X"))
+			{
+				renderProfiler = false;
+			}
+
+			const auto& history = Profiler::GetHistory();
+			if (history.empty())
+			{
+				ImGui::Text(Profiler::isEnabled
+					? "Waiting for frames..."
+					: "Enable the profiler to start recording frames.");
+			}
+			else
+			{
+				if (selectedFrame >= static_cast<int>(history.size())) selectedFrame = -1;
+
+				RenderFrameGraph();
+
+				const ProfileFrame& frame = selectedFrame == -1
+					? history.back()
+					: history[selectedFrame];
+
+				RenderTimeline(frame);
+				RenderZoneTable(frame);
+			}
+
+			ImGui::End();
+		}
+	}
+
+	void GUIProfiler::RenderFrameGraph()
+	{
+		const auto& history = Profiler::GetHistory();
+
+		vector<float> cpuTimes;
+		vector<float> gpuTimes;
+		cpuTimes.reserve(history.size());
+		gpuTimes.reserve(history.size());
+		float maxTime = 1.0f;
+		for (const auto& frame : history)
+		{
+			float cpuTime = static_cast<float>(frame.cpuEnd - frame.cpuStart);
+			float gpuTime = static_cast<float>(max(frame.gpuTime, 0.0));
+			cpuTimes.push_back(cpuTime);
+			gpuTimes.push_back(gpuTime);
+			maxTime = max(maxTime, max(cpuTime, gpuTime));
+		}
+
+		float graphWidth = ImGui::GetContentRegionAvail().x;
+		ImGui::PlotLines("##cpuFrames", cpuTimes.data(), static_cast<int>(cpuTimes.size()), 0, "CPU ms", 0.0f, maxTime, ImVec2(graphWidth, 50));
+
+		//click on the graph to inspect an older frame
+		if (ImGui::IsItemClicked())
+		{
+			float mouseX = ImGui::GetIO().MousePos.x - ImGui::GetItemRectMin().x;
+			selectedFrame = static_cast<int>(mouseX / graphWidth * static_cast<float>(history.size()));
+		}
+
+		ImGui::PlotLines("##gpuFrames", gpuTimes.data(), static_cast<int>(gpuTimes.size()), 0, "GPU ms", 0.0f, maxTime, ImVec2(graphWidth, 50));
+
+		if (selectedFrame != -1)
+		{
+			if (ImGui::Button("Follow newest frame")) selectedFrame = -1;
+			ImGui::SameLine();
+		}
+		ImGui::Text("Click the CPU graph to inspect a frame. %d frames recorded, gpu results are %d frames behind.",
+			static_cast<int>(history.size()),
+			Profiler::frameLatency);
+	}
+
+	void GUIProfiler::RenderTimeline(const ProfileFrame& frame)
+	{
+		double frameStart = frame.cpuStart;
+		double frameEnd = frame.cpuEnd;
+		for (const auto& zone : frame.zones)
+		{
+			frameEnd = max(frameEnd, max(zone.cpuEnd, zone.gpuEnd));
+		}
+		double frameDuration = max(frameEnd - frameStart, 0.001);
+
+		int maxDepth = 0;
+		for (const auto& zone : frame.zones) maxDepth = max(maxDepth, zone.depth);
+
+		const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+		const float trackHeight = rowHeight * static_cast<float>(maxDepth + 1);
+
+		ImGui::Text("Frame %llu: CPU %.3f ms, GPU %s",
+			frame.index,
+			frame.cpuEnd - frame.cpuStart,
+			frame.gpuTime >= 0.0 ? (to_string(frame.gpuTime) + " ms").c_str() : "-");
+
+		ImVec2 origin = ImGui::GetCursorScreenPos();
+		float width = ImGui::GetContentRegionAvail().x;
+		float height = trackHeight * 2 + rowHeight;
+		ImGui::InvisibleButton("##timeline", ImVec2(width, height));
+		bool isHovered = ImGui::IsItemHovered();
+		ImVec2 mouse = ImGui::GetIO().MousePos;
+
+		ImDrawList* drawList = ImGui::GetWindowDrawList();
+		drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(30, 30, 30, 255));
+
+		auto DrawZone = [&](const ProfileZoneData& zone, double start, double end, float trackY, ImU32 color)
+			{
+				float x0 = origin.x + static_cast<float>((start - frameStart) / frameDuration) * width;
+				float x1 = origin.x + static_cast<float>((end - frameStart) / frameDuration) * width;
+				x1 = max(x1, x0 + 1.0f);
+				float y0 = trackY + rowHeight * static_cast<float>(zone.depth);
+				float y1 = y0 + rowHeight - 1.0f;
+
+				drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), color);
+				if (x1 - x0 > 30.0f)
+				{
+					drawList->PushClipRect(ImVec2(x0, y0), ImVec2(x1, y1), true);
+					drawList->AddText(ImVec2(x0 + 2.0f, y0), IM_COL32(255, 255, 255, 255), zone.name);
+					drawList->PopClipRect();
+				}
+
+				if (isHovered
+					&& mouse.x >= x0 && mouse.x <= x1
+					&& mouse.y >= y0 && mouse.y <= y1)
+				{
+					ImGui::SetTooltip("%s\n%.3f ms", zone.name, end - start);
+				}
+			};
+
+		float cpuTrackY = origin.y;
+		float gpuTrackY = origin.y + trackHeight + rowHeight;
+		drawList->AddText(ImVec2(origin.x + 2.0f, gpuTrackY - rowHeight), IM_COL32(180, 180, 180, 255), "GPU");
+
+		for (const auto& zone : frame.zones)
+		{
+			DrawZone(zone, zone.cpuStart, zone.cpuEnd, cpuTrackY, IM_COL32(70, 130, 180, 255));
+			if (zone.gpuStart >= 0.0)
+			{
+				DrawZone(zone, zone.gpuStart, zone.gpuEnd, gpuTrackY, IM_COL32(180, 100, 60, 255));
+			}
+		}
+	}
+
+	void GUIProfiler::RenderZoneTable(const ProfileFrame& frame)
+	{
+		ImGuiTableFlags tableFlags =
+			ImGuiTableFlags_Borders
+			| ImGuiTableFlags_RowBg
+			| ImGuiTableFlags_ScrollY;
+
+		if (ImGui::BeginTable("##zones", 3, tableFlags))
+		{
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Zone");
+			ImGui::TableSetupColumn("CPU ms");
+			ImGui::TableSetupColumn("GPU ms");
+			ImGui::TableHeadersRow();
+
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int>(frame.zones.size()));
+			while (clipper.Step())
+			{
+				for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+				{
+					const ProfileZoneData& zone = frame.zones[i];
+
+					ImGui::TableNextRow();
+					ImGui::TableSetColumnIndex(0);
+					ImGui::Indent(static_cast<float>(zone.depth) * 10.0f + 0.001f);
+					ImGui::TextUnformatted(zone.name);
+					ImGui::Unindent(static_cast<float>(zone.depth) * 10.0f + 0.001f);
+
+					ImGui::TableSetColumnIndex(1);
+					ImGui::Text("%.3f", zone.cpuEnd - zone.cpuStart);
+
+					ImGui::TableSetColumnIndex(2);
+					if (zone.gpuStart >= 0.0) ImGui::Text("%.3f", zone.gpuEnd - zone.gpuStart);
+					else ImGui::TextUnformatted("-");
+				}
+			}
+
+			ImGui::EndTable();
+		}
+	}
+}
+#endif
@@ -27,6 +27,7 @@
 #include "render.hpp"
 #include "gameobject.hpp"
 #include "sceneFile.hpp"
+#include "projectDirectory.hpp"
 
 using std::filesystem::path;
 using std::filesystem::directory_iterator;
@@ -41,6 +42,8 @@ using std::ifstream;
 
 using EngineFile::ConfigFile;
 using EngineFile::SceneFile;
+using EngineFile::ProjectDirectory;
+using EngineFile::DirectoryEntry;
 using Core::Engine;
 using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
@@ -63,7 +66,7 @@ namespace Graphics::GUI
 		ImGuiWindowFlags windowFlags =
 			ImGuiWindowFlags_NoCollapse;
 
-		bool renderProjectHierarchy = stof(ConfigFile::GetValue("gui_projectHierarchy"));
+		bool renderProjectHierarchy = ConfigFile::GetBool("gui_projectHierarchy");
 
 		if (renderProjectHierarchy
 			&& ImGui::Begin("Project hierarchy", NULL, windowFlags))
@@ -77,7 +80,7 @@ namespace Graphics::GUI
 
 			if (ImGui::BeginChild("##content"))
 			{
-				DisplayDirectoryContents(path(Engine::projectPath).parent_path().string());
+				DisplayDirectoryContents(ProjectDirectory::GetRoot());
 			}
 			ImGui::EndChild();
 
@@ -85,14 +88,15 @@ namespace Graphics::GUI
 		}
 	}
 
-	void GUIProjectHierarchy::DisplayDirectoryContents(const string& directoryPath)
+	void GUIProjectHierarchy::DisplayDirectoryContents(const DirectoryEntry& directory)
 	{
         static string chosenEntry = "";
         static path toBeDeleted;
-        for (const auto& entry : directory_iterator(directoryPath))
+        for (const auto& child : directory.children)
         {
-            const string fullPath = entry.path().string();
-            const string name = entry.path().filename().string();
+            const string& fullPath = child.fullPath;
+            const string& name = child.name;
+            const path entry = fullPath;
 
             bool isSelected = (chosenEntry == fullPath);
 
@@ -105,7 +109,7 @@ namespace Graphics::GUI
                 ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 0.6f, 1.0f));
             }
 
-            if (entry.is_directory())
+            if (child.isDirectory)
             {
                 bool nodeOpen = ImGui::TreeNodeEx(name.c_str(), nodeFlags);
                 if (ImGui::IsItemClicked())
@@ -168,25 +172,25 @@ namespace Graphics::GUI
                         {
                             if (ImGui::MenuItem("Delete gameobject"))
                             {
-                                for (const auto& child : directory_iterator(entry))
+                                for (const auto& objectChild : child.children)
                                 {
                                     //look for lights
-                                    if (is_regular_file(child)
-                                        && path(child).extension().string() == ".txt")
+                                    if (!objectChild.isDirectory
+                                        && objectChild.extension == ".txt")
                                     {
-                                        string lightTxtFile = path(child).string();
+                                        string lightTxtFile = objectChild.fullPath;
                                         GameObjectManager::FindAndDestroyGameObject(lightTxtFile);
 
                                         break;
                                     }
-                                    else if (is_directory(child))
+                                    else if (objectChild.isDirectory)
                                     {
-                                        for (const auto& secondChild : directory_iterator(child))
+                                        for (const auto& secondChild : objectChild.children)
                                         {
-                                            if (is_regular_file(secondChild)
-                                                && path(secondChild).extension().string() == ".txt")
+                                            if (!secondChild.isDirectory
+                                                && secondChild.extension == ".txt")
                                             {
-                                                string modelTxtFile = path(secondChild).string();
+                                                string modelTxtFile = secondChild.fullPath;
                                                 GameObjectManager::FindAndDestroyGameObject(modelTxtFile);
 
                                                 break;
@@ -204,7 +208,7 @@ namespace Graphics::GUI
 
                 if (nodeOpen)
                 {
-                    DisplayDirectoryContents(fullPath);
+                    DisplayDirectoryContents(child);
                     ImGui::TreePop();
                 }
             }
@@ -21,6 +21,7 @@
 #include "console.hpp"
 #include "gui_engine.hpp"
 #include "gui_settings.hpp"
+#include "projectDirectory.hpp"
 
 using std::filesystem::path;
 using std::filesystem::exists;
@@ -32,6 +33,8 @@ using std::exception;
 using Graphics::Shape::GameObjectManager;
 using Core::Engine;
 using EngineFile::SceneFile;
+using EngineFile::ProjectDirectory;
+using EngineFile::DirectoryEntry;
 using Graphics::Texture;
 using Core::ConsoleManager;
 using ConsoleCaller = Core::ConsoleManager::Caller;
@@ -92,33 +95,37 @@ namespace Graphics::GUI
 			case Type::SkyboxTexture_back:
 			case Type::GameobjectTexture:
 			{
-				for (const auto& entry : directory_iterator(Engine::texturesPath))
+				const DirectoryEntry* texturesFolder = ProjectDirectory::FindEntry(Engine::texturesPath);
+				if (texturesFolder == nullptr) break;
+
+				for (const auto& entry : texturesFolder->children)
 				{
-					if (is_regular_file(entry))
+					if (!entry.isDirectory
+						&& (entry.extension == ".png"
+						|| entry.extension == ".jpg"
+						|| entry.extension == ".jpeg"))
 					{
-						string extension = path(entry).extension().string();
-						if (extension == ".png"
-							|| extension == ".jpg"
-							|| extension == ".jpeg")
-						{
-							content.push_back(entry.path().string());
-						}
+						content.push_back(entry.fullPath);
 					}
 				}
 				break;
 			}
 			case Type::Scene:
 			{
-				for (const auto& entry : directory_iterator(path(Engine::scenePath).parent_path().parent_path().string()))
+				const DirectoryEntry* scenesFolder = ProjectDirectory::FindEntry(
+					path(Engine::scenePath).parent_path().parent_path().string());
+				if (scenesFolder == nullptr) break;
+
+				for (const auto& entry : scenesFolder->children)
 				{
-					if (is_directory(entry))
+					if (entry.isDirectory)
 					{
-						for (const auto& child : directory_iterator(entry))
+						for (const auto& child : entry.children)
 						{
-							if (is_regular_file(child)
-								&& child.path().filename().string() == "scene.txt")
+							if (!child.isDirectory
+								&& child.name == "scene.txt")
 							{
-								content.push_back(entry.path().string());
+								content.push_back(entry.fullPath);
 								break;
 							}
 						}
@@ -169,15 +176,7 @@ namespace Graphics::GUI
 					}
 					case Type::Scene:
 					{
-						for (const auto& child : directory_iterator(entry))
-						{
-							if (is_regular_file(child)
-								&& child.path().filename().string() == "scene.txt")
-							{
-								selectedPath = child.path().string();
-								break;
-							}
-						}
+						selectedPath = entry + "\\scene.txt";
 						break;
 					}
 					}
@@ -55,7 +55,7 @@ namespace Graphics::GUI
 		ImGuiWindowFlags windowFlags =
 			ImGuiWindowFlags_NoCollapse;
 
-		bool renderSceneHierarchy = stoi(ConfigFile::GetValue("gui_sceneHierarchy"));
+		bool renderSceneHierarchy = ConfigFile::GetBool("gui_sceneHierarchy");
 
 		if (renderSceneHierarchy
 			&& ImGui::Begin("Scene hierarchy", NULL, windowFlags))
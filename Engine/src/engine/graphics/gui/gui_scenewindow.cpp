@@ -27,6 +27,11 @@
 #include "gameobject.hpp"
 #include "stringUtils.hpp"
 #include "timeManager.hpp"
+#include "renderDamage.hpp"
+#include "framePacer.hpp"
+#include "dynamicResolution.hpp"
+#include "renderTargetPool.hpp"
+#include "occlusionCulling.hpp"
 
 using std::shared_ptr;
 using std::vector;
@@ -42,6 +47,12 @@ using Graphics::Shape::GameObjectManager;
 using Graphics::Shape::GameObject;
 using Utils::String;
 using Core::TimeManager;
+using Graphics::RenderDamage;
+using Core::FramePacer;
+using Graphics::DynamicResolution;
+using Graphics::RenderTargetPool;
+using Graphics::OcclusionCulling;
+using glm::vec2;
 
 namespace Graphics::GUI
 {
@@ -112,28 +123,24 @@ namespace Graphics::GUI
 			framebufferWidth = static_cast<int>(renderSize.x);
 			framebufferHeight = static_cast<int>(renderSize.y);
 
-			glBindTexture(GL_TEXTURE_2D, Render::textureColorbuffer);
-			glTexImage2D(
-				GL_TEXTURE_2D,
-				0,
-				GL_RGB,
-				framebufferWidth,
-				framebufferHeight,
-				0,
-				GL_RGB,
-				GL_UNSIGNED_BYTE,
-				NULL);
+			Camera::aspectRatio = targetAspectRatio;
 
-			glBindRenderbuffer(GL_RENDERBUFFER, Render::rbo);
-			glRenderbufferStorage(
-				GL_RENDERBUFFER,
-				GL_DEPTH24_STENCIL8,
-				framebufferWidth,
-				framebufferHeight);
+			DynamicResolution::SetOutputSize(framebufferWidth, framebufferHeight);
 
-			Camera::aspectRatio = targetAspectRatio;
+			//the scene has to be drawn again at the new size
+			RenderDamage::MarkScene();
+		}
 
-			glViewport(0, 0, framebufferWidth, framebufferHeight);
+		//the pooled target only gets reallocated when the size leaves its bucket,
+		//a new target has no image until the scene is drawn into it again
+		if (RenderTargetPool::Fit(
+			Render::sceneTarget,
+			framebufferWidth,
+			framebufferHeight,
+			GL_RGB8,
+			true))
+		{
+			RenderDamage::MarkScene();
 		}
 
 		isSceneSelected = ImGui::IsWindowFocused();
@@ -172,12 +179,13 @@ namespace Graphics::GUI
 		}
 		else ImGui::ResetMouseDragDelta();
 
-		//render to imgui image and flip the Y-axis
+		//render the used part of the target to imgui image and flip the Y-axis
+		vec2 uvScale = Render::sceneTarget->GetUVScale();
 		ImGui::Image(
-			(void*)(intptr_t)Render::textureColorbuffer,
+			(void*)(intptr_t)Render::sceneTarget->colorTexture,
 			renderSize,
-			ImVec2(0, 1),
-			ImVec2(1, 0));
+			ImVec2(0, uvScale.y),
+			ImVec2(uvScale.x, 0));
 
 		//makes sure none of the interactable scene window buttons are displayed
 		//while game is being compiled
@@ -316,7 +324,7 @@ namespace Graphics::GUI
 			ImGui::Text("Toggle VSync");
 			ImGui::SameLine();
 			ImGui::SetCursorPosX(ImGui::GetWindowWidth() - 50);
-			bool vsyncEnabled = stoi(ConfigFile::GetValue("window_vsync"));
+			bool vsyncEnabled = ConfigFile::GetBool("window_vsync");
 			if (ImGui::Checkbox("##vsync", &vsyncEnabled))
 			{
 				glfwSwapInterval(vsyncEnabled ? 1 : 0);
@@ -324,10 +332,163 @@ namespace Graphics::GUI
 				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
 			}
 
+			ImGui::Text("Render on demand");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(ImGui::GetWindowWidth() - 50);
+			bool renderOnDemand = ConfigFile::GetBool("window_renderOnDemand");
+			if (ImGui::Checkbox("##renderOnDemand", &renderOnDemand))
+			{
+				ConfigFile::SetValue("window_renderOnDemand", to_string(renderOnDemand));
+				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+			}
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip("Only redraws the scene when the camera, viewport or scene changes.");
+			}
+
+			ImGui::Text("Depth pre-pass");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(ImGui::GetWindowWidth() - 50);
+			bool depthPrepass = ConfigFile::GetBool("graphics_depthPrepass");
+			if (ImGui::Checkbox("##depthPrepass", &depthPrepass))
+			{
+				ConfigFile::SetValue("graphics_depthPrepass", to_string(depthPrepass));
+				RenderDamage::MarkScene();
+				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+			}
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip("Draws the depth of all models first so lighting only runs for visible pixels.");
+			}
+
+			ImGui::Text("Occlusion culling");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(ImGui::GetWindowWidth() - 50);
+			bool occlusionCulling = ConfigFile::GetBool("graphics_occlusionCulling");
+			if (ImGui::Checkbox("##occlusionCulling", &occlusionCulling))
+			{
+				ConfigFile::SetValue("graphics_occlusionCulling", to_string(occlusionCulling));
+				RenderDamage::MarkScene();
+				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+			}
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip("Skips models hidden behind large models or models marked as occluders.");
+			}
+			if (occlusionCulling)
+			{
+				ImGui::Text(
+					"Occluders: %d, culled %d of %d models",
+					OcclusionCulling::GetOccluderCount(),
+					OcclusionCulling::GetCulledCount(),
+					OcclusionCulling::GetTestedCount());
+			}
+
+			ImGui::Text("Render scale");
+			float renderScale = ConfigFile::GetFloat("graphics_renderScale");
+			if (ImGui::SliderFloat("##renderScale", &renderScale, 0.25f, 1.0f, "%.2f"))
+			{
+				ConfigFile::SetValue("graphics_renderScale", to_string(renderScale));
+				RenderDamage::MarkScene();
+				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+			}
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip("Fraction of the panel resolution the scene is rendered at before it is upscaled.");
+			}
+
+			ImGui::Text("Dynamic resolution");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(ImGui::GetWindowWidth() - 50);
+			bool dynamicResolution = ConfigFile::GetBool("graphics_dynamicResolution");
+			if (ImGui::Checkbox("##dynamicResolution", &dynamicResolution))
+			{
+				ConfigFile::SetValue("graphics_dynamicResolution", to_string(dynamicResolution));
+				RenderDamage::MarkScene();
+				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+			}
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip("Lowers the render scale while the scene takes longer than the gpu budget.");
+			}
+
+			if (dynamicResolution)
+			{
+				ImGui::Text("GPU budget (ms)");
+				float gpuBudget = ConfigFile::GetFloat("graphics_gpuBudget");
+				if (ImGui::DragFloat("##gpuBudget", &gpuBudget, 0.1f, 1.0f, 100.0f, "%.1f"))
+				{
+					if (gpuBudget > 100.0f) gpuBudget = 100.0f;
+					if (gpuBudget < 1.0f) gpuBudget = 1.0f;
+
+					ConfigFile::SetValue("graphics_gpuBudget", to_string(gpuBudget));
+					if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+				}
+			}
+
+			ImGui::Text("Upscale sharpness");
+			float upscaleSharpness = ConfigFile::GetFloat("graphics_upscaleSharpness");
+			if (ImGui::SliderFloat("##upscaleSharpness", &upscaleSharpness, 0.0f, 1.0f, "%.2f"))
+			{
+				ConfigFile::SetValue("graphics_upscaleSharpness", to_string(upscaleSharpness));
+				RenderDamage::MarkScene();
+				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+			}
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip("0 upscales with a plain bilinear blit.");
+			}
+
+			ImGui::Text(
+				"Scene: %dx%d (%.0f%%), gpu %.2f ms",
+				DynamicResolution::GetRenderWidth(),
+				DynamicResolution::GetRenderHeight(),
+				DynamicResolution::GetScale() * 100.0f,
+				DynamicResolution::GetGPUTime());
+
+			ImGui::Text("Target FPS");
+			int targetFPS = ConfigFile::GetInt("window_targetFPS");
+			if (ImGui::DragInt("##targetFPS", &targetFPS, 1.0f, 0, 500))
+			{
+				if (targetFPS > 500) targetFPS = 500;
+				if (targetFPS < 0) targetFPS = 0;
+
+				ConfigFile::SetValue("window_targetFPS", to_string(targetFPS));
+				FramePacer::ResetJitterHistogram();
+				if (!SceneFile::unsavedChanges) Render::SetWindowNameAsUnsaved(true);
+			}
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip("0 follows the monitor refresh rate while vsync is off.");
+			}
+
+			const auto& jitterHistogram = FramePacer::GetJitterHistogram();
+			char jitterOverlay[32];
+			snprintf(jitterOverlay, sizeof(jitterOverlay), "worst %.2f ms", FramePacer::GetWorstJitter());
+			ImGui::PlotHistogram(
+				"##frameJitter",
+				jitterHistogram.data(),
+				static_cast<int>(jitterHistogram.size()),
+				0,
+				jitterOverlay,
+				0.0f,
+				FLT_MAX,
+				ImVec2(ImGui::GetContentRegionAvail().x - 60, 40));
+			if (ImGui::IsItemHovered())
+			{
+				ImGui::SetTooltip(
+					"Frame time error against the target, %.2f ms per bar from -%.1f ms to +%.1f ms.",
+					FramePacer::jitterBucketWidth,
+					FramePacer::jitterBucketWidth * (FramePacer::jitterBucketCount / 2 - 1),
+					FramePacer::jitterBucketWidth * (FramePacer::jitterBucketCount / 2 - 1));
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Reset##frameJitter")) FramePacer::ResetJitterHistogram();
+
 			ImGui::Text("Toggle aspect ratio");
 			ImGui::SameLine();
 			ImGui::SetCursorPosX(ImGui::GetWindowWidth() - 100);
-			currentIndex = stoi(ConfigFile::GetValue("aspect_ratio"));
+			currentIndex = ConfigFile::GetInt("aspect_ratio");
 			string aspectRatioValue = aspectRatio[currentIndex];
 			if (ImGui::Button(aspectRatioValue.c_str()))
 			{
@@ -369,7 +530,7 @@ namespace Graphics::GUI
 			ImGui::Separator();
 
 			ImGui::Text("FOV");
-			float fov = stof(ConfigFile::GetValue("camera_fov"));
+			float fov = ConfigFile::GetFloat("camera_fov");
 			if (ImGui::DragFloat("##fov", &fov, 0.1f, 70.0f, 110.0f))
 			{
 				if (fov > 110.0f) fov = 110.0f;
@@ -380,8 +541,8 @@ namespace Graphics::GUI
 			}
 
 			ImGui::Text("Camera near clip");
-			float nearClip = stof(ConfigFile::GetValue("camera_nearClip"));
-			float farClip = stof(ConfigFile::GetValue("camera_farClip"));
+			float nearClip = ConfigFile::GetFloat("camera_nearClip");
+			float farClip = ConfigFile::GetFloat("camera_farClip");
 			if (ImGui::DragFloat("##camNearClip", &nearClip, 0.1f, 0.001f, farClip - 0.001f))
 			{
 				if (nearClip > farClip - 0.001f) nearClip = farClip - 0.001f;
@@ -404,7 +565,7 @@ namespace Graphics::GUI
 			}
 
 			ImGui::Text("Camera move speed multiplier");
-			float moveSpeed = stof(ConfigFile::GetValue("camera_speedMultiplier"));
+			float moveSpeed = ConfigFile::GetFloat("camera_speedMultiplier");
 			if (ImGui::DragFloat("##camMoveSpeed", &moveSpeed, 0.1f, 0.1f, 100.0))
 			{
 				if (moveSpeed > 100.0f) moveSpeed = 100.0f;
@@ -427,12 +588,7 @@ namespace Graphics::GUI
 			ImGui::Separator();
 
 			ImGui::Text("Grid color");
-			string gridColorString = ConfigFile::GetValue("grid_color");
-			vector<string> gridColorSplit = String::Split(gridColorString, ',');
-			vec3 gridColor = vec3(
-				stof(gridColorSplit[0]),
-				stof(gridColorSplit[1]),
-				stof(gridColorSplit[2]));
+			vec3 gridColor = ConfigFile::GetVec3("grid_color");
 			if (ImGui::ColorEdit3("##gridColor", value_ptr(gridColor)))
 			{
 				string finalString =
@@ -451,7 +607,7 @@ namespace Graphics::GUI
 			}
 
 			ImGui::Text("Grid transparency");
-			float gridTransparency = stof(ConfigFile::GetValue("grid_transparency"));
+			float gridTransparency = ConfigFile::GetFloat("grid_transparency");
 			if (ImGui::DragFloat("##gridTransparency", &gridTransparency, 0.001f, 0.0f, 1.0f))
 			{
 				if (gridTransparency > 1.0f) gridTransparency = 1.0f;
@@ -462,7 +618,7 @@ namespace Graphics::GUI
 			}
 
 			ImGui::Text("Grid max distance");
-			float gridMaxDistance = stof(ConfigFile::GetValue("grid_maxDistance"));
+			float gridMaxDistance = ConfigFile::GetFloat("grid_maxDistance");
 
 			if (gridMaxDistance > farClip)
 			{
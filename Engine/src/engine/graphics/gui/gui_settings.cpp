@@ -136,7 +136,7 @@ namespace Graphics::GUI
 	{
 		ImGuiStyle& style = ImGui::GetStyle();
 
-		float fontScale = stof(ConfigFile::GetValue("gui_fontScale"));
+		float fontScale = ConfigFile::GetFloat("gui_fontScale");
 		ImGui::Text("Font scale");
 
 		if (ImGui::DragFloat("##fontScale", &fontScale, 0.01f, 0.1f, 2.0f))
@@ -0,0 +1,435 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <emmintrin.h>
+
+//engine
+#include "occlusionCulling.hpp"
+#include "jobSystem.hpp"
+#include "texture.hpp"
+#include "profiler.hpp"
+
+using std::max;
+using std::min;
+using std::sort;
+using std::fill;
+using std::floor;
+using std::ceil;
+using glm::length;
+using glm::mix;
+
+using Core::JobSystem;
+using Core::JobCounter;
+using Core::ProfileZone;
+using Graphics::Shape::Material;
+using Graphics::Shape::AssimpVertex;
+using Type = Graphics::Shape::Mesh::MeshType;
+
+namespace Graphics
+{
+	static int GetLevelSize(int size, size_t level)
+	{
+		return max(size >> level, 1);
+	}
+
+	void OcclusionCulling::Update(
+		const vector<shared_ptr<GameObject>>& objects,
+		const mat4& view,
+		const mat4& projection)
+	{
+		ProfileZone updateZone("OcclusionCulling::Update");
+
+		mat4 viewProjection = projection * view;
+
+		CollectOccluders(objects, viewProjection);
+
+		//the worker draws the occluders while this thread projects the boxes that get tested
+		JobCounter rasterCounter;
+		if (occluderCount > 0) JobSystem::Run([]() { RasterizeOccluders(); }, &rasterCounter);
+
+		screenBounds.resize(objects.size());
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			const shared_ptr<GameObject>& obj = objects[i];
+			const shared_ptr<Mesh>& mesh = obj->GetMesh();
+			if (!obj->IsEnabled()
+				|| mesh->GetMeshType() != Type::model)
+			{
+				screenBounds[i] = {};
+				screenBounds[i].isAlwaysVisible = true;
+				continue;
+			}
+
+			screenBounds[i] = ProjectBounds(
+				mesh->GetBoundsMin(),
+				mesh->GetBoundsMax(),
+				viewProjection * obj->GetTransform()->GetRenderMatrix());
+		}
+
+		JobSystem::Wait(rasterCounter);
+
+		visibility.assign(objects.size(), 1);
+		testedCount = 0;
+		culledCount = 0;
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			if (screenBounds[i].isAlwaysVisible) continue;
+
+			testedCount++;
+			if (!TestBounds(screenBounds[i]))
+			{
+				visibility[i] = 0;
+				culledCount++;
+			}
+		}
+	}
+
+	void OcclusionCulling::Clear()
+	{
+		occluders.clear();
+		visibility.clear();
+
+		occluderCount = 0;
+		testedCount = 0;
+		culledCount = 0;
+	}
+
+	void OcclusionCulling::CollectOccluders(const vector<shared_ptr<GameObject>>& objects, const mat4& viewProjection)
+	{
+		occluders.clear();
+
+		for (const auto& obj : objects)
+		{
+			const shared_ptr<Mesh>& mesh = obj->GetMesh();
+			if (!obj->IsEnabled()
+				|| mesh->GetMeshType() != Type::model
+				|| mesh->GetIndices().size() < 3)
+			{
+				continue;
+			}
+
+			mat4 model = obj->GetTransform()->GetRenderMatrix();
+			vec3 boundsMin = mesh->GetBoundsMin();
+			vec3 boundsMax = mesh->GetBoundsMax();
+			float size = length(vec3(model * vec4(boundsMax - boundsMin, 0.0f)));
+
+			if (!mesh->IsOccluder())
+			{
+				if (size < minOccluderSize
+					|| mesh->GetIndices().size() / 3 > maxOccluderTriangles)
+				{
+					continue;
+				}
+
+				//holes cut by alpha testing would hide objects that are visible through them
+				unsigned int diffuseTexture = obj->GetMaterial()->GetTextureID(Material::TextureType::diffuse);
+				if (Texture::HasAlphaChannel(diffuseTexture)) continue;
+			}
+
+			mat4 modelViewProjection = viewProjection * model;
+			vec4 center = modelViewProjection * vec4((boundsMin + boundsMax) * 0.5f, 1.0f);
+
+			occluders.push_back({ mesh, modelViewProjection, size / max(center.w, 0.1f) });
+		}
+
+		//flagged occluders first, then the ones that cover the most of the screen
+		sort(occluders.begin(), occluders.end(), [](const Occluder& a, const Occluder& b)
+			{
+				if (a.mesh->IsOccluder() != b.mesh->IsOccluder()) return a.mesh->IsOccluder();
+				return a.screenSize > b.screenSize;
+			});
+		if (occluders.size() > maxOccluders) occluders.resize(maxOccluders);
+
+		occluderCount = static_cast<int>(occluders.size());
+	}
+
+	OcclusionCulling::ScreenBounds OcclusionCulling::ProjectBounds(
+		const vec3& minBound,
+		const vec3& maxBound,
+		const mat4& modelViewProjection)
+	{
+		ScreenBounds bounds{};
+
+		vec3 ndcMin = vec3(FLT_MAX);
+		vec3 ndcMax = vec3(-FLT_MAX);
+		for (int i = 0; i < 8; i++)
+		{
+			vec3 corner = vec3(
+				(i & 1) ? maxBound.x : minBound.x,
+				(i & 2) ? maxBound.y : minBound.y,
+				(i & 4) ? maxBound.z : minBound.z);
+			vec4 clip = modelViewProjection * vec4(corner, 1.0f);
+
+			//a box that reaches behind the camera can not be projected, it is simply kept
+			if (clip.w <= 0.0001f)
+			{
+				bounds.isAlwaysVisible = true;
+				return bounds;
+			}
+
+			vec3 ndc = vec3(clip) / clip.w;
+			ndcMin = glm::min(ndcMin, ndc);
+			ndcMax = glm::max(ndcMax, ndc);
+		}
+
+		if (ndcMax.x < -1.0f
+			|| ndcMin.x > 1.0f
+			|| ndcMax.y < -1.0f
+			|| ndcMin.y > 1.0f
+			|| ndcMin.z > 1.0f)
+		{
+			bounds.isOutsideView = true;
+			return bounds;
+		}
+
+		//every pixel the rectangle touches, so the test stays conservative
+		bounds.minX = static_cast<int>(floor((ndcMin.x * 0.5f + 0.5f) * bufferWidth));
+		bounds.maxX = static_cast<int>(floor((ndcMax.x * 0.5f + 0.5f) * bufferWidth));
+		bounds.minY = static_cast<int>(floor((ndcMin.y * 0.5f + 0.5f) * bufferHeight));
+		bounds.maxY = static_cast<int>(floor((ndcMax.y * 0.5f + 0.5f) * bufferHeight));
+		bounds.minX = max(bounds.minX, 0);
+		bounds.minY = max(bounds.minY, 0);
+		bounds.maxX = min(bounds.maxX, bufferWidth - 1);
+		bounds.maxY = min(bounds.maxY, bufferHeight - 1);
+		bounds.minDepth = ndcMin.z * 0.5f + 0.5f;
+
+		return bounds;
+	}
+
+	void OcclusionCulling::RasterizeOccluders()
+	{
+		if (depthPyramid.empty())
+		{
+			for (size_t level = 0; ; level++)
+			{
+				int width = GetLevelSize(bufferWidth, level);
+				int height = GetLevelSize(bufferHeight, level);
+				depthPyramid.emplace_back(static_cast<size_t>(width) * height);
+
+				if (width == 1 && height == 1) break;
+			}
+		}
+
+		fill(depthPyramid[0].begin(), depthPyramid[0].end(), 1.0f);
+
+		for (const auto& occluder : occluders)
+		{
+			const vector<AssimpVertex>& vertices = occluder.mesh->GetVertices();
+			const vector<unsigned int>& indices = occluder.mesh->GetIndices();
+
+			clipVertices.resize(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				clipVertices[i] = occluder.modelViewProjection * vec4(vertices[i].pos, 1.0f);
+			}
+
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				const vec4& a = clipVertices[indices[i]];
+				const vec4& b = clipVertices[indices[i + 1]];
+				const vec4& c = clipVertices[indices[i + 2]];
+
+				//the whole triangle is outside of one side of the frustum
+				if ((a.x > a.w && b.x > b.w && c.x > c.w)
+					|| (a.x < -a.w && b.x < -b.w && c.x < -c.w)
+					|| (a.y > a.w && b.y > b.w && c.y > c.w)
+					|| (a.y < -a.w && b.y < -b.w && c.y < -c.w)
+					|| (a.z > a.w && b.z > b.w && c.z > c.w))
+				{
+					continue;
+				}
+
+				//distance to the near plane, triangles that cross it are clipped into one or two triangles
+				float distances[3] = { a.z + a.w, b.z + b.w, c.z + c.w };
+				if (distances[0] >= 0.0f
+					&& distances[1] >= 0.0f
+					&& distances[2] >= 0.0f)
+				{
+					RasterizeTriangle(a, b, c);
+					continue;
+				}
+				if (distances[0] < 0.0f
+					&& distances[1] < 0.0f
+					&& distances[2] < 0.0f)
+				{
+					continue;
+				}
+
+				const vec4* input[3] = { &a, &b, &c };
+				vec4 clipped[4]{};
+				int clippedCount = 0;
+				for (int j = 0; j < 3; j++)
+				{
+					int k = (j + 1) % 3;
+					if (distances[j] >= 0.0f) clipped[clippedCount++] = *input[j];
+					if ((distances[j] >= 0.0f) != (distances[k] >= 0.0f))
+					{
+						float t = distances[j] / (distances[j] - distances[k]);
+						clipped[clippedCount++] = mix(*input[j], *input[k], t);
+					}
+				}
+				for (int j = 1; j + 1 < clippedCount; j++)
+				{
+					RasterizeTriangle(clipped[0], clipped[j], clipped[j + 1]);
+				}
+			}
+		}
+
+		BuildDepthPyramid();
+	}
+
+	void OcclusionCulling::RasterizeTriangle(const vec4& v0, const vec4& v1, const vec4& v2)
+	{
+		//clip space to buffer pixels, y points up like in gl
+		auto toScreen = [](const vec4& v)
+			{
+				float inverseW = 1.0f / v.w;
+				return vec3(
+					(v.x * inverseW * 0.5f + 0.5f) * bufferWidth,
+					(v.y * inverseW * 0.5f + 0.5f) * bufferHeight,
+					v.z * inverseW * 0.5f + 0.5f);
+			};
+		vec3 p0 = toScreen(v0);
+		vec3 p1 = toScreen(v1);
+		vec3 p2 = toScreen(v2);
+
+		//back faces are culled on the gpu, so they may not hide anything here either
+		float area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+		if (area <= 0.0f) return;
+
+		//pixels whose center lies inside the bounding rectangle
+		int minX = max(static_cast<int>(ceil(min(min(p0.x, p1.x), p2.x) - 0.5f)), 0);
+		int maxX = min(static_cast<int>(floor(max(max(p0.x, p1.x), p2.x) - 0.5f)), bufferWidth - 1);
+		int minY = max(static_cast<int>(ceil(min(min(p0.y, p1.y), p2.y) - 0.5f)), 0);
+		int maxY = min(static_cast<int>(floor(max(max(p0.y, p1.y), p2.y) - 0.5f)), bufferHeight - 1);
+		if (minX > maxX || minY > maxY) return;
+
+		//rows are walked four pixels at a time, the buffer width is a multiple of four
+		minX &= ~3;
+
+		//edge functions, each one is the weight of the vertex opposite to its edge
+		float stepX0 = p1.y - p2.y;
+		float stepY0 = p2.x - p1.x;
+		float stepX1 = p2.y - p0.y;
+		float stepY1 = p0.x - p2.x;
+		float stepX2 = p0.y - p1.y;
+		float stepY2 = p1.x - p0.x;
+
+		float startX = static_cast<float>(minX) + 0.5f;
+		float startY = static_cast<float>(minY) + 0.5f;
+		float edge0 = (p2.x - p1.x) * (startY - p1.y) - (p2.y - p1.y) * (startX - p1.x);
+		float edge1 = (p0.x - p2.x) * (startY - p2.y) - (p0.y - p2.y) * (startX - p2.x);
+		float edge2 = (p1.x - p0.x) * (startY - p0.y) - (p1.y - p0.y) * (startX - p0.x);
+
+		float inverseArea = 1.0f / area;
+		__m128 depth0 = _mm_set1_ps(p0.z * inverseArea);
+		__m128 depth1 = _mm_set1_ps(p1.z * inverseArea);
+		__m128 depth2 = _mm_set1_ps(p2.z * inverseArea);
+
+		__m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+		__m128 laneStep0 = _mm_set1_ps(stepX0 * 4.0f);
+		__m128 laneStep1 = _mm_set1_ps(stepX1 * 4.0f);
+		__m128 laneStep2 = _mm_set1_ps(stepX2 * 4.0f);
+		__m128 zero = _mm_setzero_ps();
+
+		vector<float>& depth = depthPyramid[0];
+		for (int y = minY; y <= maxY; y++)
+		{
+			__m128 row0 = _mm_add_ps(_mm_set1_ps(edge0), _mm_mul_ps(laneOffsets, _mm_set1_ps(stepX0)));
+			__m128 row1 = _mm_add_ps(_mm_set1_ps(edge1), _mm_mul_ps(laneOffsets, _mm_set1_ps(stepX1)));
+			__m128 row2 = _mm_add_ps(_mm_set1_ps(edge2), _mm_mul_ps(laneOffsets, _mm_set1_ps(stepX2)));
+
+			float* rowDepth = &depth[static_cast<size_t>(y) * bufferWidth];
+			for (int x = minX; x <= maxX; x += 4)
+			{
+				__m128 isInside = _mm_and_ps(
+					_mm_and_ps(_mm_cmpge_ps(row0, zero), _mm_cmpge_ps(row1, zero)),
+					_mm_cmpge_ps(row2, zero));
+
+				if (_mm_movemask_ps(isInside) != 0)
+				{
+					__m128 pixelDepth = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(row0, depth0), _mm_mul_ps(row1, depth1)),
+						_mm_mul_ps(row2, depth2));
+					__m128 oldDepth = _mm_loadu_ps(rowDepth + x);
+					__m128 newDepth = _mm_min_ps(oldDepth, pixelDepth);
+					_mm_storeu_ps(
+						rowDepth + x,
+						_mm_or_ps(_mm_and_ps(isInside, newDepth), _mm_andnot_ps(isInside, oldDepth)));
+				}
+
+				row0 = _mm_add_ps(row0, laneStep0);
+				row1 = _mm_add_ps(row1, laneStep1);
+				row2 = _mm_add_ps(row2, laneStep2);
+			}
+
+			edge0 += stepY0;
+			edge1 += stepY1;
+			edge2 += stepY2;
+		}
+	}
+
+	void OcclusionCulling::BuildDepthPyramid()
+	{
+		for (size_t level = 1; level < depthPyramid.size(); level++)
+		{
+			const vector<float>& source = depthPyramid[level - 1];
+			vector<float>& target = depthPyramid[level];
+			int sourceWidth = GetLevelSize(bufferWidth, level - 1);
+			int sourceHeight = GetLevelSize(bufferHeight, level - 1);
+			int width = GetLevelSize(bufferWidth, level);
+			int height = GetLevelSize(bufferHeight, level);
+
+			for (int y = 0; y < height; y++)
+			{
+				int y0 = min(y * 2, sourceHeight - 1);
+				int y1 = min(y * 2 + 1, sourceHeight - 1);
+				for (int x = 0; x < width; x++)
+				{
+					int x0 = min(x * 2, sourceWidth - 1);
+					int x1 = min(x * 2 + 1, sourceWidth - 1);
+
+					target[static_cast<size_t>(y) * width + x] = max(
+						max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+						max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+				}
+			}
+		}
+	}
+
+	bool OcclusionCulling::TestBounds(const ScreenBounds& bounds)
+	{
+		if (bounds.isAlwaysVisible) return true;
+		if (bounds.isOutsideView) return false;
+		if (occluderCount == 0) return true;
+
+		//the level where the rectangle spans only a few texels, every texel keeps the farthest depth below it
+		size_t level = 0;
+		int size = max(bounds.maxX - bounds.minX, bounds.maxY - bounds.minY) + 1;
+		while (size > 4
+			&& level + 1 < depthPyramid.size())
+		{
+			size = (size + 1) / 2;
+			level++;
+		}
+
+		const vector<float>& depth = depthPyramid[level];
+		int width = GetLevelSize(bufferWidth, level);
+		int height = GetLevelSize(bufferHeight, level);
+		int maxX = min(bounds.maxX >> level, width - 1);
+		int maxY = min(bounds.maxY >> level, height - 1);
+		for (int y = bounds.minY >> level; y <= maxY; y++)
+		{
+			for (int x = bounds.minX >> level; x <= maxX; x++)
+			{
+				if (bounds.minDepth <= depth[static_cast<size_t>(y) * width + x]) return true;
+			}
+		}
+		return false;
+	}
+}
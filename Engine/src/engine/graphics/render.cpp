@@ -31,6 +31,13 @@
 #include "shader.hpp"
 #include "selectobject.hpp"
 #include "skybox.hpp"
+#include "profiler.hpp"
+#include "headless.hpp"
+#include "renderDamage.hpp"
+#include "debugDraw.hpp"
+#include "framePacer.hpp"
+#include "dynamicResolution.hpp"
+#include "renderTargetPool.hpp"
 #if ENGINE_MODE
 #include "compile.hpp"
 #include "grid.hpp"
@@ -66,6 +73,13 @@ using Type = Core::ConsoleManager::Type;
 using EngineFile::ConfigFile;
 using Utils::String;
 using Core::Select;
+using Core::ProfileZone;
+using Core::Headless;
+using Graphics::RenderDamage;
+using Graphics::DebugDraw;
+using Graphics::DynamicResolution;
+using Graphics::RenderTargetPool;
+using Core::FramePacer;
 #if ENGINE_MODE
 using Core::Compilation;
 using Graphics::Grid;
@@ -79,9 +93,6 @@ using Graphics::GUI::GameGUI;
 namespace Graphics
 {
 	Camera Render::camera(Render::window, 0.05f);
-#if ENGINE_MODE
-	unsigned int framebuffer;
-#endif
 
 	void Render::RenderSetup()
 	{
@@ -93,12 +104,17 @@ namespace Graphics
 #endif
 		ContentSetup();
 
+		//headless runs never draw the gui
+		if (!Headless::isEnabled)
+		{
 #if ENGINE_MODE
-		EngineGUI::Initialize();
+			EngineGUI::Initialize();
 #else
-		GameGUI::Initialize();
+			GameGUI::Initialize();
 #endif
+		}
 		TimeManager::InitializeDeltaTime();
+		FramePacer::Initialize();
 
 #if	ENGINE_MODE
 #else
@@ -131,10 +147,25 @@ namespace Graphics
 			Type::DEBUG,
 			"Creating window...\n");
 
+		//headless runs use an invisible window, by default with the native context,
+		//osmesa and egl are opt in because stock glfw builds may not support them
+		if (Headless::isEnabled)
+		{
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+			if (Headless::contextAPI == Headless::ContextAPI::osmesa)
+			{
+				glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+			}
+			else if (Headless::contextAPI == Headless::ContextAPI::egl)
+			{
+				glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+			}
+		}
+
 		//create a window object holding all the windowing data
 		window = glfwCreateWindow(
-			1280,
-			720,
+			Headless::isEnabled ? Headless::width : 1280,
+			Headless::isEnabled ? Headless::height : 720,
 			(Engine::name + " " + Engine::version).c_str(),
 			NULL,
 			NULL);
@@ -150,8 +181,18 @@ namespace Graphics
 
 		glfwMakeContextCurrent(window);
 		glfwSetFramebufferSizeCallback(window, UpdateAfterRescale);
+		glfwSwapInterval(ConfigFile::GetBool("window_vsync"));
+
+		if (Headless::isEnabled)
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::INITIALIZE,
+				Type::DEBUG,
+				"Headless window initialized successfully!\n\n");
+			return;
+		}
+
 		glfwSetWindowSizeLimits(window, 1280, 720, 7680, 4320);
-		glfwSwapInterval(stoi(ConfigFile::GetValue("window_vsync")));
 
 		int width, height, channels;
 		string iconpath = Engine::filesPath + "\\icon.png";
@@ -203,56 +244,8 @@ namespace Graphics
 #if ENGINE_MODE
 	void Render::FramebufferSetup()
 	{
-		//set up framebuffer
-		glGenFramebuffers(1, &framebuffer);
-		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-
-		//set up color attachment texture
-		glGenTextures(1, &textureColorbuffer);
-		glBindTexture(GL_TEXTURE_2D, textureColorbuffer);
-		glTexImage2D(
-			GL_TEXTURE_2D, 
-			0, 
-			GL_RGB, 
-			1280, 
-			720, 
-			0, 
-			GL_RGB, 
-			GL_UNSIGNED_BYTE, 
-			NULL);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glFramebufferTexture2D(
-			GL_FRAMEBUFFER, 
-			GL_COLOR_ATTACHMENT0, 
-			GL_TEXTURE_2D, 
-			textureColorbuffer, 
-			0);
-
-		//set up renderbuffer object 
-		//for depth and stencil attachment
-		glGenRenderbuffers(1, &rbo);
-		glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-		glRenderbufferStorage(
-			GL_RENDERBUFFER, 
-			GL_DEPTH24_STENCIL8, 
-			1280, 
-			720);
-		glFramebufferRenderbuffer(
-			GL_FRAMEBUFFER, 
-			GL_DEPTH_STENCIL_ATTACHMENT, 
-			GL_RENDERBUFFER, 
-			rbo);
-
-		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-		{
-			ConsoleManager::WriteConsoleMessage(
-				Caller::INITIALIZE,
-				Type::EXCEPTION,
-				"Error: Framebuffer is not complete!\n\n");
-			return;
-		}
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		//the scene window resizes the target to its panel size on its first frame
+		RenderTargetPool::Fit(sceneTarget, 1280, 720, GL_RGB8, true);
 	}
 #endif
 	void Render::ContentSetup()
@@ -281,7 +274,7 @@ namespace Graphics
 #endif
 		SkyboxSetup();
 
-		glfwMaximizeWindow(window);
+		if (!Headless::isEnabled) glfwMaximizeWindow(window);
 	}
 
 	void Render::SkyboxSetup()
@@ -305,7 +298,10 @@ namespace Graphics
 
 	void Render::UpdateAfterRescale(GLFWwindow* window, int width, int height)
 	{
+		RenderDamage::MarkScene();
+
 #ifndef ENGINE_MODE
+		DynamicResolution::SetOutputSize(width, height);
 		glViewport(0, 0, width, height);
 		Camera::aspectRatio = static_cast<float>(width) / static_cast<float>(height);
 #endif
@@ -330,13 +326,15 @@ namespace Graphics
 
 	void Render::WindowLoop()
 	{
+		ProfileZone windowLoopZone("Render::WindowLoop", true);
+
 		//camera transformation
 		Input::ProcessKeyboardInput(window);
 
 		//calculate the new projection matrix
-		float fov = stof(ConfigFile::GetValue("camera_fov"));
-		float nearClip = stof(ConfigFile::GetValue("camera_nearClip"));
-		float farClip = stof(ConfigFile::GetValue("camera_farClip"));
+		static const float& fov = ConfigFile::GetFloat("camera_fov");
+		static const float& nearClip = ConfigFile::GetFloat("camera_nearClip");
+		static const float& farClip = ConfigFile::GetFloat("camera_farClip");
 		projection = perspective(
 			radians(fov),
 			Camera::aspectRatio,
@@ -347,32 +345,18 @@ namespace Graphics
 		view = camera.GetViewMatrix();
 
 #if ENGINE_MODE
-		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
-#endif
-		glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
-		glEnable(GL_DEPTH_TEST);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-		if (GameObjectManager::GetSkybox() != nullptr)
+		//the scene framebuffer keeps its last image until something visible changes
+		if (IsSceneDamaged())
 		{
-			mat4 nonConstView = view;
-			Skybox::RenderSkybox(
-				GameObjectManager::GetSkybox(), 
-				nonConstView, 
-				projection);
-		}
+			DynamicResolution::BeginScene(sceneTarget->framebuffer);
+			glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+			glEnable(GL_DEPTH_TEST);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-#if ENGINE_MODE
-		glDepthMask(GL_FALSE);
-		Grid::RenderGrid(view, projection);
-		glDepthMask(GL_TRUE);
-#endif
-		GameObjectManager::RenderAll(view, projection);
+			RenderScene();
+			DynamicResolution::EndScene(sceneTarget->framebuffer);
+		}
 
-#if ENGINE_MODE
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		glClearColor(0.2f, 0.3f, 0.4f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -382,15 +366,121 @@ namespace Graphics
 		//with scene content are called in the Render function
 		EngineGUI::Render();
 #else
+		DynamicResolution::BeginScene(0);
+		glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
+		glEnable(GL_DEPTH_TEST);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		RenderScene();
+		DynamicResolution::EndScene(0);
+
 		GameGUI::Render();
 		Input::SceneWindowInput();
 #endif
 		//swap the front and back buffers
 		glfwSwapBuffers(window);
-		if (!Engine::IsUserIdle())
+		RenderDamage::EndFrame();
+		RenderTargetPool::CollectUnused();
+
+		FramePacer::WaitForNextFrame();
+		WaitForEvents();
+	}
+
+#if ENGINE_MODE
+	bool Render::IsSceneDamaged()
+	{
+		static const bool& renderOnDemand = ConfigFile::GetBool("window_renderOnDemand");
+
+		//camera, viewport and selection changes are compared against the last drawn frame
+		//instead of being marked at every place that can change them
+		static mat4 lastView;
+		static mat4 lastProjection;
+		static const GameObject* lastSelectedObj;
+		static bool lastRenderBillboards;
+		static bool lastRenderLightBorders;
+
+		bool isDamaged = RenderDamage::ConsumeScene()
+			|| !renderOnDemand
+			|| view != lastView
+			|| projection != lastProjection
+			|| Select::selectedObj.get() != lastSelectedObj
+			|| GameObjectManager::renderBillboards != lastRenderBillboards
+			|| GameObjectManager::renderLightBorders != lastRenderLightBorders
+			|| DebugDraw::HasPendingLines();
+
+		if (isDamaged)
+		{
+			lastView = view;
+			lastProjection = projection;
+			lastSelectedObj = Select::selectedObj.get();
+			lastRenderBillboards = GameObjectManager::renderBillboards;
+			lastRenderLightBorders = GameObjectManager::renderLightBorders;
+
+			//keep drawing the gui for a few frames so it shows the new scene state
+			RenderDamage::MarkGUI();
+		}
+
+		return isDamaged;
+	}
+#endif
+
+	void Render::WaitForEvents()
+	{
+		if (Engine::IsUserIdle())
+		{
+			glfwWaitEvents();
+			FramePacer::ResetDeadline();
+			TimeManager::SkipIdleTime();
+			return;
+		}
+
+#if ENGINE_MODE
+		static const bool& renderOnDemand = ConfigFile::GetBool("window_renderOnDemand");
+		static const int& unfocusedFPS = ConfigFile::GetInt("window_unfocusedFPS");
+
+		//seconds between gui refreshes while nothing happens, keeps clocks and watched folders up to date
+		constexpr double idleTimeout = 0.5;
+
+		double timeout = 0.0;
+		bool isIdle = false;
+		if (!glfwGetWindowAttrib(window, GLFW_FOCUSED)
+			&& unfocusedFPS > 0)
 		{
-			glfwPollEvents();
+			timeout = 1.0 / static_cast<double>(unfocusedFPS);
 		}
-		else glfwWaitEvents();
+		else if (renderOnDemand
+			&& !RenderDamage::HasPendingWork())
+		{
+			timeout = idleTimeout;
+			isIdle = true;
+		}
+
+		if (timeout > 0.0)
+		{
+			double waitStart = glfwGetTime();
+			RenderDamage::isWaiting = true;
+			glfwWaitEventsTimeout(timeout);
+			RenderDamage::isWaiting = false;
+
+			if (isIdle)
+			{
+				FramePacer::ResetDeadline();
+				TimeManager::SkipIdleTime();
+			}
+
+			//waking up early means an event arrived, give the gui time to react to it
+			if (glfwGetTime() - waitStart < timeout) RenderDamage::MarkGUI();
+			return;
+		}
+#endif
+		glfwPollEvents();
+	}
+
+	void Render::RenderScene()
+	{
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		GameObjectManager::RenderAll(view, projection);
 	}
 }
\ No newline at end of file
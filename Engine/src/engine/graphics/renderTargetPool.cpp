@@ -0,0 +1,217 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <algorithm>
+#include <string>
+
+//external
+#include "glfw3.h"
+
+//engine
+#include "renderTargetPool.hpp"
+#include "console.hpp"
+
+using std::max;
+using std::make_unique;
+using std::remove_if;
+using std::to_string;
+using std::move;
+
+using Core::ConsoleManager;
+using Caller = Core::ConsoleManager::Caller;
+using Type = Core::ConsoleManager::Type;
+
+namespace Graphics
+{
+	bool RenderTargetPool::Fit(RenderTarget*& target, int width, int height, GLenum colorFormat, bool hasDepth)
+	{
+		width = max(width, 1);
+		height = max(height, 1);
+		double now = glfwGetTime();
+
+		if (target != nullptr
+			&& target->colorFormat == colorFormat
+			&& target->hasDepth == hasDepth
+			&& target->width >= width
+			&& target->height >= height)
+		{
+			//an oversized target is only given back once the smaller size has stayed for a while
+			bool isExact = IsExactBucket(*target, width, height);
+			if (isExact
+				|| now - target->lastFitTime < shrinkTimeout)
+			{
+				if (isExact) target->lastFitTime = now;
+				target->usedWidth = width;
+				target->usedHeight = height;
+				target->lastUsedTime = now;
+				return false;
+			}
+		}
+
+		if (target != nullptr) Release(target);
+		target = Acquire(width, height, colorFormat, hasDepth);
+		return true;
+	}
+
+	RenderTarget* RenderTargetPool::Acquire(int width, int height, GLenum colorFormat, bool hasDepth)
+	{
+		width = max(width, 1);
+		height = max(height, 1);
+		double now = glfwGetTime();
+
+		//a free target of the exact bucket first, otherwise the smallest free one that fits
+		RenderTarget* found = nullptr;
+		for (const auto& target : targets)
+		{
+			if (target->isInUse
+				|| target->colorFormat != colorFormat
+				|| target->hasDepth != hasDepth
+				|| target->width < width
+				|| target->height < height)
+			{
+				continue;
+			}
+
+			if (IsExactBucket(*target, width, height))
+			{
+				found = target.get();
+				break;
+			}
+			if (found == nullptr
+				|| target->width * target->height < found->width * found->height)
+			{
+				found = target.get();
+			}
+		}
+
+		//larger targets are only borrowed while they still fit recently, otherwise a new bucket is allocated
+		if (found != nullptr
+			&& !IsExactBucket(*found, width, height)
+			&& now - found->lastFitTime >= shrinkTimeout)
+		{
+			found = nullptr;
+		}
+
+		if (found == nullptr)
+		{
+			auto newTarget = make_unique<RenderTarget>();
+			newTarget->width = GetBucketSize(width);
+			newTarget->height = GetBucketSize(height);
+			newTarget->colorFormat = colorFormat;
+			newTarget->hasDepth = hasDepth;
+			newTarget->lastFitTime = now;
+			Allocate(*newTarget);
+
+			found = newTarget.get();
+			targets.push_back(move(newTarget));
+		}
+		else if (IsExactBucket(*found, width, height)) found->lastFitTime = now;
+
+		found->isInUse = true;
+		found->usedWidth = width;
+		found->usedHeight = height;
+		found->lastUsedTime = now;
+		return found;
+	}
+
+	void RenderTargetPool::Release(RenderTarget* target)
+	{
+		if (target == nullptr) return;
+
+		target->isInUse = false;
+		target->lastUsedTime = glfwGetTime();
+	}
+
+	void RenderTargetPool::CollectUnused()
+	{
+		double now = glfwGetTime();
+
+		targets.erase(remove_if(targets.begin(), targets.end(), [now](const unique_ptr<RenderTarget>& target)
+			{
+				if (target->isInUse
+					|| now - target->lastUsedTime < shrinkTimeout)
+				{
+					return false;
+				}
+
+				Delete(*target);
+				return true;
+			}), targets.end());
+	}
+
+	int RenderTargetPool::GetBucketSize(int size)
+	{
+		return ((size + sizeBucket - 1) / sizeBucket) * sizeBucket;
+	}
+
+	bool RenderTargetPool::IsExactBucket(const RenderTarget& target, int width, int height)
+	{
+		return target.width == GetBucketSize(width)
+			&& target.height == GetBucketSize(height);
+	}
+
+	void RenderTargetPool::Allocate(RenderTarget& target)
+	{
+		glGenFramebuffers(1, &target.framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+
+		glGenTextures(1, &target.colorTexture);
+		glBindTexture(GL_TEXTURE_2D, target.colorTexture);
+		glTexImage2D(
+			GL_TEXTURE_2D,
+			0,
+			target.colorFormat,
+			target.width,
+			target.height,
+			0,
+			GL_RGBA,
+			GL_UNSIGNED_BYTE,
+			NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glFramebufferTexture2D(
+			GL_FRAMEBUFFER,
+			GL_COLOR_ATTACHMENT0,
+			GL_TEXTURE_2D,
+			target.colorTexture,
+			0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		if (target.hasDepth)
+		{
+			glGenRenderbuffers(1, &target.depthRenderbuffer);
+			glBindRenderbuffer(GL_RENDERBUFFER, target.depthRenderbuffer);
+			glRenderbufferStorage(
+				GL_RENDERBUFFER,
+				GL_DEPTH24_STENCIL8,
+				target.width,
+				target.height);
+			glFramebufferRenderbuffer(
+				GL_FRAMEBUFFER,
+				GL_DEPTH_STENCIL_ATTACHMENT,
+				GL_RENDERBUFFER,
+				target.depthRenderbuffer);
+			glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		}
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::INITIALIZE,
+				Type::EXCEPTION,
+				"Error: Render target of " + to_string(target.width) + "x" + to_string(target.height) + " is not complete!\n");
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	void RenderTargetPool::Delete(RenderTarget& target)
+	{
+		if (target.depthRenderbuffer != 0) glDeleteRenderbuffers(1, &target.depthRenderbuffer);
+		if (target.colorTexture != 0) glDeleteTextures(1, &target.colorTexture);
+		if (target.framebuffer != 0) glDeleteFramebuffers(1, &target.framebuffer);
+	}
+}
@@ -7,6 +7,10 @@
 #include <iostream>
 #include <filesystem>
 #include <vector>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <algorithm>
 
 //external
 #include "glad.h"
@@ -15,6 +19,8 @@
 #include "console.hpp"
 #include "shader.hpp"
 #include "stringUtils.hpp"
+#include "fileUtils.hpp"
+#include "core.hpp"
 
 using std::cout;
 using std::endl;
@@ -25,8 +31,21 @@ using std::to_string;
 using std::vector;
 using std::filesystem::absolute;
 using std::filesystem::path;
+using std::filesystem::exists;
+using std::filesystem::remove;
+using std::filesystem::file_size;
+using std::filesystem::create_directories;
+using std::ofstream;
+using std::ios;
+using std::hex;
+using std::setw;
+using std::setfill;
+using std::error_code;
+using std::clamp;
 
 using Utils::String;
+using Utils::File;
+using Core::Engine;
 using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
 using Type = Core::ConsoleManager::Type;
@@ -35,7 +54,17 @@ namespace Graphics
 {
     unordered_map<string, unsigned int> Shader::shaders;
 
-    Shader Shader::LoadShader(const string& vertexPath, const string& fragmentPath)
+    //'ELPB', bumped whenever the header layout changes
+    static constexpr uint32_t programBinaryMagic = 0x42504C45;
+
+    struct ProgramBinaryHeader
+    {
+        uint32_t magic;
+        GLenum format;
+        uint32_t length;
+    };
+
+    Shader Shader::LoadShader(const string& vertexPath, const string& fragmentPath, const vector<string>& defines)
     {
         Shader shader{};
 
@@ -48,6 +77,10 @@ namespace Graphics
         fragmentStemPath = fragmentStemPath.stem();
 
         string shaderKey = absolute(vertexPath).string() + "|" + absolute(fragmentPath).string();
+        for (const string& define : defines)
+        {
+            shaderKey += "|" + define;
+        }
 
         auto it = shaders.find(shaderKey);
         if (it != shaders.end())
@@ -107,45 +140,23 @@ namespace Graphics
                     "\nVertex: " + absolute(vertexPath).string() +
                     "\nFragment: " + absolute(fragmentPath).string() + "\n\n");
             }
-            const char* vShaderCode = vertexCode.c_str();
-            const char* fShaderCode = fragmentCode.c_str();
-
-            unsigned int vertex, fragment;
 
-            //vertex shader
-            vertex = glCreateShader(GL_VERTEX_SHADER);
-            glShaderSource(vertex, 1, &vShaderCode, NULL);
-            glCompileShader(vertex);
-            if (!shader.CheckCompileErrors(vertex, "VERTEX"))
+            if (!defines.empty())
             {
-                shader.ID = 0;
-                return shader;
+                vertexCode = InjectDefines(vertexCode, defines);
+                fragmentCode = InjectDefines(fragmentCode, defines);
             }
 
-            //fragment shader
-            fragment = glCreateShader(GL_FRAGMENT_SHADER);
-            glShaderSource(fragment, 1, &fShaderCode, NULL);
-            glCompileShader(fragment);
-            if (!shader.CheckCompileErrors(fragment, "FRAGMENT"))
-            {
-                shader.ID = 0;
-                return shader;
-            }
+            string binaryPath = GetProgramBinaryPath(vertexCode, fragmentCode);
 
-            //shader program
-            shader.ID = glCreateProgram();
-            glAttachShader(shader.ID, vertex);
-            glAttachShader(shader.ID, fragment);
-            glLinkProgram(shader.ID);
-            if (!shader.CheckCompileErrors(shader.ID, "PROGRAM"))
+            shader.ID = LoadProgramBinary(binaryPath);
+            if (shader.ID == 0)
             {
-                shader.ID = 0;
-                return shader;
-            }
+                shader.ID = CompileProgram(shader, vertexCode, fragmentCode);
+                if (shader.ID == 0) return shader;
 
-            //delete shaders as they are no longer needed
-            glDeleteShader(vertex);
-            glDeleteShader(fragment);
+                SaveProgramBinary(shader.ID, binaryPath);
+            }
 
             shaders.emplace(shaderKey, shader.ID);
 
@@ -156,6 +167,234 @@ namespace Graphics
         return shader;
     }
 
+    Shader Shader::LoadPermutation(const string& vertexPath, const string& fragmentPath, uint32_t mask)
+    {
+        unordered_map<uint32_t, unsigned int>& variants = permutations[vertexPath + "|" + fragmentPath];
+
+        auto it = variants.find(mask);
+        if (it != variants.end())
+        {
+            Shader shader{};
+            shader.ID = it->second;
+            return shader;
+        }
+
+        //failed variants are stored too so that they arent recompiled every frame
+        Shader shader = LoadShader(vertexPath, fragmentPath, GetPermutationDefines(mask));
+        variants.emplace(mask, shader.ID);
+
+        return shader;
+    }
+
+    uint32_t Shader::MakePermutationMask(int pointLightCount, int spotLightCount, uint32_t features)
+    {
+        uint32_t pointLights = static_cast<uint32_t>(clamp(pointLightCount, 0, maxPermutationLights));
+        uint32_t spotLights = static_cast<uint32_t>(clamp(spotLightCount, 0, maxPermutationLights));
+
+        return pointLights | (spotLights << 5) | features;
+    }
+
+    vector<string> Shader::GetPermutationDefines(uint32_t mask)
+    {
+        vector<string> defines;
+        defines.push_back("POINT_LIGHT_COUNT " + to_string(mask & 0x1F));
+        defines.push_back("SPOT_LIGHT_COUNT " + to_string((mask >> 5) & 0x1F));
+        if (mask & feature_dirLight) defines.push_back("DIR_LIGHT");
+        if (mask & feature_specularMap) defines.push_back("SPECULAR_MAP");
+        if (mask & feature_alphaTest) defines.push_back("ALPHA_TEST");
+
+        return defines;
+    }
+
+    string Shader::InjectDefines(const string& code, const vector<string>& defines)
+    {
+        string defineBlock;
+        for (const string& define : defines)
+        {
+            defineBlock += "#define " + define + "\n";
+        }
+
+        //glsl requires #version to come before everything else except comments
+        size_t versionPos = code.find("#version");
+        if (versionPos == string::npos) return defineBlock + code;
+
+        size_t lineEnd = code.find('\n', versionPos);
+        if (lineEnd == string::npos) return code + "\n" + defineBlock;
+
+        string injectedCode = code;
+        injectedCode.insert(lineEnd + 1, defineBlock);
+        return injectedCode;
+    }
+
+    unsigned int Shader::CompileProgram(Shader& shader, const string& vertexCode, const string& fragmentCode)
+    {
+        const char* vShaderCode = vertexCode.c_str();
+        const char* fShaderCode = fragmentCode.c_str();
+
+        unsigned int vertex, fragment;
+
+        //vertex shader
+        vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex, 1, &vShaderCode, NULL);
+        glCompileShader(vertex);
+        if (!shader.CheckCompileErrors(vertex, "VERTEX")) return 0;
+
+        //fragment shader
+        fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment, 1, &fShaderCode, NULL);
+        glCompileShader(fragment);
+        if (!shader.CheckCompileErrors(fragment, "FRAGMENT")) return 0;
+
+        //shader program
+        unsigned int program = glCreateProgram();
+        if (IsProgramBinarySupported())
+        {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+        if (!shader.CheckCompileErrors(program, "PROGRAM")) return 0;
+
+        //delete shaders as they are no longer needed
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+
+        return program;
+    }
+
+    bool Shader::IsProgramBinarySupported()
+    {
+        static const bool isSupported = []()
+            {
+                if (glGetProgramBinary == NULL
+                    || glProgramBinary == NULL
+                    || glProgramParameteri == NULL)
+                {
+                    return false;
+                }
+
+                //some drivers expose the functions but dont support a single binary format
+                GLint formatCount = 0;
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+                return formatCount > 0;
+            }();
+
+        return isSupported;
+    }
+
+    string Shader::GetProgramBinaryPath(const string& vertexCode, const string& fragmentCode)
+    {
+        if (!IsProgramBinarySupported()) return "";
+
+        uint64_t hash = String::fnvOffsetBasis;
+        auto HashString = [&hash](const string& value)
+            {
+                hash = String::Fnv1a(value.data(), value.size(), hash);
+                //separator so that moving text from one string to the next changes the hash
+                const unsigned char separator = 0xFF;
+                hash = String::Fnv1a(&separator, sizeof(separator), hash);
+            };
+
+        auto GetGLString = [](GLenum name)
+            {
+                const GLubyte* value = glGetString(name);
+                return value != NULL ? string(reinterpret_cast<const char*>(value)) : string();
+            };
+
+        HashString(vertexCode);
+        HashString(fragmentCode);
+        HashString(GetGLString(GL_VENDOR));
+        HashString(GetGLString(GL_RENDERER));
+        HashString(GetGLString(GL_VERSION));
+
+        stringstream fileName;
+        fileName << hex << setw(16) << setfill('0') << hash << ".bin";
+
+        return Engine::docsPath + "\\shaderCache\\" + fileName.str();
+    }
+
+    unsigned int Shader::LoadProgramBinary(const string& binaryPath)
+    {
+        if (binaryPath == ""
+            || !exists(binaryPath))
+        {
+            return 0;
+        }
+
+        ifstream binaryFile(binaryPath, ios::binary);
+        ProgramBinaryHeader header{};
+        binaryFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+        vector<char> binary;
+        error_code ec;
+        if (binaryFile
+            && header.magic == programBinaryMagic
+            && header.length > 0
+            && header.length <= file_size(binaryPath, ec) - sizeof(header))
+        {
+            binary.resize(header.length);
+            binaryFile.read(binary.data(), header.length);
+        }
+        binaryFile.close();
+
+        unsigned int program = 0;
+        if (!binary.empty()
+            && static_cast<size_t>(binaryFile.gcount()) == binary.size())
+        {
+            program = glCreateProgram();
+            glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+            GLint success = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &success);
+            if (!success)
+            {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+
+        //drivers may reject binaries at any time, the file is rewritten after compiling from source
+        if (program == 0)
+        {
+            remove(binaryPath, ec);
+
+            ConsoleManager::WriteConsoleMessage(
+                Caller::FILE,
+                Type::DEBUG,
+                "Program binary '" + path(binaryPath).filename().string() + "' was rejected, compiling from source.\n");
+        }
+
+        return program;
+    }
+
+    void Shader::SaveProgramBinary(unsigned int program, const string& binaryPath)
+    {
+        if (binaryPath == "") return;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return;
+
+        ProgramBinaryHeader header{};
+        header.magic = programBinaryMagic;
+
+        vector<char> binary(length);
+        GLsizei writtenLength = 0;
+        glGetProgramBinary(program, length, &writtenLength, &header.format, binary.data());
+        if (writtenLength <= 0) return;
+        header.length = static_cast<uint32_t>(writtenLength);
+
+        error_code ec;
+        create_directories(path(binaryPath).parent_path(), ec);
+
+        File::WriteAtomically(binaryPath, [&header, &binary](ofstream& binaryFile)
+            {
+                binaryFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                binaryFile.write(binary.data(), header.length);
+            });
+    }
+
     void Shader::Use() const
     {
         glUseProgram(ID);
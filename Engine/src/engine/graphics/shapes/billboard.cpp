@@ -4,6 +4,9 @@
 //Read LICENSE.md for more information.
 
 #include <iostream>
+#include <string>
+#include <algorithm>
+#include <cstddef>
 
 //external
 #include "glad.h"
@@ -17,8 +20,10 @@
 #include "core.hpp"
 #include "render.hpp"
 #include "selectobject.hpp"
+#include "console.hpp"
 
 using std::cout;
+using std::to_string;
 using glm::translate;
 using glm::rotate;
 using glm::radians;
@@ -34,6 +39,9 @@ using Graphics::Shape::GameObjectManager;
 using Core::Engine;
 using Graphics::Render;
 using Core::Select;
+using Core::ConsoleManager;
+using Caller = Core::ConsoleManager::Caller;
+using ConsoleType = Core::ConsoleManager::Type;
 
 namespace Graphics::Shape
 {
@@ -51,43 +59,12 @@ namespace Graphics::Shape
 	{
 		shared_ptr<Transform> transform = make_shared<Transform>(pos, rot, scale);
 
-		float vertices[] =
-		{
-			//positions             //normals            //texture coords
-			-0.25f, -0.25f, -0.25f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f,
-			 0.25f, -0.25f, -0.25f,  0.0f,  0.0f, -1.0f,  1.0f,  0.0f,
-			 0.25f,  0.25f, -0.25f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f,
-			 0.25f,  0.25f, -0.25f,  0.0f,  0.0f, -1.0f,  1.0f,  1.0f,
-			-0.25f,  0.25f, -0.25f,  0.0f,  0.0f, -1.0f,  0.0f,  1.0f,
-			-0.25f, -0.25f, -0.25f,  0.0f,  0.0f, -1.0f,  0.0f,  0.0f
-		};
-
-		GLuint vao, vbo, ebo;
-
-		glGenVertexArrays(1, &vao);
-		glGenBuffers(1, &vbo);
-		glBindVertexArray(vao);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-		//position attribute
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-		glEnableVertexAttribArray(0);
-		//normal attribute
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-		glEnableVertexAttribArray(1);
-		//texture attribute
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-		glEnableVertexAttribArray(2);
-
-		glBindVertexArray(0);
-
-		shared_ptr<Mesh> mesh = make_shared<Mesh>(true, Type::billboard, vao, vbo, ebo);
-
-		Shader billboardShader = Shader::LoadShader(vertShader, fragShader);
+		//billboards have no geometry of their own, the batch builds every quad in the vertex shader
+		shared_ptr<Mesh> mesh = make_shared<Mesh>(true, Type::billboard, 0, 0, 0);
 
+		//only the shader names are kept, every billboard is drawn with the shared batch shader
 		shared_ptr<Material> mat = make_shared<Material>();
-		mat->AddShader(vertShader, fragShader, billboardShader);
+		mat->AddShader(vertShader, fragShader, Shader());
 
 		shared_ptr<BasicShape_Variables> basicShape = make_shared<BasicShape_Variables>(shininess);
 
@@ -103,10 +80,6 @@ namespace Graphics::Shape
 
 		Texture::LoadTexture(obj, diffTexture, Material::TextureType::diffuse, true);
 
-		Shader assignedShader = obj->GetMaterial()->GetShader();
-		assignedShader.Use();
-		assignedShader.SetInt("material.diffuse", 0);
-
 		GameObjectManager::AddGameObject(obj);
 		GameObjectManager::AddTransparentObject(obj);
 		GameObjectManager::AddBillboard(obj);
@@ -114,43 +87,189 @@ namespace Graphics::Shape
 		return obj;
 	}
 
-	void Billboard::RenderBillboard(const shared_ptr<GameObject>& obj, const mat4& view, const mat4& projection)
+	void Billboard::RenderBillboards(const vector<shared_ptr<GameObject>>& billboards, const mat4& view, const mat4& projection)
 	{
-		if (GameObjectManager::renderBillboards
-			&& obj->IsEnabled())
+		if (!GameObjectManager::renderBillboards) return;
+
+		instances.clear();
+		for (const auto& obj : billboards)
 		{
-			Shader shader = obj->GetMaterial()->GetShader();
+			if (obj->GetMesh()->GetMeshType() != Type::billboard
+				|| !obj->IsEnabled())
+			{
+				continue;
+			}
+
+			const shared_ptr<GameObject>& holder = obj->GetParentBillboardHolder();
+			obj->GetTransform()->SetPosition(holder->GetTransform()->GetPosition());
+
+			unsigned int texture = obj->GetMaterial()->GetTextureID(Material::TextureType::diffuse);
+			if (texture == 0) continue;
 
-			shader.Use();
-			shader.SetMat4("projection", projection);
-			shader.SetMat4("view", view);
+			if (instanceVAO == 0) InitializeBatch();
 
-			shader.SetFloat("transparency", 1.0f);
-			shader.SetVec3("color", vec3(1));
+			instances.push_back({
+				holder->GetTransform()->GetRenderPosition(),
+				obj->GetTransform()->GetScale(),
+				GetAtlasRect(texture) });
+		}
+
+		if (instances.empty()) return;
+
+		static Shader shader = Shader::LoadShader(
+			Engine::filesPath + "\\shaders\\Billboard.vert",
+			Engine::filesPath + "\\shaders\\Billboard.frag");
+		if (shader.ID == 0) return;
 
-			mat4 model = mat4(1.0f);
+		shader.Use();
+		shader.SetMat4("projection", projection);
+		shader.SetMat4("view", view);
+		shader.SetVec3("cameraPos", Render::camera.GetCameraPosition());
+		shader.SetInt("atlas", 0);
 
-			vec3 pos = obj->GetParentBillboardHolder()->GetTransform()->GetPosition();
-			obj->GetTransform()->SetPosition(pos);
+		//orphan the old storage so the driver does not wait for last frame's draw to finish reading it
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		if (instances.size() > instanceCapacity) instanceCapacity = instances.size() * 2;
+		glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(BillboardInstance), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(BillboardInstance), instances.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, atlasTexture);
+
+		glBindVertexArray(instanceVAO);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instances.size()));
+		glBindVertexArray(0);
+	}
 
-			vec3 objectPos = obj->GetTransform()->GetPosition();
-			vec3 cameraPos = Render::camera.GetCameraPosition();
-			model = translate(model, objectPos);
+	void Billboard::InitializeBatch()
+	{
+		glGenVertexArrays(1, &instanceVAO);
+		glGenBuffers(1, &instanceVBO);
+		glBindVertexArray(instanceVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
 
-			mat4 rotationMatrix = lookAt(objectPos, cameraPos, vec3(0.0f, 1.0f, 0.0f));
-			rotationMatrix = inverse(rotationMatrix);
-			model = rotationMatrix;
+		GLsizei stride = sizeof(BillboardInstance);
+		//center attribute
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BillboardInstance, center));
+		glEnableVertexAttribArray(0);
+		glVertexAttribDivisor(0, 1);
+		//scale attribute
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BillboardInstance, scale));
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+		//atlas rect attribute
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BillboardInstance, atlasRect));
+		glEnableVertexAttribArray(2);
+		glVertexAttribDivisor(2, 1);
 
-			model = scale(model, obj->GetTransform()->GetScale());
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-			//bind diffuse map
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, obj->GetMaterial()->GetTextureID(Material::TextureType::diffuse));
+		//the padding around every cell starts out transparent
+		vector<unsigned char> clearPixels(static_cast<size_t>(atlasSize) * atlasSize * 4, 0);
 
-			shader.SetMat4("model", model);
-			GLuint VAO = obj->GetMesh()->GetVAO();
-			glBindVertexArray(VAO);
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+		glGenTextures(1, &atlasTexture);
+		glBindTexture(GL_TEXTURE_2D, atlasTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlasSize, atlasSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, clearPixels.data());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		//a texel of the last mip level covers exactly the padding, so no level mixes neighbouring cells
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, atlasMaxMipLevel);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	const vec4& Billboard::GetAtlasRect(unsigned int texture)
+	{
+		auto it = atlasRects.find(texture);
+		if (it != atlasRects.end()) return it->second;
+
+		constexpr int cellsPerRow = atlasSize / atlasCellSize;
+		if (freeAtlasCells.empty()
+			&& atlasUsedCells == cellsPerRow * cellsPerRow)
+		{
+			ConsoleManager::WriteConsoleMessage(
+				Caller::FILE,
+				ConsoleType::EXCEPTION,
+				"Error: Billboard atlas is full, texture " + to_string(texture) + " reuses the first cell!\n");
+			return atlasRects[texture] = fallbackRect;
+		}
+
+		//loaded textures have full mip chains, so the first level that fits the cell is already downscaled
+		glBindTexture(GL_TEXTURE_2D, texture);
+		int level = 0;
+		int width = 0;
+		int height = 0;
+		while (true)
+		{
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height);
+			if ((width <= atlasContentSize
+				&& height <= atlasContentSize)
+				|| width <= 1
+				|| height <= 1)
+			{
+				break;
+			}
+			level++;
+		}
+		width = (std::min)(width, atlasContentSize);
+		height = (std::min)(height, atlasContentSize);
+
+		vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+		//cells of deleted textures are reused first
+		bool isReusedCell = !freeAtlasCells.empty();
+		int cell = atlasUsedCells;
+		if (isReusedCell)
+		{
+			cell = freeAtlasCells.back();
+			freeAtlasCells.pop_back();
 		}
+		else atlasUsedCells++;
+		atlasCells[texture] = cell;
+
+		int cellX = (cell % cellsPerRow) * atlasCellSize + atlasCellPadding;
+		int cellY = (cell / cellsPerRow) * atlasCellSize + atlasCellPadding;
+
+		glBindTexture(GL_TEXTURE_2D, atlasTexture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		if (isReusedCell)
+		{
+			//a smaller texture would leave pixels of the previous one next to it for the mips to pick up
+			vector<unsigned char> clearPixels(static_cast<size_t>(atlasContentSize) * atlasContentSize * 4, 0);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, cellX, cellY, atlasContentSize, atlasContentSize, GL_RGBA, GL_UNSIGNED_BYTE, clearPixels.data());
+		}
+		glTexSubImage2D(GL_TEXTURE_2D, 0, cellX, cellY, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		//inset by half a texel so bilinear filtering never picks up the neighbouring cell
+		float texel = 1.0f / atlasSize;
+		vec4 rect = vec4(
+			cellX * texel + texel * 0.5f,
+			cellY * texel + texel * 0.5f,
+			(width - 1) * texel,
+			(height - 1) * texel);
+		if (cell == 0) fallbackRect = rect;
+
+		return atlasRects[texture] = rect;
+	}
+
+	void Billboard::ReleaseAtlasRect(unsigned int texture)
+	{
+		atlasRects.erase(texture);
+
+		auto it = atlasCells.find(texture);
+		if (it == atlasCells.end()) return;
+
+		freeAtlasCells.push_back(it->second);
+		atlasCells.erase(it);
 	}
-}
\ No newline at end of file
+}
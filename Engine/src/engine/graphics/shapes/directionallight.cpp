@@ -12,6 +12,7 @@
 #include "billboard.hpp"
 #include "render.hpp"
 #include "console.hpp"
+#include "debugDraw.hpp"
 #include "selectobject.hpp"
 #if ENGINE_MODE
 #include "gui_scenewindow.hpp"
@@ -24,6 +25,7 @@ using Graphics::Shape::Mesh;
 using MeshType = Graphics::Shape::Mesh::MeshType;
 using Graphics::Shape::Billboard;
 using Graphics::Render;
+using Graphics::DebugDraw;
 using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
 using Type = Core::ConsoleManager::Type;
@@ -58,54 +60,12 @@ namespace Graphics::Shape
 	{
 		shared_ptr<Transform> transform = make_shared<Transform>(pos, rot, scale);
 
-		float vertices[] =
-		{
-			//four corner edges
-			0.0f,  0.5f,  0.0f,
-		   -0.5f, -0.5f, -0.5f,
-
-			0.0f,  0.5f,  0.0f,
-			0.5f, -0.5f, -0.5f,
-
-			0.0f,  0.5f,  0.0f,
-		   -0.5f, -0.5f,  0.5f,
-
-			0.0f,  0.5f,  0.0f,
-			0.5f, -0.5f,  0.5f,
-
-			//four bottom edges
-			0.5f, -0.5f,  0.5f,
-		   -0.5f, -0.5f,  0.5f,
-
-			0.5f, -0.5f, -0.5f,
-		   -0.5f, -0.5f, -0.5f,
-
-		   -0.5f, -0.5f, -0.5f,
-		   -0.5f, -0.5f,  0.5f,
-
-			0.5f, -0.5f, -0.5f,
-			0.5f, -0.5f,  0.5f
-		};
-
-		GLuint vao, vbo, ebo;
-
-		glGenVertexArrays(1, &vao);
-		glGenBuffers(1, &vbo);
-		glBindVertexArray(vao);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-		glEnableVertexAttribArray(0);
-
-		glBindVertexArray(0);
-
-		shared_ptr<Mesh> mesh = make_shared<Mesh>(isMeshEnabled, MeshType::directional_light, vao, vbo, ebo);
-
-		Shader directionalLightShader = Shader::LoadShader(vertShader, fragShader);
+		//the gizmo lines are submitted to the debug draw batch every frame
+		shared_ptr<Mesh> mesh = make_shared<Mesh>(isMeshEnabled, MeshType::directional_light, 0, 0, 0);
 
 		shared_ptr<Material> mat = make_shared<Material>();
-		mat->AddShader(vertShader, fragShader, directionalLightShader);
+		//only the shader names are kept for the scene file, the gizmo is drawn by the debug draw batch
+		mat->AddShader(vertShader, fragShader, Shader());
 
 		shared_ptr<Directional_light_Variables> directionalLight =
 			make_shared<Directional_light_Variables>(
@@ -157,38 +117,20 @@ namespace Graphics::Shape
 		return obj;
 	}
 
-	void DirectionalLight::RenderDirectionalLight(
-		const shared_ptr<GameObject>& obj, 
-		const mat4& view, 
-		const mat4& projection)
+	void DirectionalLight::RenderDirectionalLight(const shared_ptr<GameObject>& obj)
 	{
 		if (obj->IsEnabled())
 		{
-			Shader shader = obj->GetMaterial()->GetShader();
-
-			shader.Use();
-			shader.SetMat4("projection", projection);
-			shader.SetMat4("view", view);
-
 			float transparency =
 				Select::selectedObj == obj
 				&& Select::isObjectSelected ? 1.0f : 0.5f;
-			shader.SetFloat("transparency", transparency);
-			shader.SetVec3("color", obj->GetDirectionalLight()->GetDiffuse());
 
 			if (GameObjectManager::renderLightBorders
 				&& obj->GetMesh()->IsEnabled())
 			{
-				mat4 model = mat4(1.0f);
-				model = translate(model, obj->GetTransform()->GetPosition());
-				quat newRot = quat(radians(obj->GetTransform()->GetRotation()));
-				model *= mat4_cast(newRot);
-				model = scale(model, obj->GetTransform()->GetScale());
-
-				shader.SetMat4("model", model);
-				GLuint VAO = obj->GetMesh()->GetVAO();
-				glBindVertexArray(VAO);
-				glDrawArrays(GL_LINES, 0, 32);
+				DebugDraw::DrawPyramid(
+					obj->GetTransform()->GetRenderMatrix(),
+					vec4(obj->GetDirectionalLight()->GetDiffuse(), transparency));
 			}
 		}
 	}
@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <array>
+#include <cstring>
 
 //external
 #include "glm.hpp"
@@ -19,21 +21,29 @@
 #include "spotlight.hpp"
 #include "directionallight.hpp"
 #include "billboard.hpp"
+#include "skybox.hpp"
 #include "render.hpp"
 #include "selectobject.hpp"
 #include "console.hpp"
 #include "sceneFile.hpp"
 #include "stringUtils.hpp"
 #include "fileUtils.hpp"
+#include "profiler.hpp"
+#include "debugDraw.hpp"
+#include "configFile.hpp"
+#include "occlusionCulling.hpp"
 #if ENGINE_MODE
 #include "selectedobjectaction.hpp"
 #include "selectedobjectborder.hpp"
+#include "grid.hpp"
 #include "gui_scenewindow.hpp"
 #endif
 
 using std::cout;
 using std::endl;
-using std::sort;
+using std::array;
+using std::move;
+using std::memcpy;
 using std::to_string;
 using std::remove;
 using std::dynamic_pointer_cast;
@@ -46,15 +56,20 @@ using std::filesystem::exists;
 using Core::Select;
 using Type = Graphics::Shape::Mesh::MeshType;
 using Graphics::Render;
+using Graphics::DebugDraw;
+using Graphics::OcclusionCulling;
+using EngineFile::ConfigFile;
 using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
 using ConsoleType = Core::ConsoleManager::Type;
 using EngineFile::SceneFile;
 using Utils::String;
 using Utils::File;
+using Core::ProfileZone;
 #if ENGINE_MODE
 using Graphics::Shape::ActionTex;
 using Graphics::Shape::Border;
+using Graphics::Grid;
 using Graphics::GUI::GUISceneWindow;
 #endif
 
@@ -62,13 +77,47 @@ namespace Graphics::Shape
 {
 	void GameObjectManager::RenderAll(const mat4& view, const mat4& projection)
 	{
+		ProfileZone renderAllZone("GameObjectManager::RenderAll", true);
+
+		//models hidden behind large occluders are skipped by both passes
+		static const bool& occlusionCulling = ConfigFile::GetBool("graphics_occlusionCulling");
+		bool useOcclusionCulling = occlusionCulling && opaqueObjects.size() > 0;
+		if (useOcclusionCulling) OcclusionCulling::Update(opaqueObjects, view, projection);
+		else OcclusionCulling::Clear();
+
+		//the pre-pass lays down the final depth, so the main pass shades each visible pixel once
+		static const bool& depthPrepass = ConfigFile::GetBool("graphics_depthPrepass");
+		bool useDepthPrepass = depthPrepass && opaqueObjects.size() > 0;
+		if (useDepthPrepass)
+		{
+			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			for (size_t i = 0; i < opaqueObjects.size(); i++)
+			{
+				const shared_ptr<GameObject>& obj = opaqueObjects[i];
+				if (obj->GetMesh()->GetMeshType() != Type::model
+					|| (useOcclusionCulling && !OcclusionCulling::IsVisible(i)))
+				{
+					continue;
+				}
+
+				Model::RenderDepth(obj, view, projection);
+			}
+			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+			glDepthFunc(GL_EQUAL);
+			glDepthMask(GL_FALSE);
+		}
+
 		//opaque objects are rendered first
 		if (opaqueObjects.size() > 0)
 		{
-			for (const auto& obj : opaqueObjects)
+			for (size_t i = 0; i < opaqueObjects.size(); i++)
 			{
+				const shared_ptr<GameObject>& obj = opaqueObjects[i];
 				if (obj->GetName() == "") obj->SetName(".");
 
+				if (useOcclusionCulling && !OcclusionCulling::IsVisible(i)) continue;
+
 				Type type = obj->GetMesh()->GetMeshType();
 				switch (type)
 				{
@@ -76,65 +125,173 @@ namespace Graphics::Shape
 					Model::Render(obj, view, projection);
 					break;
 				case Type::directional_light:
-					DirectionalLight::RenderDirectionalLight(obj, view, projection);
+					DirectionalLight::RenderDirectionalLight(obj);
 					break;
 				case Type::point_light:
-					PointLight::RenderPointLight(obj, view, projection);
+					PointLight::RenderPointLight(obj);
 					break;
 				case Type::spot_light:
-					SpotLight::RenderSpotLight(obj, view, projection);
+					SpotLight::RenderSpotLight(obj);
 					break;
 				}
 			}
 		}
 
+		if (useDepthPrepass)
+		{
+			glDepthFunc(GL_LESS);
+			glDepthMask(GL_TRUE);
+		}
+
+		//the skybox only shades the pixels that the opaque objects left empty
+		if (skybox != nullptr) Skybox::RenderSkybox(skybox, view, projection);
+
+#if ENGINE_MODE
+		Border::RenderBorder();
+#endif
+		//gizmo lines from the opaque pass and from game code go out in one batch before blending starts
+		DebugDraw::Flush(view, projection);
+
 #if ENGINE_MODE
-		Border::RenderBorder(border, view, projection);
+		//the grid outputs the depth of its plane, drawing it after the opaque objects lets them hide it
+		glDepthMask(GL_FALSE);
+		Grid::RenderGrid(view, projection);
+		glDepthMask(GL_TRUE);
 #endif
 		//transparent objects are rendered last
 		if (transparentObjects.size() > 0)
 		{
-			sort(transparentObjects.begin(), transparentObjects.end(),
-				[&view](const auto& a, const auto& b)
-				{
-					//calculate the distance along the viewing direction vector from the camera
-					vec3 cameraPosition = vec3(view[3]);
-					vec3 objectPositionA = a->GetTransform()->GetPosition();
-					vec3 objectPositionB = b->GetTransform()->GetPosition();
-
-					//project object positions onto the viewing direction vector
-					float distanceA = dot(objectPositionA - cameraPosition, vec3(view[2]));
-					float distanceB = dot(objectPositionB - cameraPosition, vec3(view[2]));
-
-					//sort based on the projected distances
-					return distanceA > distanceB; //render from back to front
-				});
+			SortTransparentObjects(view);
 
 			glDepthMask(GL_FALSE);
 			glDisable(GL_CULL_FACE);
 #if ENGINE_MODE
 			ActionTex::RenderActionTex(actionTex, view, projection);
 #endif
+			//every billboard of the sorted list goes out as one batch, other types are skipped by the batch
 			for (const auto& obj : transparentObjects)
 			{
 				if (obj->GetName() == "") obj->SetName(".");
+			}
+			Billboard::RenderBillboards(transparentObjects, view, projection);
 
-				Type type = obj->GetMesh()->GetMeshType();
-				switch (type)
+			glDepthMask(GL_TRUE);
+			glEnable(GL_CULL_FACE);
+		}
+	}
+
+	void GameObjectManager::SortTransparentObjects(const mat4& view)
+	{
+		size_t count = transparentObjects.size();
+		if (count < 2) return;
+
+		//the eye is the inverse view translation, the view matrix translation itself is not the camera position
+		vec3 cameraPosition = vec3(inverse(view)[3]);
+		//third row of the view matrix is the backwards axis of the camera in world space
+		vec3 viewDirection = -vec3(view[0][2], view[1][2], view[2][2]);
+
+		sortKeys.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			vec3 position = transparentObjects[i]->GetTransform()->GetRenderPosition();
+			float depth = dot(position - cameraPosition, viewDirection);
+
+			//flip the float bits so that unsigned order matches float order,
+			//then invert so that the farthest object gets the smallest key
+			uint32_t bits;
+			memcpy(&bits, &depth, sizeof(bits));
+			bits ^= (bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+
+			sortKeys[i] = { ~bits, static_cast<uint32_t>(i) };
+		}
+
+		//the camera rarely moves far enough in one frame to change much of last frame's order
+		if (!InsertionSortKeys(sortKeys, count))
+		{
+			RadixSortKeys(sortKeys, sortScratch);
+		}
+
+		bool isOrderUnchanged = true;
+		for (size_t i = 0; i < count; i++)
+		{
+			if (sortKeys[i].index != i)
+			{
+				isOrderUnchanged = false;
+				break;
+			}
+		}
+		if (isOrderUnchanged) return;
+
+		sortedObjects.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			sortedObjects[i] = move(transparentObjects[sortKeys[i].index]);
+		}
+		transparentObjects.swap(sortedObjects);
+		sortedObjects.clear();
+	}
+
+	bool GameObjectManager::InsertionSortKeys(vector<TransparentSortKey>& keys, size_t maxMoves)
+	{
+		size_t moves = 0;
+		for (size_t i = 1; i < keys.size(); i++)
+		{
+			TransparentSortKey current = keys[i];
+			size_t j = i;
+			while (j > 0
+				&& keys[j - 1].key > current.key)
+			{
+				keys[j] = keys[j - 1];
+				j--;
+
+				if (++moves > maxMoves)
 				{
-				case Type::billboard:
-					Billboard::RenderBillboard(obj, view, projection);
-					break;
+					keys[j] = current;
+					return false;
 				}
 			}
+			keys[j] = current;
+		}
 
-			glDepthMask(GL_TRUE);
-			glEnable(GL_CULL_FACE);
+		return true;
+	}
+
+	void GameObjectManager::RadixSortKeys(vector<TransparentSortKey>& keys, vector<TransparentSortKey>& scratch)
+	{
+		size_t count = keys.size();
+		scratch.resize(count);
+
+		for (uint32_t shift = 0; shift < 32; shift += 8)
+		{
+			array<size_t, 256> offsets{};
+			for (const TransparentSortKey& key : keys)
+			{
+				offsets[(key.key >> shift) & 0xFF]++;
+			}
+
+			//every key has the same byte here, this pass would not change the order
+			if (offsets[(keys[0].key >> shift) & 0xFF] == count) continue;
+
+			size_t total = 0;
+			for (size_t& offset : offsets)
+			{
+				size_t bucketSize = offset;
+				offset = total;
+				total += bucketSize;
+			}
+
+			for (const TransparentSortKey& key : keys)
+			{
+				scratch[offsets[(key.key >> shift) & 0xFF]++] = key;
+			}
+			keys.swap(scratch);
 		}
 	}
 
 	void GameObjectManager::DestroyGameObject(const shared_ptr<GameObject>& obj, bool localOnly)
 	{
+		RenderDamage::MarkScene();
+
 		string thisName = obj->GetName();
 
 		Type type = obj->GetMesh()->GetMeshType();
@@ -28,6 +28,7 @@
 #include "console.hpp"
 #include "selectobject.hpp"
 #include "fileUtils.hpp"
+#include "meshRegistry.hpp"
 
 using std::cout;
 using std::endl;
@@ -85,13 +86,40 @@ namespace Graphics::Shape
         unsigned int& id,
         const bool& isEnabled)
     {
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(
-            modelPath,
+        const unsigned int importFlags =
             aiProcess_Triangulate
             | aiProcess_GenSmoothNormals
             | aiProcess_FlipUVs
-            | aiProcess_CalcTangentSpace);
+            | aiProcess_CalcTangentSpace;
+
+        //a model that is already in use shares its geometry and buffers instead of being parsed again
+        string meshKey = MeshRegistry::GetKey(modelPath, importFlags);
+        shared_ptr<MeshData> meshData = MeshRegistry::Find(meshKey);
+        if (meshData != nullptr)
+        {
+            ConsoleManager::WriteConsoleMessage(
+                Caller::FILE,
+                Type::DEBUG,
+                "Reusing loaded mesh for '" + path(modelPath).filename().string() + "'.\n");
+
+            InitializeModel(
+                meshData,
+                name,
+                id,
+                isEnabled,
+                modelPath,
+                vertShader,
+                fragShader,
+                diffTexture,
+                specTexture,
+                normalTexture,
+                heightTexture,
+                shininess);
+            return;
+        }
+
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(modelPath, importFlags);
 
         //check for errors
         if (!scene
@@ -111,6 +139,7 @@ namespace Graphics::Shape
         aiNode* topLevelNode = scene->mRootNode->mChildren[0];
 
         ProcessNode(
+            meshKey,
             name,
             id,
             isEnabled,
@@ -130,6 +159,7 @@ namespace Graphics::Shape
     }
 
     void Importer::ProcessNode(
+        const string& meshKey,
         string& name,
         unsigned int& id,
         const bool& isEnabled,
@@ -179,14 +209,46 @@ namespace Graphics::Shape
         aiMesh* mesh = scene->mMeshes[0];
         AssimpMesh newMesh = ProcessMesh(mesh, scene);
 
+        shared_ptr<MeshData> meshData = MeshRegistry::Create(meshKey, newMesh.vertices, newMesh.indices);
+        meshData->SetImportTransform(nodePosition, nodeRotation, nodeScale);
+
+        InitializeModel(
+            meshData,
+            name,
+            id,
+            isEnabled,
+            modelPath,
+            vertShader,
+            fragShader,
+            diffTexture,
+            specTexture,
+            normalTexture,
+            heightTexture,
+            shininess);
+    }
+
+    void Importer::InitializeModel(
+        const shared_ptr<MeshData>& meshData,
+        string& name,
+        unsigned int& id,
+        const bool& isEnabled,
+        const string& modelPath,
+        const string& vertShader,
+        const string& fragShader,
+        const string& diffTexture,
+        const string& specTexture,
+        const string& normalTexture,
+        const string& heightTexture,
+        const float& shininess)
+    {
         if (id == tempID) id = GameObject::nextID++;
 
         string txtPath = path(modelPath).parent_path().string() + "\\" + name + ".txt";
 
-        shared_ptr<GameObject> newChild = Model::Initialize(
-            nodePosition,
-            nodeRotation,
-            nodeScale,
+        Model::Initialize(
+            meshData->GetImportPosition(),
+            meshData->GetImportRotation(),
+            meshData->GetImportScale(),
             txtPath,
             modelPath,
             vertShader,
@@ -195,13 +257,14 @@ namespace Graphics::Shape
             specTexture,
             normalTexture,
             heightTexture,
-            newMesh.vertices,
-            newMesh.indices,
+            {},
+            {},
             shininess,
             name,
             id,
             isEnabled,
-            true);
+            true,
+            meshData);
     }
 
     AssimpMesh Importer::ProcessMesh(
@@ -0,0 +1,107 @@
+//Copyright(C) 2024 Lost Empire Entertainment
+//This program comes with ABSOLUTELY NO WARRANTY.
+//This is free software, and you are welcome to redistribute it under certain conditions.
+//Read LICENSE.md for more information.
+
+#include <cstdint>
+
+//external
+#include "glad.h"
+
+//engine
+#include "meshRegistry.hpp"
+#include "fileUtils.hpp"
+
+using std::make_shared;
+using std::to_string;
+
+using Utils::File;
+
+namespace Graphics::Shape
+{
+	string MeshRegistry::GetKey(const string& modelPath, unsigned int importFlags)
+	{
+		//reading the file is far cheaper than parsing it again with assimp
+		uint64_t hash = 0;
+		if (!File::HashContents(modelPath, hash)) return "";
+
+		return to_string(hash) + "_" + to_string(importFlags);
+	}
+
+	shared_ptr<MeshData> MeshRegistry::Find(const string& key)
+	{
+		if (key == "") return nullptr;
+
+		RemoveExpired();
+
+		auto it = meshes.find(key);
+		return it != meshes.end() ? it->second.lock() : nullptr;
+	}
+
+	shared_ptr<MeshData> MeshRegistry::Create(
+		const string& key,
+		const vector<AssimpVertex>& vertices,
+		const vector<unsigned int>& indices)
+	{
+		GLuint VAO, VBO, EBO;
+
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+		glGenBuffers(1, &EBO);
+
+		glBindVertexArray(VAO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(AssimpVertex), vertices.data(), GL_STATIC_DRAW);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+		//vertex Positions
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)0);
+		//vertex normals
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, normal));
+		//vertex texture coords
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, texCoords));
+		//vertex tangent
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, tangent));
+		//vertex bitangent
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, bitangent));
+		//ids
+		glEnableVertexAttribArray(5);
+		glVertexAttribIPointer(5, 4, GL_INT, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, boneIDs));
+		//weights
+		glEnableVertexAttribArray(6);
+		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, weights));
+		glBindVertexArray(0);
+
+		shared_ptr<MeshData> data = make_shared<MeshData>(VAO, VBO, EBO, vertices, indices);
+		if (key != "")
+		{
+			RemoveExpired();
+			meshes[key] = data;
+		}
+
+		return data;
+	}
+
+	size_t MeshRegistry::GetMeshCount()
+	{
+		RemoveExpired();
+		return meshes.size();
+	}
+
+	void MeshRegistry::RemoveExpired()
+	{
+		for (auto it = meshes.begin(); it != meshes.end();)
+		{
+			if (it->second.expired()) it = meshes.erase(it);
+			else ++it;
+		}
+	}
+}
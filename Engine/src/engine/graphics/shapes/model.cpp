@@ -8,6 +8,7 @@
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <algorithm>
 
 //external
 #include "glad.h"
@@ -24,6 +25,9 @@
 #include "stringUtils.hpp"
 #include "selectobject.hpp"
 #include "gameObjectFile.hpp"
+#include "profiler.hpp"
+#include "occlusionCulling.hpp"
+#include "meshRegistry.hpp"
 #if ENGINE_MODE
 #include "gui_scenewindow.hpp"
 #endif
@@ -43,6 +47,8 @@ using std::ifstream;
 using std::filesystem::exists;
 using std::stoul;
 using std::stof;
+using std::min;
+using std::vector;
 
 using Graphics::Render;
 using Graphics::Shader;
@@ -57,6 +63,9 @@ using Type = Core::ConsoleManager::Type;
 using Utils::String;
 using Core::Select;
 using EngineFile::GameObjectFile;
+using Core::ProfileZone;
+using Graphics::OcclusionCulling;
+using Graphics::Shape::MeshRange;
 #if ENGINE_MODE
 using Graphics::GUI::GUISceneWindow;
 #endif
@@ -81,49 +90,16 @@ namespace Graphics::Shape
 		string& name,
 		unsigned int& id,
 		const bool& isEnabled,
-		const bool& isMeshEnabled)
+		const bool& isMeshEnabled,
+		const shared_ptr<MeshData>& meshData)
 	{
 		shared_ptr<Transform> transform = make_shared<Transform>(pos, rot, scale);
 
-		GLuint VAO, VBO, EBO;
-
-		glGenVertexArrays(1, &VAO);
-		glGenBuffers(1, &VBO);
-		glGenBuffers(1, &EBO);
-
-		glBindVertexArray(VAO);
-
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(AssimpVertex), &vertices[0], GL_STATIC_DRAW);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-		//vertex Positions
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)0);
-		//vertex normals
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, normal));
-		//vertex texture coords
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, texCoords));
-		//vertex tangent
-		glEnableVertexAttribArray(3);
-		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, tangent));
-		//vertex bitangent
-		glEnableVertexAttribArray(4);
-		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, bitangent));
-		//ids
-		glEnableVertexAttribArray(5);
-		glVertexAttribIPointer(5, 4, GL_INT, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, boneIDs));
-		//weights
-		glEnableVertexAttribArray(6);
-		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(AssimpVertex), (void*)offsetof(AssimpVertex, weights));
-		glBindVertexArray(0);
-
-		shared_ptr<Mesh> mesh = make_shared<Mesh>(isMeshEnabled, MeshType::model, VAO, VBO, EBO);
+		//meshes of the same source share one set of buffers, geometry without a source gets its own
+		shared_ptr<MeshData> data = meshData != nullptr
+			? meshData
+			: MeshRegistry::Create("", vertices, indices);
+		shared_ptr<Mesh> mesh = make_shared<Mesh>(isMeshEnabled, MeshType::model, data);
 
 		Shader modelShader = Shader::LoadShader(vertShader, fragShader);
 
@@ -142,9 +118,6 @@ namespace Graphics::Shape
 			mat,
 			basicShape);
 
-		obj->GetMesh()->SetVertices(vertices);
-		obj->GetMesh()->SetIndices(indices);
-
 		Texture::LoadTexture(obj, diffTexture, Material::TextureType::diffuse, false);
 		Texture::LoadTexture(obj, specTexture, Material::TextureType::specular, false);
 		Texture::LoadTexture(obj, "EMPTY", Material::TextureType::height, false);
@@ -183,33 +156,60 @@ namespace Graphics::Shape
 	{
 		if (obj->IsEnabled())
 		{
-			Shader shader = obj->GetMaterial()->GetShader();
+			ProfileZone renderZone("Model::Render", true);
+
+			shared_ptr<Material> mat = obj->GetMaterial();
+
+			//only enabled lights are uploaded, their counts are compiled into the shader variant
+			shared_ptr<GameObject> dirLight = GameObjectManager::GetDirectionalLight();
+			bool hasDirLight = dirLight != nullptr && dirLight->IsEnabled();
+
+			const vector<shared_ptr<GameObject>>& pointLights = GameObjectManager::GetPointLights();
+			const vector<shared_ptr<GameObject>>& spotLights = GameObjectManager::GetSpotLights();
+			int pointLightCount = 0;
+			for (const auto& light : pointLights)
+			{
+				if (light->IsEnabled()) pointLightCount++;
+			}
+			int spotLightCount = 0;
+			for (const auto& light : spotLights)
+			{
+				if (light->IsEnabled()) spotLightCount++;
+			}
+			pointLightCount = min(pointLightCount, Shader::maxPermutationLights);
+			spotLightCount = min(spotLightCount, Shader::maxPermutationLights);
+
+			unsigned int diffuseTextureID = mat->GetTextureID(Material::TextureType::diffuse);
+			unsigned int specularTextureID = mat->GetTextureID(Material::TextureType::specular);
+
+			uint32_t features = 0;
+			if (hasDirLight) features |= Shader::feature_dirLight;
+			if (specularTextureID != 0) features |= Shader::feature_specularMap;
+			if (Texture::HasAlphaChannel(diffuseTextureID)) features |= Shader::feature_alphaTest;
+
+			const Shader& shader = mat->GetPermutation(
+				Shader::MakePermutationMask(pointLightCount, spotLightCount, features));
 
 			shader.Use();
 			shader.SetVec3("viewPos", Render::camera.GetCameraPosition());
-			shader.SetFloat("material.shininess", obj->GetBasicShape()->GetShininess());
+			if (specularTextureID != 0)
+			{
+				shader.SetFloat("material.shininess", obj->GetBasicShape()->GetShininess());
+			}
 
 			//directional light
-			if (GameObjectManager::GetDirectionalLight() != nullptr)
+			if (hasDirLight)
 			{
-				shared_ptr<GameObject> dirLight = GameObjectManager::GetDirectionalLight();
-
-				int count = dirLight->IsEnabled() ? 1 : 0;
-				shader.SetInt("dirLightCount", count);
-				
 				shared_ptr<Transform> transform = dirLight->GetTransform();
 				shared_ptr<Directional_light_Variables> dirVar = dirLight->GetDirectionalLight();
 
-				vec3 dirRot = transform->GetRotation();
-				quat dirQuat = quat(radians(dirRot));
+				quat dirQuat = transform->GetRenderRotation();
 				//assuming the initial direction is along the negative Y-axis
 				vec3 initialDir = vec3(0.0f, -1.0f, 0.0f);
 				//rotate the initial direction using the quaternion
 				vec3 rotatedDir = dirQuat * initialDir;
 				rotatedDir = normalize(rotatedDir);
 
-				shader.SetBool("dirLight.enabled", dirLight->IsEnabled());
-
 				shader.SetVec3("dirLight.direction", rotatedDir);
 
 				shader.SetFloat("dirLight.intensity", dirVar->GetIntensity());
@@ -217,90 +217,68 @@ namespace Graphics::Shape
 				shader.SetVec3("dirLight.diffuse", dirVar->GetDiffuse());
 				shader.SetVec3("dirLight.specular", 0.5f, 0.5f, 0.5f);
 			}
-			else 
-			{
-				shader.SetBool("dirLight.enabled", false);
-			}
 
 			//point lights
-			const vector<shared_ptr<GameObject>>& pointLights = GameObjectManager::GetPointLights();
-			int pointLightCount = static_cast<int>(pointLights.size());
-			shader.SetInt("pointLightCount", pointLightCount);
-			if (pointLightCount > 0)
+			int pointLightIndex = 0;
+			for (const auto& light : pointLights)
 			{
-				for (int i = 0; i < pointLightCount; i++)
-				{
-					shared_ptr<Transform> transform = pointLights[i]->GetTransform();
-					shared_ptr<PointLight_Variables> pointLight = pointLights[i]->GetPointLight();
-					string lightPrefix = "pointLights[" + to_string(i) + "].";
-
-					shader.SetBool(lightPrefix + "enabled", pointLights[i]->IsEnabled());
-
-					shader.SetVec3(lightPrefix + "position", transform->GetPosition());
-					shader.SetVec3(lightPrefix + "ambient", 0.05f, 0.05f, 0.05f);
-					shader.SetVec3(lightPrefix + "diffuse", pointLight->GetDiffuse());
-					shader.SetVec3(lightPrefix + "specular", 1.0f, 1.0f, 1.0f);
-					shader.SetFloat(lightPrefix + "constant", 1.0f);
-					shader.SetFloat(lightPrefix + "linear", 0.09f);
-					shader.SetFloat(lightPrefix + "quadratic", 0.032f);
-					shader.SetFloat(lightPrefix + "intensity", pointLight->GetIntensity());
-					shader.SetFloat(lightPrefix + "distance", pointLight->GetDistance());
-				}
+				if (!light->IsEnabled()) continue;
+				if (pointLightIndex == pointLightCount) break;
+
+				shared_ptr<Transform> transform = light->GetTransform();
+				shared_ptr<PointLight_Variables> pointLight = light->GetPointLight();
+				string lightPrefix = "pointLights[" + to_string(pointLightIndex++) + "].";
+
+				shader.SetVec3(lightPrefix + "position", transform->GetRenderPosition());
+				shader.SetVec3(lightPrefix + "ambient", 0.05f, 0.05f, 0.05f);
+				shader.SetVec3(lightPrefix + "diffuse", pointLight->GetDiffuse());
+				shader.SetVec3(lightPrefix + "specular", 1.0f, 1.0f, 1.0f);
+				shader.SetFloat(lightPrefix + "constant", 1.0f);
+				shader.SetFloat(lightPrefix + "linear", 0.09f);
+				shader.SetFloat(lightPrefix + "quadratic", 0.032f);
+				shader.SetFloat(lightPrefix + "intensity", pointLight->GetIntensity());
+				shader.SetFloat(lightPrefix + "distance", pointLight->GetDistance());
 			}
 
 			//spotlights
-			const vector<shared_ptr<GameObject>>& spotLights = GameObjectManager::GetSpotLights();
-			int spotLightCount = static_cast<int>(spotLights.size());
-			shader.SetInt("spotLightCount", spotLightCount);
-			if (spotLightCount > 0)
+			int spotLightIndex = 0;
+			for (const auto& light : spotLights)
 			{
-				for (int i = 0; i < spotLightCount; i++)
-				{
-					shared_ptr<Transform> transform = spotLights[i]->GetTransform();
-					shared_ptr<SpotLight_Variables> spotLight = spotLights[i]->GetSpotLight();
-					string lightPrefix = "spotLights[" + to_string(i) + "].";
-					shader.SetVec3(lightPrefix + "position", transform->GetPosition());
-
-					shader.SetBool(lightPrefix + "enabled", spotLights[i]->IsEnabled());
-
-					vec3 rotationAngles = transform->GetRotation();
-					quat rotationQuat = quat(radians(rotationAngles));
-					//assuming the initial direction is along the negative Y-axis
-					vec3 initialDirection = vec3(0.0f, -1.0f, 0.0f);
-					//rotate the initial direction using the quaternion
-					vec3 rotatedDirection = rotationQuat * initialDirection;
-					//set the rotated direction in the shader
-					shader.SetVec3(lightPrefix + "direction", rotatedDirection);
-
-					shader.SetFloat(lightPrefix + "intensity", spotLight->GetIntensity());
-					shader.SetFloat(lightPrefix + "distance", spotLight->GetDistance());
-					shader.SetVec3(lightPrefix + "ambient", 0.0f, 0.0f, 0.0f);
-					shader.SetVec3(lightPrefix + "diffuse", spotLight->GetDiffuse());
-					shader.SetVec3(lightPrefix + "specular", 1.0f, 1.0f, 1.0f);
-					shader.SetFloat(lightPrefix + "constant", 1.0f);
-					shader.SetFloat(lightPrefix + "linear", 0.09f);
-					shader.SetFloat(lightPrefix + "quadratic", 0.032f);
-					shader.SetFloat(lightPrefix + "cutOff", cos(radians(spotLight->GetInnerAngle())));
-					shader.SetFloat(lightPrefix + "outerCutOff", cos(radians(spotLight->GetOuterAngle())));
-				}
+				if (!light->IsEnabled()) continue;
+				if (spotLightIndex == spotLightCount) break;
+
+				shared_ptr<Transform> transform = light->GetTransform();
+				shared_ptr<SpotLight_Variables> spotLight = light->GetSpotLight();
+				string lightPrefix = "spotLights[" + to_string(spotLightIndex++) + "].";
+				shader.SetVec3(lightPrefix + "position", transform->GetRenderPosition());
+
+				quat rotationQuat = transform->GetRenderRotation();
+				//assuming the initial direction is along the negative Y-axis
+				vec3 initialDirection = vec3(0.0f, -1.0f, 0.0f);
+				//rotate the initial direction using the quaternion
+				vec3 rotatedDirection = rotationQuat * initialDirection;
+				//set the rotated direction in the shader
+				shader.SetVec3(lightPrefix + "direction", rotatedDirection);
+
+				shader.SetFloat(lightPrefix + "intensity", spotLight->GetIntensity());
+				shader.SetFloat(lightPrefix + "distance", spotLight->GetDistance());
+				shader.SetVec3(lightPrefix + "ambient", 0.0f, 0.0f, 0.0f);
+				shader.SetVec3(lightPrefix + "diffuse", spotLight->GetDiffuse());
+				shader.SetVec3(lightPrefix + "specular", 1.0f, 1.0f, 1.0f);
+				shader.SetFloat(lightPrefix + "constant", 1.0f);
+				shader.SetFloat(lightPrefix + "linear", 0.09f);
+				shader.SetFloat(lightPrefix + "quadratic", 0.032f);
+				shader.SetFloat(lightPrefix + "cutOff", cos(radians(spotLight->GetInnerAngle())));
+				shader.SetFloat(lightPrefix + "outerCutOff", cos(radians(spotLight->GetOuterAngle())));
 			}
 
 			shader.SetMat4("projection", projection);
 			shader.SetMat4("view", view);
 
-			mat4 model = mat4(1.0f);
-
-			model = translate(model, obj->GetTransform()->GetPosition());
-
-			quat newRot = quat(radians(obj->GetTransform()->GetRotation()));
-			model *= mat4_cast(newRot);
-
-			model = scale(model, obj->GetTransform()->GetScale());
-
-			shared_ptr<Material> mat = obj->GetMaterial();
+			//blended between the last two simulation steps
+			mat4 model = obj->GetTransform()->GetRenderMatrix();
 
 			//bind diffuse texture
-			unsigned int diffuseTextureID = mat->GetTextureID(Material::TextureType::diffuse);
 			if (diffuseTextureID != 0)
 			{
 				glActiveTexture(GL_TEXTURE0);
@@ -308,7 +286,6 @@ namespace Graphics::Shape
 			}
 
 			//bind specular texture
-			unsigned int specularTextureID = mat->GetTextureID(Material::TextureType::specular);
 			if (specularTextureID != 0)
 			{
 				glActiveTexture(GL_TEXTURE1);
@@ -319,13 +296,96 @@ namespace Graphics::Shape
 
 			GLuint VAO = obj->GetMesh()->GetVAO();
 			glBindVertexArray(VAO);
+			DrawElements(obj, projection * view * model);
+
+			glActiveTexture(GL_TEXTURE0);
+		}
+	}
+
+	void Model::RenderDepth(
+		const shared_ptr<GameObject>& obj,
+		const mat4& view,
+		const mat4& projection)
+	{
+		if (!obj->IsEnabled()) return;
+
+		static const Shader opaqueShader = Shader::LoadShader(
+			Engine::filesPath + "\\shaders\\GameObject.vert",
+			Engine::filesPath + "\\shaders\\DepthPrepass.frag");
+		static const Shader alphaTestShader = Shader::LoadShader(
+			Engine::filesPath + "\\shaders\\GameObject.vert",
+			Engine::filesPath + "\\shaders\\DepthPrepass.frag",
+			{ "ALPHA_TEST" });
+
+		unsigned int diffuseTextureID = obj->GetMaterial()->GetTextureID(Material::TextureType::diffuse);
+		bool isAlphaTested = Texture::HasAlphaChannel(diffuseTextureID);
+
+		const Shader& shader = isAlphaTested ? alphaTestShader : opaqueShader;
+		shader.Use();
+		shader.SetMat4("projection", projection);
+		shader.SetMat4("view", view);
+		mat4 model = obj->GetTransform()->GetRenderMatrix();
+		shader.SetMat4("model", model);
+
+		if (isAlphaTested)
+		{
+			shader.SetInt("diffuse", 0);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, diffuseTextureID);
+		}
+
+		GLuint VAO = obj->GetMesh()->GetVAO();
+		glBindVertexArray(VAO);
+		DrawElements(obj, projection * view * model);
+	}
+
+	void Model::DrawElements(
+		const shared_ptr<GameObject>& obj,
+		const mat4& modelViewProjection)
+	{
+		const shared_ptr<Mesh>& mesh = obj->GetMesh();
+		const vector<MeshRange>& ranges = mesh->GetRanges();
+		if (ranges.empty())
+		{
 			glDrawElements(
 				GL_TRIANGLES,
-				static_cast<unsigned int>(obj->GetMesh()->GetIndices().size()),
+				static_cast<unsigned int>(mesh->GetIndices().size()),
 				GL_UNSIGNED_INT,
 				0);
+			return;
+		}
 
-			glActiveTexture(GL_TEXTURE0);
+		//ranges are stored in index order, neighbouring visible ranges become one draw
+		static vector<GLsizei> counts;
+		static vector<const void*> offsets;
+		counts.clear();
+		offsets.clear();
+
+		unsigned int rangeEnd = 0;
+		for (const MeshRange& range : ranges)
+		{
+			if (!OcclusionCulling::IsBoxVisible(range.boundsMin, range.boundsMax, modelViewProjection)) continue;
+
+			if (!counts.empty()
+				&& range.indexOffset == rangeEnd)
+			{
+				counts.back() += static_cast<GLsizei>(range.indexCount);
+			}
+			else
+			{
+				counts.push_back(static_cast<GLsizei>(range.indexCount));
+				offsets.push_back(reinterpret_cast<const void*>(static_cast<size_t>(range.indexOffset) * sizeof(unsigned int)));
+			}
+			rangeEnd = range.indexOffset + range.indexCount;
 		}
+
+		if (counts.empty()) return;
+
+		glMultiDrawElements(
+			GL_TRIANGLES,
+			counts.data(),
+			GL_UNSIGNED_INT,
+			offsets.data(),
+			static_cast<GLsizei>(counts.size()));
 	}
 }
\ No newline at end of file
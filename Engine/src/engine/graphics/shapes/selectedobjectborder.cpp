@@ -14,6 +14,7 @@
 #include "core.hpp"
 #include "render.hpp"
 #include "selectobject.hpp"
+#include "debugDraw.hpp"
 
 using glm::translate;
 using glm::rotate;
@@ -29,6 +30,7 @@ using Graphics::Shape::GameObjectManager;
 using Core::Engine;
 using Graphics::Render;
 using Core::Select;
+using Graphics::DebugDraw;
 
 namespace Graphics::Shape
 {
@@ -36,68 +38,11 @@ namespace Graphics::Shape
 	{
 		shared_ptr<Transform> transform = make_shared<Transform>(pos, rot, scale);
 
-		float vertices[] =
-		{
-			//edges of the cube
-			-0.5f, -0.5f, -0.5f,
-			 0.5f, -0.5f, -0.5f,
-
-			 0.5f, -0.5f, -0.5f,
-			 0.5f,  0.5f, -0.5f,
-
-			 0.5f,  0.5f, -0.5f,
-			-0.5f,  0.5f, -0.5f,
-
-			-0.5f,  0.5f, -0.5f,
-			-0.5f, -0.5f, -0.5f,
-
-			-0.5f, -0.5f,  0.5f,
-			 0.5f, -0.5f,  0.5f,
-
-			 0.5f, -0.5f,  0.5f,
-			 0.5f,  0.5f,  0.5f,
-
-			 0.5f,  0.5f,  0.5f,
-			-0.5f,  0.5f,  0.5f,
-
-			-0.5f,  0.5f,  0.5f,
-			-0.5f, -0.5f,  0.5f,
-
-			//connecting edges
-			-0.5f, -0.5f, -0.5f,
-			-0.5f, -0.5f,  0.5f,
-
-			 0.5f, -0.5f, -0.5f,
-			 0.5f, -0.5f,  0.5f,
-
-			 0.5f,  0.5f, -0.5f,
-			 0.5f,  0.5f,  0.5f,
-
-			-0.5f,  0.5f, -0.5f,
-			-0.5f,  0.5f,  0.5f,
-		};
-
-		GLuint vao, vbo, ebo;
-
-		glGenVertexArrays(1, &vao);
-		glGenBuffers(1, &vbo);
-		glBindVertexArray(vao);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-		glEnableVertexAttribArray(0);
-
-		glBindVertexArray(0);
-
-		shared_ptr<Mesh> mesh = make_shared<Mesh>(true, Type::border, vao, vbo, ebo);
-
-		Shader borderShader = Shader::LoadShader(
-			Engine::filesPath + "\\shaders\\Basic_model.vert",
-			Engine::filesPath + "\\shaders\\Basic.frag");
+		//the border lines are submitted to the debug draw batch while an object is selected
+		shared_ptr<Mesh> mesh = make_shared<Mesh>(true, Type::border, 0, 0, 0);
 
 		shared_ptr<Material> mat = make_shared<Material>();
-		mat->AddShader("shaders\\Basic_model.vert", "shaders\\Basic.frag", borderShader);
+		mat->AddShader("shaders\\Basic_model.vert", "shaders\\Basic.frag", Shader());
 
 		float shininess = 32;
 		shared_ptr<BasicShape_Variables> basicShape = make_shared<BasicShape_Variables>(shininess);
@@ -115,84 +60,57 @@ namespace Graphics::Shape
 		return obj;
 	}
 
-	void Border::RenderBorder(const shared_ptr<GameObject>& obj, const mat4& view, const mat4& projection)
+	void Border::RenderBorder()
 	{
-		Shader shader = obj->GetMaterial()->GetShader();
-
-		shader.Use();
-		shader.SetMat4("projection", projection);
-		shader.SetMat4("view", view);
-
-		shader.SetVec3("color", vec3(1.0));
+		if (!Select::isObjectSelected) return;
 
 		mat4 model = mat4(1.0f);
 
-		if (Select::isObjectSelected)
+		if (Select::selectedObj->GetMesh()->GetMeshType() == Mesh::MeshType::model)
 		{
-			shader.SetFloat("transparency", 0.5f);
-
-			if (Select::selectedObj->GetMesh()->GetMeshType() == Mesh::MeshType::model)
-			{
-				//retrieve vertices and calculate bounding box
-				const vector<AssimpVertex>& vertices = Select::selectedObj->GetMesh()->GetVertices();
-				vec3 minBound, maxBound;
-				vec3 position = Select::selectedObj->GetTransform()->GetPosition();
-				vec3 initialScale = Select::selectedObj->GetTransform()->GetScale();
-
-				//calculate the bounding box based on vertices
-				Select::CalculateInteractionBoxFromVertices(vertices, minBound, maxBound, position, initialScale);
-
-				//compute the center and scale of the bounding box
-				vec3 boxCenter = (minBound + maxBound) * 0.5f;
-				vec3 boxScale = maxBound - minBound;
-
-				//add a margin to the scale
-				vec3 margin = vec3(0.1f);
-				boxScale += margin;
-
-				model = translate(model, boxCenter); // Translate to the center of the bounding box
-
-				//apply rotation
-				quat newRot = quat(radians(Select::selectedObj->GetTransform()->GetRotation()));
-				model *= mat4_cast(newRot);
-
-				//scale based on the bounding box size with the margin included
-				model = scale(model, boxScale);
-			}
-			else
-			{
-				//simple position and margin values
-				vec3 position = Select::selectedObj->GetTransform()->GetPosition();
-
-				//simple bounding box
-				model = translate(model, position);
-
-				//apply rotation
-				quat newRot = quat(radians(Select::selectedObj->GetTransform()->GetRotation()));
-				model *= mat4_cast(newRot);
-
-				//scale based on size, with a slight margin
-				model = scale(model, vec3(1) + vec3(0.1f));
-			}
+			//retrieve vertices and calculate bounding box
+			const vector<AssimpVertex>& vertices = Select::selectedObj->GetMesh()->GetVertices();
+			vec3 minBound, maxBound;
+			vec3 position = Select::selectedObj->GetTransform()->GetPosition();
+			vec3 initialScale = Select::selectedObj->GetTransform()->GetScale();
+
+			//calculate the bounding box based on vertices
+			Select::CalculateInteractionBoxFromVertices(vertices, minBound, maxBound, position, initialScale);
+
+			//compute the center and scale of the bounding box
+			vec3 boxCenter = (minBound + maxBound) * 0.5f;
+			vec3 boxScale = maxBound - minBound;
+
+			//add a margin to the scale
+			vec3 margin = vec3(0.1f);
+			boxScale += margin;
+
+			model = translate(model, boxCenter); // Translate to the center of the bounding box
+
+			//apply rotation
+			quat newRot = quat(radians(Select::selectedObj->GetTransform()->GetRotation()));
+			model *= mat4_cast(newRot);
+
+			//scale based on the bounding box size with the margin included
+			model = scale(model, boxScale);
 		}
 		else
 		{
-			shader.SetFloat("transparency", 0.0f);
+			//simple position and margin values
+			vec3 position = Select::selectedObj->GetTransform()->GetPosition();
 
-			//move the border out of view when no object is selected
-			model = translate(model, vec3(0.0f, -100.0f, 0.0f));
-			model = scale(model, vec3(0.01f));
-		}
-
-		glLineWidth(5.0f);
+			//simple bounding box
+			model = translate(model, position);
 
-		shader.SetMat4("model", model);
+			//apply rotation
+			quat newRot = quat(radians(Select::selectedObj->GetTransform()->GetRotation()));
+			model *= mat4_cast(newRot);
 
-		GLuint VAO = obj->GetMesh()->GetVAO();
-		glBindVertexArray(VAO);
-		glDrawArrays(GL_LINES, 0, 24);
+			//scale based on size, with a slight margin
+			model = scale(model, vec3(1) + vec3(0.1f));
+		}
 
-		glLineWidth(1.0f);
+		DebugDraw::DrawBox(model, vec4(vec3(1.0f), 0.5f));
 	}
 }
 #endif
\ No newline at end of file
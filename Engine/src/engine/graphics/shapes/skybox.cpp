@@ -3,6 +3,13 @@
 //This is free software, and you are welcome to redistribute it under certain conditions.
 //Read LICENSE.md for more information.
 
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+
 //external
 #include "stb_image.h"
 
@@ -10,6 +17,9 @@
 #include "skybox.hpp"
 #include "console.hpp"
 #include "render.hpp"
+#include "jobSystem.hpp"
+#include "stringUtils.hpp"
+#include "fileUtils.hpp"
 #if ENGINE_MODE
 #include "gui_scenewindow.hpp"
 #endif
@@ -20,7 +30,26 @@ using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
 using Type = Core::ConsoleManager::Type;
 
+using std::ifstream;
+using std::ofstream;
+using std::ios;
+using std::stringstream;
+using std::hex;
+using std::setw;
+using std::setfill;
+using std::error_code;
+using std::memcpy;
+using std::filesystem::path;
+using std::filesystem::exists;
+using std::filesystem::remove;
+using std::filesystem::file_size;
+using std::filesystem::last_write_time;
+using std::filesystem::create_directories;
+using std::filesystem::directory_iterator;
 using glm::mat3;
+using Core::JobSystem;
+using Utils::String;
+using Utils::File;
 
 #if ENGINE_MODE
 using Graphics::GUI::GUISceneWindow;
@@ -28,6 +57,26 @@ using Graphics::GUI::GUISceneWindow;
 
 namespace Graphics::Shape
 {
+    //'ELCM', a cooked cubemap holds the six decoded faces so loading a scene skips image decoding
+    static constexpr uint32_t cookedCubemapMagic = 0x4D434C45;
+    static constexpr uint32_t cookedCubemapVersion = 1;
+    //guards the allocation against a damaged header
+    static constexpr int32_t maxCookedFaceSize = 16384;
+
+    struct CookedCubemapHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t faceCount;
+    };
+
+    struct CookedFaceHeader
+    {
+        int32_t width;
+        int32_t height;
+        int32_t channels;
+    };
+
 	shared_ptr<GameObject> Skybox::InitializeSkybox(
 		const vec3& pos,
 		const vec3& rot,
@@ -143,43 +192,53 @@ namespace Graphics::Shape
 
     void Skybox::AssignSkyboxTextures(vector<string> textures, bool flipTextures)
     {
+        RenderDamage::MarkScene();
+
+        vector<CubemapFace> faces(textures.size());
+        string cookedPath = GetCookedCubemapPath(textures, flipTextures);
+        if (!LoadCookedCubemap(cookedPath, faces))
+        {
+            DecodeFaces(textures, flipTextures, faces);
+
+            bool allDecoded = true;
+            for (const CubemapFace& face : faces)
+            {
+                if (face.pixels.empty()) allDecoded = false;
+            }
+            if (allDecoded) SaveCookedCubemap(cookedPath, faces);
+        }
+
+        if (skyboxTexture != 0) glDeleteTextures(1, &skyboxTexture);
+
         unsigned int textureID;
         glGenTextures(1, &textureID);
         glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
-        int width, height, nrChannels;
-        for (unsigned int i = 0; i < textures.size(); i++)
+        //rgb rows are not always four byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (unsigned int i = 0; i < faces.size(); i++)
         {
-            stbi_set_flip_vertically_on_load(flipTextures);
-            unsigned char* data = stbi_load(textures[i].c_str(), &width, &height, &nrChannels, 0);
-            if (data)
-            {
-                GLenum format{};
-                if (nrChannels == 1) format = GL_RED;
-                else if (nrChannels == 3) format = GL_RGB;
-                else if (nrChannels == 4) format = GL_RGBA;
-
-                glTexImage2D(
-                    GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                    0,
-                    format,
-                    width,
-                    height,
-                    0,
-                    format,
-                    GL_UNSIGNED_BYTE,
-                    data);
-                stbi_image_free(data);
-            }
-            else
-            {
-                ConsoleManager::WriteConsoleMessage(
-                    Caller::FILE,
-                    Type::EXCEPTION,
-                    "Error: Failed to load cubemap at '" + textures[i] + "'.\n");
-                stbi_image_free(data);
-            }
+            const CubemapFace& face = faces[i];
+            if (face.pixels.empty()) continue;
+
+            GLenum format{};
+            if (face.channels == 1) format = GL_RED;
+            else if (face.channels == 3) format = GL_RGB;
+            else if (face.channels == 4) format = GL_RGBA;
+
+            glTexImage2D(
+                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
+                0,
+                format,
+                face.width,
+                face.height,
+                0,
+                format,
+                GL_UNSIGNED_BYTE,
+                face.pixels.data());
         }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -189,19 +248,213 @@ namespace Graphics::Shape
         skyboxTexture = textureID;
     }
 
+    void Skybox::DecodeFaces(const vector<string>& textures, bool flipTextures, vector<CubemapFace>& faces)
+    {
+        //scenes often use the same image for several faces, each distinct image is decoded once
+        vector<size_t> sourceFace(textures.size());
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            sourceFace[i] = i;
+            for (size_t j = 0; j < i; j++)
+            {
+                if (textures[j] == textures[i])
+                {
+                    sourceFace[i] = j;
+                    break;
+                }
+            }
+        }
+
+        JobSystem::ParallelFor(0, textures.size(), 1, [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; i++)
+                {
+                    if (sourceFace[i] != i) continue;
+
+                    //stb keeps the flip flag in global state, so rows are flipped here instead
+                    int width, height, nrChannels;
+                    unsigned char* data = stbi_load(textures[i].c_str(), &width, &height, &nrChannels, 0);
+                    if (!data)
+                    {
+                        ConsoleManager::WriteConsoleMessage(
+                            Caller::FILE,
+                            Type::EXCEPTION,
+                            "Error: Failed to load cubemap at '" + textures[i] + "'.\n");
+                        continue;
+                    }
+
+                    CubemapFace& face = faces[i];
+                    face.width = width;
+                    face.height = height;
+                    face.channels = nrChannels;
+
+                    size_t rowSize = static_cast<size_t>(width) * nrChannels;
+                    face.pixels.resize(rowSize * height);
+                    for (int row = 0; row < height; row++)
+                    {
+                        int sourceRow = flipTextures ? height - 1 - row : row;
+                        memcpy(
+                            face.pixels.data() + rowSize * row,
+                            data + rowSize * sourceRow,
+                            rowSize);
+                    }
+
+                    stbi_image_free(data);
+                }
+            });
+
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            if (sourceFace[i] != i) faces[i] = faces[sourceFace[i]];
+        }
+    }
+
+    string Skybox::GetCookedCubemapPath(const vector<string>& textures, bool flipTextures)
+    {
+        //the face set hash stays the same across edits, so older cooked files of the set can be found again
+        uint64_t setHash = String::fnvOffsetBasis;
+        uint64_t contentHash = String::fnvOffsetBasis;
+
+        for (const string& texture : textures)
+        {
+            error_code ec;
+            uint64_t size = file_size(texture, ec);
+            if (ec) return "";
+            int64_t writeTime = last_write_time(texture, ec).time_since_epoch().count();
+            if (ec) return "";
+
+            setHash = String::Fnv1a(texture.data(), texture.size(), setHash);
+            contentHash = String::Fnv1a(&size, sizeof(size), contentHash);
+            contentHash = String::Fnv1a(&writeTime, sizeof(writeTime), contentHash);
+        }
+        setHash = String::Fnv1a(&flipTextures, sizeof(flipTextures), setHash);
+
+        stringstream fileName;
+        fileName
+            << hex << setfill('0')
+            << setw(16) << setHash << "_"
+            << setw(16) << contentHash << ".cubemap";
+
+        return Engine::docsPath + "\\skyboxCache\\" + fileName.str();
+    }
+
+    bool Skybox::LoadCookedCubemap(const string& cookedPath, vector<CubemapFace>& faces)
+    {
+        if (cookedPath == ""
+            || !exists(cookedPath))
+        {
+            return false;
+        }
+
+        ifstream cookedFile(cookedPath, ios::binary);
+
+        CookedCubemapHeader header{};
+        cookedFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+        bool isValid = cookedFile
+            && header.magic == cookedCubemapMagic
+            && header.version == cookedCubemapVersion
+            && header.faceCount == faces.size();
+
+        for (size_t i = 0; isValid && i < faces.size(); i++)
+        {
+            CookedFaceHeader faceHeader{};
+            cookedFile.read(reinterpret_cast<char*>(&faceHeader), sizeof(faceHeader));
+            if (!cookedFile
+                || faceHeader.width <= 0
+                || faceHeader.height <= 0
+                || faceHeader.width > maxCookedFaceSize
+                || faceHeader.height > maxCookedFaceSize
+                || faceHeader.channels <= 0
+                || faceHeader.channels > 4)
+            {
+                isValid = false;
+                break;
+            }
+
+            CubemapFace& face = faces[i];
+            face.width = faceHeader.width;
+            face.height = faceHeader.height;
+            face.channels = faceHeader.channels;
+            face.pixels.resize(static_cast<size_t>(face.width) * face.height * face.channels);
+            cookedFile.read(reinterpret_cast<char*>(face.pixels.data()), face.pixels.size());
+            if (static_cast<size_t>(cookedFile.gcount()) != face.pixels.size()) isValid = false;
+        }
+        cookedFile.close();
+
+        if (!isValid)
+        {
+            for (CubemapFace& face : faces)
+            {
+                face = CubemapFace{};
+            }
+
+            error_code ec;
+            remove(cookedPath, ec);
+
+            ConsoleManager::WriteConsoleMessage(
+                Caller::FILE,
+                Type::DEBUG,
+                "Cooked cubemap '" + path(cookedPath).filename().string() + "' is invalid, decoding the face images.\n");
+        }
+
+        return isValid;
+    }
+
+    void Skybox::SaveCookedCubemap(const string& cookedPath, const vector<CubemapFace>& faces)
+    {
+        if (cookedPath == "") return;
+
+        error_code ec;
+        create_directories(path(cookedPath).parent_path(), ec);
+
+        bool isSaved = File::WriteAtomically(cookedPath, [&faces](ofstream& cookedFile)
+            {
+                CookedCubemapHeader header{};
+                header.magic = cookedCubemapMagic;
+                header.version = cookedCubemapVersion;
+                header.faceCount = static_cast<uint32_t>(faces.size());
+                cookedFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+                for (const CubemapFace& face : faces)
+                {
+                    CookedFaceHeader faceHeader{ face.width, face.height, face.channels };
+                    cookedFile.write(reinterpret_cast<const char*>(&faceHeader), sizeof(faceHeader));
+                    cookedFile.write(reinterpret_cast<const char*>(face.pixels.data()), face.pixels.size());
+                }
+            });
+        if (!isSaved) return;
+
+        //every edit of a face image cooks a new file, the older ones of the same face set are never read again
+        string fileName = path(cookedPath).filename().string();
+        string setPrefix = fileName.substr(0, fileName.find('_') + 1);
+        for (const auto& entry : directory_iterator(path(cookedPath).parent_path(), ec))
+        {
+            string entryName = entry.path().filename().string();
+            if (entryName != fileName
+                && entryName.compare(0, setPrefix.size(), setPrefix) == 0)
+            {
+                remove(entry.path(), ec);
+            }
+        }
+    }
+
 	void Skybox::RenderSkybox(
         const shared_ptr<GameObject>&obj,
-        mat4& view,
+        const mat4& view,
         const mat4& projection)
 	{
+        if (skyboxTexture == 0) return;
+
+        //the vertex shader puts every skybox fragment at depth 1, equal to the cleared depth,
+        //so only pixels that no opaque object has written pass the test
         glDepthFunc(GL_LEQUAL);
 
         glDepthMask(GL_FALSE);
 
         Shader skyboxShader = obj->GetMaterial()->GetShader();
         skyboxShader.Use();
-        view = mat4(mat3(Render::camera.GetViewMatrix()));
-        skyboxShader.SetMat4("view", view);
+        //rotation only, the skybox stays centered on the camera
+        skyboxShader.SetMat4("view", mat4(mat3(view)));
         skyboxShader.SetMat4("projection", projection);
 
         glBindVertexArray(obj->GetMesh()->GetVAO());
@@ -214,4 +467,4 @@ namespace Graphics::Shape
 
         glDepthFunc(GL_LESS);
 	}
-}
\ No newline at end of file
+}
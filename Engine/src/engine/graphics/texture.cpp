@@ -17,6 +17,7 @@
 #include "console.hpp"
 #include "core.hpp"
 #include "fileUtils.hpp"
+#include "billboard.hpp"
 
 using std::cout;
 using std::endl;
@@ -32,6 +33,7 @@ using Type = Core::ConsoleManager::Type;
 using Core::Engine;
 using Utils::File;
 using Graphics::Shape::Mesh;
+using Graphics::Shape::Billboard;
 
 namespace Graphics
 {
@@ -168,6 +170,8 @@ namespace Graphics
 			glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 			glGenerateMipmap(GL_TEXTURE_2D);
 
+			if (nrComponents == 4) texturesWithAlpha.insert(texture);
+
 			string textureName = path(texturePath).filename().string();
 
 			if (textureName.find("diff_default.png") == string::npos
@@ -205,4 +209,16 @@ namespace Graphics
 		}
 		stbi_image_free(data);
 	}
-}
\ No newline at end of file
+
+	void Texture::DeleteTexture(unsigned int texture)
+	{
+		for (auto it = textures.begin(); it != textures.end();)
+		{
+			if (it->second == texture) it = textures.erase(it);
+			else ++it;
+		}
+		texturesWithAlpha.erase(texture);
+		Billboard::ReleaseAtlasRect(texture);
+		glDeleteTextures(1, &texture);
+	}
+}
@@ -5,11 +5,23 @@
 
 //engine
 #include "core.hpp"
+#include "headless.hpp"
+#include "sceneGenerator.hpp"
 
 using Core::Engine;
+using Core::Headless;
+using EngineFile::SceneGenerator;
 
-int main()
+int main(int argc, char* argv[])
 {
+	//generating a stress test scene doesnt need a window, so it runs before the engine starts
+	SceneGenerator::Settings generatorSettings{};
+	if (SceneGenerator::ParseArguments(argc, argv, generatorSettings))
+	{
+		return SceneGenerator::Generate(generatorSettings) ? 0 : 1;
+	}
+
+	Headless::ParseArguments(argc, argv);
 	Engine::InitializeEngine();
 	Engine::RunEngine();
 }
\ No newline at end of file
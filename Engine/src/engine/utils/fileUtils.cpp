@@ -8,6 +8,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <fstream>
 
 //engine
 #include "fileUtils.hpp"
@@ -15,6 +16,9 @@
 #include "core.hpp"
 #include "stringUtils.hpp"
 #include "gameobject.hpp"
+#if ENGINE_MODE
+#include "projectDirectory.hpp"
+#endif
 
 using std::exception;
 using std::runtime_error;
@@ -33,6 +37,10 @@ using std::filesystem::rename;
 using std::filesystem::recursive_directory_iterator;
 using std::filesystem::directory_iterator;
 using std::to_string;
+using std::ifstream;
+using std::ios;
+using std::streamsize;
+using std::error_code;
 
 using Core::ConsoleManager;
 using Caller = Core::ConsoleManager::Caller;
@@ -40,6 +48,9 @@ using Type = Core::ConsoleManager::Type;
 using Core::Engine;
 using Utils::String;
 using Graphics::Shape::GameObjectManager;
+#if ENGINE_MODE
+using EngineFile::ProjectDirectory;
+#endif
 
 namespace Utils
 {
@@ -136,6 +147,10 @@ namespace Utils
 
     void File::MoveOrRenameFileOrFolder(const path& sourcePath, const path& destinationPath, const bool isRenaming)
     {
+#if ENGINE_MODE
+        //project panels read from the cached project tree, refresh it on the next frame
+        ProjectDirectory::MarkDirty();
+#endif
         string output;
 
         if (!exists(sourcePath))
@@ -180,6 +195,9 @@ namespace Utils
 
     void File::CopyFileOrFolder(const path& sourcePath, const path& destinationPath)
     {
+#if ENGINE_MODE
+        ProjectDirectory::MarkDirty();
+#endif
         string output;
 
         if (!exists(sourcePath))
@@ -226,6 +244,9 @@ namespace Utils
 
     void File::DeleteFileOrfolder(const path& sourcePath)
     {
+#if ENGINE_MODE
+        ProjectDirectory::MarkDirty();
+#endif
         string output;
         if (!exists(sourcePath))
         {
@@ -262,6 +283,9 @@ namespace Utils
 
     void File::CreateNewFolder(const path& folderPath)
     {
+#if ENGINE_MODE
+        ProjectDirectory::MarkDirty();
+#endif
         string output;
         if (exists(folderPath))
         {
@@ -423,4 +447,45 @@ namespace Utils
 
         return "";
     }
-}
\ No newline at end of file
+
+    bool File::HashContents(const string& filePath, uint64_t& outHash)
+    {
+        ifstream file(filePath, ios::binary);
+        if (!file.is_open()) return false;
+
+        outHash = String::fnvOffsetBasis;
+        char buffer[4096];
+        while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+        {
+            outHash = String::Fnv1a(buffer, static_cast<size_t>(file.gcount()), outHash);
+        }
+
+        return true;
+    }
+
+    bool File::WriteAtomically(const string& filePath, const function<void(ofstream&)>& write)
+    {
+        error_code ec;
+        string tempPath = filePath + ".tmp";
+
+        ofstream file(tempPath, ios::binary | ios::trunc);
+        if (!file.is_open()) return false;
+
+        write(file);
+        file.close();
+        if (file.fail())
+        {
+            remove(tempPath, ec);
+            return false;
+        }
+
+        rename(tempPath, filePath, ec);
+        if (ec)
+        {
+            remove(tempPath, ec);
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -151,4 +151,15 @@ namespace Utils
 			|| (c >= 'A' && c <= 'Z') 
 			|| (c >= 'a' && c <= 'z');
 	}
+
+	uint64_t String::Fnv1a(const void* data, size_t size, uint64_t hash)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 //engine
 #include "core.hpp"
+#include "simulation.hpp"
 
 //game
 #include "gameLoop.hpp"
@@ -14,6 +15,7 @@
 using std::cout;
 
 using Core::Engine;
+using Core::Simulation;
 
 namespace Core
 {
@@ -30,4 +32,20 @@ namespace Core
 
 		Engine::RunEngine();
 	}
+
+	void Game::AddFixedUpdate(const function<void(double)>& callback)
+	{
+		Simulation::AddFixedUpdate(callback);
+	}
+
+	void Game::AddUpdate(const function<void(double)>& callback)
+	{
+		Simulation::AddUpdate(callback);
+	}
+
+	void Game::SetFixedTimestep(double seconds, int maxStepsPerFrame)
+	{
+		if (seconds > 0.0) Simulation::fixedDeltaTime = seconds;
+		if (maxStepsPerFrame > 0) Simulation::maxStepsPerFrame = maxStepsPerFrame;
+	}
 }
\ No newline at end of file
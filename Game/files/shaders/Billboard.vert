@@ -0,0 +1,31 @@
+//Copyright (c) <2024> <Lost Empire Entertainment>
+
+#version 330 core
+//one instance per billboard, the quad corners come from the vertex id
+layout (location = 0) in vec3 aCenter;
+layout (location = 1) in vec3 aScale;
+layout (location = 2) in vec4 aAtlasRect;
+
+out vec2 TexCoords;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 cameraPos;
+
+void main()
+{
+    //triangle strip corners, 0..1 on both axes
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+    //face the camera position, same basis as an inverted lookAt from the billboard to the camera
+    vec3 forward = normalize(cameraPos - aCenter);
+    vec3 right = normalize(cross(forward, vec3(0.0, 1.0, 0.0)));
+    vec3 up = cross(right, forward);
+
+    //the quad is half a unit wide and sits a quarter unit in front of its center
+    vec2 offset = (corner - 0.5) * 0.5 * aScale.xy;
+    vec3 worldPos = aCenter + right * offset.x + up * offset.y + forward * (0.25 * aScale.z);
+
+    TexCoords = aAtlasRect.xy + corner * aAtlasRect.zw;
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
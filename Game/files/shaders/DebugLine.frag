@@ -0,0 +1,12 @@
+//Copyright (c) <2024> <Lost Empire Entertainment>
+
+#version 330 core
+
+in vec4 lineColor;
+
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = lineColor;
+}
@@ -1,6 +1,19 @@
 //Copyright (c) <2024> <Lost Empire Entertainment>
 
 #version 330 core
+
+//the engine compiles one variant of this shader per combination of these defines,
+//see Shader::LoadPermutation, so unused features cost no instructions or uniforms
+#ifndef POINT_LIGHT_COUNT
+#define POINT_LIGHT_COUNT 0
+#endif
+#ifndef SPOT_LIGHT_COUNT
+#define SPOT_LIGHT_COUNT 0
+#endif
+//DIR_LIGHT     - the scene has an enabled directional light
+//SPECULAR_MAP  - the material has a specular texture
+//ALPHA_TEST    - the diffuse texture has an alpha channel and cut out pixels are discarded
+
 out vec4 FragColor;
 
 struct Material 
@@ -18,8 +31,6 @@ struct DirLight
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
-
-    bool enabled;
 };
 struct PointLight
 {
@@ -34,8 +45,6 @@ struct PointLight
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
-
-    bool enabled;
 };
 struct SpotLight
 {
@@ -53,132 +62,109 @@ struct SpotLight
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
-
-    bool enabled;
 };
 
-#define MAX_POINT_LIGHTS 16
-uniform int pointLightCount;
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-
-#define MAX_SPOT_LIGHTS 16
-uniform int spotLightCount;
-uniform SpotLight spotLights[MAX_SPOT_LIGHTS];
-
-#define MAX_DIR_LIGHTS 1
-uniform int dirLightCount;
-uniform DirLight dirLights[MAX_DIR_LIGHTS];
+#if POINT_LIGHT_COUNT > 0
+uniform PointLight pointLights[POINT_LIGHT_COUNT];
+#endif
+#if SPOT_LIGHT_COUNT > 0
+uniform SpotLight spotLights[SPOT_LIGHT_COUNT];
+#endif
+#ifdef DIR_LIGHT
+uniform DirLight dirLight;
+#endif
 
 in vec3 FragPos;  
 in vec3 Normal;  
 in vec2 TexCoords;
   
 uniform vec3 viewPos;
-uniform DirLight dirLight;
-uniform SpotLight spotLight;
 uniform Material material;
 
-float GetAlpha(sampler2D tex, vec2 coords);
+//sampled once per fragment instead of once per light
+vec3 diffuseColor;
+vec3 specularColor;
+
+vec3 CalcLight(vec3 lightDir, vec3 ambientLight, vec3 diffuseLight, vec3 specularLight, vec3 normal, vec3 viewDir);
 vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
 vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
 
 void main()
 {
+    vec4 diffuseSample = texture(material.diffuse, TexCoords);
+
+#ifdef ALPHA_TEST
+    float alpha = diffuseSample.a;
+    if (alpha < 0.1) discard;
+#else
+    float alpha = 1.0;
+#endif
+
+    diffuseColor = diffuseSample.rgb;
+#ifdef SPECULAR_MAP
+    specularColor = texture(material.specular, TexCoords).rgb;
+#else
+    specularColor = vec3(0.0);
+#endif
+
     //properties
     vec3 norm = normalize(Normal);
     vec3 viewDir = normalize(viewPos - FragPos);
 
     vec3 result = vec3(0.0);
-    if (dirLightCount > 0)
-    {   
-        if (dirLight.enabled)
-        {
-            result += CalcDirLight(dirLight, norm, viewDir);
-        }
-    }
-
-    if (pointLightCount > 0)
+#ifdef DIR_LIGHT
+    result += CalcDirLight(dirLight, norm, viewDir);
+#endif
+#if POINT_LIGHT_COUNT > 0
+    for (int i = 0; i < POINT_LIGHT_COUNT; i++)
     {
-        for (int i = 0; i < pointLightCount; i++)
-        {
-            if (pointLights[i].enabled)
-            {
-                result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
-            }
-        }
+        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
     }
-    if (spotLightCount > 0)
+#endif
+#if SPOT_LIGHT_COUNT > 0
+    for (int i = 0; i < SPOT_LIGHT_COUNT; i++)
     {
-        for (int i = 0; i < spotLightCount; i++)
-        {
-            if (spotLights[i].enabled)
-            {
-                result += CalcSpotLight(spotLights[i], norm, FragPos, viewDir);
-            }
-        }
+        result += CalcSpotLight(spotLights[i], norm, FragPos, viewDir);
     }
-
-    float alpha = GetAlpha(material.diffuse, TexCoords);
-
-    if (alpha < 0.1) discard;
+#endif
 
     FragColor = vec4(result, alpha);
 }
 
-float GetAlpha(sampler2D tex, vec2 coords)
-{
-    return texture(tex, coords).a;
-}
-
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+vec3 CalcLight(vec3 lightDir, vec3 ambientLight, vec3 diffuseLight, vec3 specularLight, vec3 normal, vec3 viewDir)
 {
-    vec3 lightDir = normalize(-light.direction);
     //diffuse shading
     float diff = max(dot(normal, lightDir), 0.0);
+    vec3 result = ambientLight * diffuseColor + diffuseLight * diff * diffuseColor;
+#ifdef SPECULAR_MAP
     //specular shading
     vec3 reflectDir = reflect(-lightDir, normal);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    //combine results
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
-    ambient *= light.intensity;
-    diffuse *= light.intensity;
-    specular *= light.intensity;
-    return (ambient + diffuse + specular);
+    result += specularLight * spec * specularColor;
+#endif
+    return result;
+}
+
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+{
+    vec3 lightDir = normalize(-light.direction);
+    return CalcLight(lightDir, light.ambient, light.diffuse, light.specular, normal, viewDir) * light.intensity;
 }
 
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
     vec3 lightDir = normalize(light.position - fragPos);
-    //diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    //specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
     //attenuation
     float distance = length(light.position - fragPos);
     distance /= light.distance;
     float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
-    //combine results
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
-    ambient *= attenuation * light.intensity;
-    diffuse *= attenuation * light.intensity;
-    specular *= attenuation * light.intensity;
-    return (ambient + diffuse + specular);
+    return CalcLight(lightDir, light.ambient, light.diffuse, light.specular, normal, viewDir) * (attenuation * light.intensity);
 }
 
 vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
     vec3 lightDir = normalize(light.position - fragPos);
-    //diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    //specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
     //attenuation
     float distance = length(light.position - fragPos);
     distance /= light.distance;
@@ -188,12 +174,5 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
     float epsilon = light.cutOff - light.outerCutOff;
     float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
     intensity *= light.intensity;
-    //combine results
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
-    ambient *= attenuation * intensity;
-    diffuse *= attenuation * intensity;
-    specular *= attenuation * intensity;
-    return (ambient + diffuse + specular);
-}
\ No newline at end of file
+    return CalcLight(lightDir, light.ambient, light.diffuse, light.specular, normal, viewDir) * (attenuation * intensity);
+}
@@ -13,6 +13,9 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+//the depth pre-pass reuses this shader, both passes must produce bit identical depth for GL_EQUAL
+invariant gl_Position;
+
 void main()
 {
     FragPos = vec3(model * vec4(aPos, 1.0));
@@ -12,5 +12,14 @@ namespace GameCore
 	public:
 		static void InitializeGame();
 		static void RunGame();
+
+		/// <summary>
+		/// Gameplay logic, runs at Game::SetFixedTimestep rate regardless of the framerate.
+		/// </summary>
+		static void FixedUpdate(double fixedDeltaTime);
+		/// <summary>
+		/// Per frame logic, runs once before every rendered frame.
+		/// </summary>
+		static void Update(double deltaTime);
 	};
 }
\ No newline at end of file
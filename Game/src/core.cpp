@@ -25,10 +25,23 @@ namespace GameCore
 		string version = "0.1";
 		Game::Initialize(version);
 		GUI::AddWindowsToList();
+
+		Game::SetFixedTimestep(1.0 / 60.0);
+		Game::AddFixedUpdate(FixedUpdate);
+		Game::AddUpdate(Update);
 	}
 
 	void GameTemplate::RunGame()
 	{
 		Game::Run();
 	}
+
+	void GameTemplate::FixedUpdate(double /*fixedDeltaTime*/)
+	{
+		//move gameobjects here, their rendered transforms are interpolated between steps
+	}
+
+	void GameTemplate::Update(double /*deltaTime*/)
+	{
+	}
 }
\ No newline at end of file
@@ -5,10 +5,15 @@
 
 #include "core.hpp"
 
+//engine
+#include "headless.hpp"
+
 using GameCore::GameTemplate;
+using Core::Headless;
 
-int main()
+int main(int argc, char* argv[])
 {
+	Headless::ParseArguments(argc, argv);
 	GameTemplate::InitializeGame();
 	GameTemplate::RunGame();
 	return 0;